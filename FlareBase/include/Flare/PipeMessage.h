@@ -18,7 +18,16 @@ namespace FlareBase
         PipeMessageType_UnlockFrame,
         PipeMessageType_PushFrame,
         PipeMessageType_Message,
-        PipeMessageType_EndStream
+        PipeMessageType_EndStream,
+        // Anything new goes after EndStream so the older messages keep the same values for the editor
+        PipeMessageType_ProfileCounter,
+        // Sent by the editor with e_PipeCapability flags for what it can handle, anything newer than the original messages only gets sent once it has been asked for
+        PipeMessageType_Capabilities
+    };
+
+    enum e_PipeCapability : uint32_t
+    {
+        PipeCapability_ProfileCounter = 0
     };
 
     struct PipeMessage
@@ -13,7 +13,10 @@ namespace FlareBase
         ShaderBufferType_PointLightBuffer = 3,
         ShaderBufferType_SpotLightBuffer = 4,
         ShaderBufferType_Texture = 5,
-        ShaderBufferType_PushTexture = 6
+        ShaderBufferType_PushTexture = 6,
+        ShaderBufferType_InstanceBuffer = 7,
+        ShaderBufferType_PointLightClusterBuffer = 8,
+        ShaderBufferType_SpotLightClusterBuffer = 9
     };
     
     enum e_ShaderSlot : uint16_t
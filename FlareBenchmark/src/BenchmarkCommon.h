@@ -0,0 +1,104 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+// Roughly the same size as a transform so the numbers mean something
+struct BenchTransform
+{
+    uint32_t Parent;
+    float    Translation[3];
+    float    Rotation[4];
+    float    Scale[3];
+};
+
+// Whatever is derived from the work gets stored in here so the compiler cannot throw the loops away
+// Global as a local static volatile gets flagged as set but never used
+template<typename T>
+inline volatile T BenchSink = T();
+
+template<typename T>
+inline void KeepAlive(T a_value)
+{
+    BenchSink<T> = a_value;
+}
+
+// Doubles from 1 up to this so there is always a few steps even on small boxes
+inline uint32_t MaxBenchThreads()
+{
+    const uint32_t threads = std::thread::hardware_concurrency();
+    if (threads < 4)
+    {
+        return 4;
+    }
+
+    return threads;
+}
+
+// Runs the function on every thread at once and gives back the wall time in nanoseconds per op, ops being what each thread does
+// The function returns something derived from the work so the compiler cannot throw the loops away
+template<typename TFunc>
+double TimeThreads(uint32_t a_threadCount, uint32_t a_opCount, const TFunc& a_func)
+{
+    std::atomic<bool> start = false;
+
+    std::vector<std::thread> threads;
+    std::vector<uint64_t> sums = std::vector<uint64_t>(a_threadCount);
+    for (uint32_t i = 0; i < a_threadCount; ++i)
+    {
+        threads.emplace_back([&, i]()
+        {
+            while (!start) { }
+
+            sums[i] = a_func(i);
+        });
+    }
+
+    const std::chrono::high_resolution_clock::time_point startTime = std::chrono::high_resolution_clock::now();
+    start = true;
+
+    for (std::thread& t : threads)
+    {
+        t.join();
+    }
+
+    const std::chrono::high_resolution_clock::time_point endTime = std::chrono::high_resolution_clock::now();
+
+    uint64_t sum = 0;
+    for (uint64_t s : sums)
+    {
+        sum += s;
+    }
+    // Keeps the sum alive without printing anything into the results
+    KeepAlive(sum);
+
+    return std::chrono::duration<double, std::nano>(endTime - startTime).count() / a_opCount;
+}
+
+// Same as TimeThreads but with a thread writing in the background the whole time
+template<typename TWrite, typename TFunc>
+double TimeThreadsWithWriter(uint32_t a_threadCount, uint32_t a_opCount, const TWrite& a_write, const TFunc& a_func)
+{
+    std::atomic<bool> stop = false;
+
+    std::thread writer = std::thread([&]()
+    {
+        uint32_t i = 0;
+        while (!stop)
+        {
+            a_write(i++);
+
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    });
+
+    const double time = TimeThreads(a_threadCount, a_opCount, a_func);
+
+    stop = true;
+    writer.join();
+
+    return time;
+}
@@ -0,0 +1,57 @@
+#include "BenchmarkReport.h"
+
+#include <string>
+#include <vector>
+
+struct BenchResult
+{
+    std::string Suite;
+    std::string Case;
+    uint32_t    Threads;
+    double      NsPerOp;
+};
+
+static std::vector<BenchResult> Results;
+
+void ReportResult(const std::string_view& a_suite, const std::string_view& a_case, uint32_t a_threads, double a_nsPerOp)
+{
+    Results.emplace_back(BenchResult{ std::string(a_suite), std::string(a_case), a_threads, a_nsPerOp });
+
+    // Something to look at while it runs as the whole thing takes a while
+    fprintf(stderr, "%-10s %-28s %3u threads %12.3f ns/op\n", Results.back().Suite.c_str(), Results.back().Case.c_str(), a_threads, a_nsPerOp);
+}
+
+void WriteResults(FILE* a_file, e_ReportFormat a_format)
+{
+    switch (a_format)
+    {
+    case ReportFormat_JSON:
+    {
+        // Names are all fixed strings in the benchmarks so nothing needs escaping
+        fprintf(a_file, "[\n");
+
+        const size_t count = Results.size();
+        for (size_t i = 0; i < count; ++i)
+        {
+            const BenchResult& result = Results[i];
+
+            fprintf(a_file, "    { \"suite\": \"%s\", \"case\": \"%s\", \"threads\": %u, \"ns_per_op\": %f }%s\n", result.Suite.c_str(), result.Case.c_str(), result.Threads, result.NsPerOp, i + 1 < count ? "," : "");
+        }
+
+        fprintf(a_file, "]\n");
+
+        break;
+    }
+    case ReportFormat_CSV:
+    default:
+    {
+        fprintf(a_file, "suite,case,threads,ns_per_op\n");
+        for (const BenchResult& result : Results)
+        {
+            fprintf(a_file, "%s,%s,%u,%f\n", result.Suite.c_str(), result.Case.c_str(), result.Threads, result.NsPerOp);
+        }
+
+        break;
+    }
+    }
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string_view>
+
+enum e_ReportFormat
+{
+    ReportFormat_CSV,
+    ReportFormat_JSON
+};
+
+// Collects every result so they can be written out in one go at the end
+// Suite is the container being measured, case is what was done to it
+void ReportResult(const std::string_view& a_suite, const std::string_view& a_case, uint32_t a_threads, double a_nsPerOp);
+void WriteResults(FILE* a_file, e_ReportFormat a_format);
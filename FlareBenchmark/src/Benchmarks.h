@@ -0,0 +1,7 @@
+#pragma once
+
+void SnapshotContentionBenchmark();
+void TArrayBenchmark();
+void TStaticBenchmark();
+void TransformKernelBenchmark();
+void TUMapBenchmark();
@@ -0,0 +1,116 @@
+#include <cstdio>
+#include <string_view>
+
+#include "BenchmarkReport.h"
+#include "Benchmarks.h"
+
+struct BenchmarkEntry
+{
+    const char* Name;
+    void (*Func)();
+};
+
+static constexpr BenchmarkEntry Entries[] =
+{
+    { "tarray", TArrayBenchmark },
+    { "snapshot", SnapshotContentionBenchmark },
+    { "tstatic", TStaticBenchmark },
+    { "tumap", TUMapBenchmark },
+    { "transform", TransformKernelBenchmark }
+};
+
+static void PrintUsage()
+{
+    printf("FlareBenchmark [--json] [--out <file>] [benchmarks...]\n");
+    printf("Results go to stdout as CSV unless told otherwise, progress goes to stderr\n");
+    printf("Benchmarks:");
+    for (const BenchmarkEntry& entry : Entries)
+    {
+        printf(" %s", entry.Name);
+    }
+    printf("\n");
+}
+
+int main(int a_argc, char** a_argv)
+{
+    e_ReportFormat format = ReportFormat_CSV;
+    const char* outPath = nullptr;
+
+    bool run[sizeof(Entries) / sizeof(*Entries)] = { };
+    bool filtered = false;
+
+    for (int i = 1; i < a_argc; ++i)
+    {
+        const std::string_view arg = a_argv[i];
+
+        if (arg == "--json")
+        {
+            format = ReportFormat_JSON;
+        }
+        else if (arg == "--csv")
+        {
+            format = ReportFormat_CSV;
+        }
+        else if (arg == "--out" && i + 1 < a_argc)
+        {
+            outPath = a_argv[++i];
+        }
+        else if (arg == "--help" || arg == "-h")
+        {
+            PrintUsage();
+
+            return 0;
+        }
+        else
+        {
+            bool found = false;
+            for (size_t j = 0; j < sizeof(Entries) / sizeof(*Entries); ++j)
+            {
+                if (arg == Entries[j].Name)
+                {
+                    run[j] = true;
+                    found = true;
+                }
+            }
+
+            if (!found)
+            {
+                fprintf(stderr, "Unknown argument: %s\n", a_argv[i]);
+                PrintUsage();
+
+                return 1;
+            }
+
+            filtered = true;
+        }
+    }
+
+    for (size_t i = 0; i < sizeof(Entries) / sizeof(*Entries); ++i)
+    {
+        if (!filtered || run[i])
+        {
+            Entries[i].Func();
+        }
+    }
+
+    FILE* file = stdout;
+    if (outPath != nullptr)
+    {
+        file = fopen(outPath, "w");
+        if (file == nullptr)
+        {
+            fprintf(stderr, "Failed to open: %s\n", outPath);
+
+            return 1;
+        }
+    }
+
+    WriteResults(file, format);
+
+    if (file != stdout)
+    {
+        fclose(file);
+    }
+
+    return 0;
+}
@@ -0,0 +1,74 @@
+#include <cstdint>
+
+#include "BenchmarkCommon.h"
+#include "BenchmarkReport.h"
+#include "Benchmarks.h"
+#include "DataTypes/TArray.h"
+
+static constexpr uint32_t ElementCount = 4096;
+static constexpr uint32_t LookupCount = 1 << 22;
+
+// Something has to be writing otherwise the snapshot never gets rebuilt and it is not a fair fight
+static void WriteTransform(TArray<BenchTransform>* a_array, uint32_t a_index)
+{
+    BenchTransform t = { };
+    t.Parent = -1;
+    a_array->LockSet(a_index % ElementCount, t);
+}
+
+struct LockedLookup
+{
+    TArray<BenchTransform>* Array;
+
+    uint64_t operator ()(uint32_t a_thread) const
+    {
+        uint64_t sum = 0;
+        for (uint32_t i = 0; i < LookupCount; ++i)
+        {
+            sum += (*Array)[(i + a_thread) % ElementCount].Parent;
+        }
+
+        return sum;
+    }
+};
+struct SnapshotLookup
+{
+    TArray<BenchTransform>* Array;
+
+    uint64_t operator ()(uint32_t a_thread) const
+    {
+        // Same as the render thread, grab it once and index it for the rest of the frame
+        const TSnapshot<BenchTransform> snapshot = Array->Snapshot();
+
+        uint64_t sum = 0;
+        for (uint32_t i = 0; i < LookupCount; ++i)
+        {
+            sum += snapshot[(i + a_thread) % ElementCount].Parent;
+        }
+
+        return sum;
+    }
+};
+
+void SnapshotContentionBenchmark()
+{
+    TArray<BenchTransform> array;
+    for (uint32_t i = 0; i < ElementCount; ++i)
+    {
+        BenchTransform t = { };
+        t.Parent = i;
+        array.Push(t);
+    }
+
+    const auto write = [&](uint32_t a_index)
+    {
+        WriteTransform(&array, a_index);
+    };
+
+    const uint32_t maxThreads = MaxBenchThreads();
+    for (uint32_t threads = 1; threads <= maxThreads; threads *= 2)
+    {
+        ReportResult("TArray", "locked_lookup", threads, TimeThreadsWithWriter(threads, LookupCount, write, LockedLookup { &array }));
+        ReportResult("TArray", "snapshot_lookup", threads, TimeThreadsWithWriter(threads, LookupCount, write, SnapshotLookup { &array }));
+    }
+}
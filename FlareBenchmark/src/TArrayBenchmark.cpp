@@ -0,0 +1,214 @@
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+#include <vector>
+
+#include "BenchmarkCommon.h"
+#include "BenchmarkReport.h"
+#include "Benchmarks.h"
+#include "DataTypes/TArray.h"
+#include "DataTypes/TLockArray.h"
+
+static constexpr uint32_t ElementCount = 4096;
+static constexpr uint32_t RepeatCount = 256;
+static constexpr uint32_t IndexCount = 1 << 24;
+static constexpr uint32_t BatchSize = 64;
+static constexpr uint32_t BatchCount = 1 << 16;
+
+static BenchTransform MakeTransform(uint32_t a_parent)
+{
+    BenchTransform t = { };
+    t.Parent = a_parent;
+
+    return t;
+}
+
+static void FillArray(TArray<BenchTransform>* a_array)
+{
+    for (uint32_t i = 0; i < ElementCount; ++i)
+    {
+        a_array->Push(MakeTransform(i));
+    }
+}
+
+static double PushBenchmark()
+{
+    return TimeThreads(1, ElementCount * RepeatCount, [](uint32_t) -> uint64_t
+    {
+        uint64_t sum = 0;
+        for (uint32_t r = 0; r < RepeatCount; ++r)
+        {
+            // Fresh array each time so growth is part of the cost
+            TArray<BenchTransform> array;
+            for (uint32_t i = 0; i < ElementCount; ++i)
+            {
+                sum += array.Push(MakeTransform(i));
+            }
+        }
+
+        return sum;
+    });
+}
+static double VectorPushBenchmark()
+{
+    return TimeThreads(1, ElementCount * RepeatCount, [](uint32_t) -> uint64_t
+    {
+        uint64_t sum = 0;
+        for (uint32_t r = 0; r < RepeatCount; ++r)
+        {
+            std::vector<BenchTransform> vec;
+            for (uint32_t i = 0; i < ElementCount; ++i)
+            {
+                vec.push_back(MakeTransform(i));
+                sum += vec.size();
+            }
+        }
+
+        return sum;
+    });
+}
+
+template<bool Swap>
+static double EraseBenchmark()
+{
+    // Small enough that the ordered erase does not dominate the whole run
+    constexpr uint32_t EraseElements = 1024;
+    constexpr uint32_t EraseRepeats = 64;
+
+    return TimeThreads(1, EraseElements * EraseRepeats, [](uint32_t) -> uint64_t
+    {
+        uint64_t sum = 0;
+        TArray<BenchTransform> array;
+        for (uint32_t r = 0; r < EraseRepeats; ++r)
+        {
+            for (uint32_t i = 0; i < EraseElements; ++i)
+            {
+                array.Push(MakeTransform(i));
+            }
+
+            // Cheap LCG so the holes are spread around instead of always at the end
+            uint32_t seed = r;
+            while (!array.Empty())
+            {
+                seed = seed * 1664525 + 1013904223;
+                const uint32_t index = (seed >> 8) % array.Size();
+
+                if constexpr (Swap)
+                {
+                    sum += array.SwapErase(index);
+                }
+                else
+                {
+                    array.Erase(index);
+                    sum += index;
+                }
+            }
+        }
+
+        return sum;
+    });
+}
+
+static double LockedIndexBenchmark(uint32_t a_threadCount, TArray<BenchTransform>* a_array)
+{
+    return TimeThreads(a_threadCount, IndexCount, [&](uint32_t a_thread) -> uint64_t
+    {
+        uint64_t sum = 0;
+        for (uint32_t i = 0; i < IndexCount; ++i)
+        {
+            sum += (*a_array)[(i + a_thread) % ElementCount].Parent;
+        }
+
+        return sum;
+    });
+}
+static double DataIndexBenchmark(uint32_t a_threadCount, TArray<BenchTransform>* a_array)
+{
+    return TimeThreads(a_threadCount, IndexCount, [&](uint32_t a_thread) -> uint64_t
+    {
+        // Take the lock once and walk the raw data which is what the hot paths should be doing
+        const std::shared_lock g = std::shared_lock(a_array->Lock());
+
+        const BenchTransform* data = a_array->Data();
+
+        uint64_t sum = 0;
+        for (uint32_t i = 0; i < IndexCount; ++i)
+        {
+            sum += data[(i + a_thread) % ElementCount].Parent;
+        }
+
+        return sum;
+    });
+}
+
+static double LockArrayBenchmark(uint32_t a_threadCount, TArray<BenchTransform>* a_array)
+{
+    const auto write = [&](uint32_t a_index)
+    {
+        a_array->LockSet(a_index % ElementCount, MakeTransform(-1));
+    };
+
+    return TimeThreadsWithWriter(a_threadCount, BatchCount * BatchSize, write, [&](uint32_t a_thread) -> uint64_t
+    {
+        uint64_t sum = 0;
+        for (uint32_t b = 0; b < BatchCount; ++b)
+        {
+            // Exclusive so every reader lines up behind every other reader
+            TLockArray<BenchTransform> lockArray = a_array->ToLockArray();
+
+            const uint32_t start = ((b + a_thread) * BatchSize) % ElementCount;
+            for (uint32_t i = 0; i < BatchSize; ++i)
+            {
+                sum += lockArray[(start + i) % ElementCount].Parent;
+            }
+        }
+
+        return sum;
+    });
+}
+static double SharedBatchBenchmark(uint32_t a_threadCount, TArray<BenchTransform>* a_array)
+{
+    const auto write = [&](uint32_t a_index)
+    {
+        a_array->LockSet(a_index % ElementCount, MakeTransform(-1));
+    };
+
+    return TimeThreadsWithWriter(a_threadCount, BatchCount * BatchSize, write, [&](uint32_t a_thread) -> uint64_t
+    {
+        uint64_t sum = 0;
+        for (uint32_t b = 0; b < BatchCount; ++b)
+        {
+            const std::shared_lock g = std::shared_lock(a_array->Lock());
+
+            const BenchTransform* data = a_array->Data();
+
+            const uint32_t start = ((b + a_thread) * BatchSize) % ElementCount;
+            for (uint32_t i = 0; i < BatchSize; ++i)
+            {
+                sum += data[(start + i) % ElementCount].Parent;
+            }
+        }
+
+        return sum;
+    });
+}
+
+void TArrayBenchmark()
+{
+    ReportResult("TArray", "push", 1, PushBenchmark());
+    ReportResult("TArray", "std_vector_push", 1, VectorPushBenchmark());
+    ReportResult("TArray", "erase", 1, EraseBenchmark<false>());
+    ReportResult("TArray", "swap_erase", 1, EraseBenchmark<true>());
+
+    TArray<BenchTransform> array;
+    FillArray(&array);
+
+    const uint32_t maxThreads = MaxBenchThreads();
+    for (uint32_t threads = 1; threads <= maxThreads; threads *= 2)
+    {
+        ReportResult("TArray", "index_locked", threads, LockedIndexBenchmark(threads, &array));
+        ReportResult("TArray", "index_data", threads, DataIndexBenchmark(threads, &array));
+        ReportResult("TLockArray", "batch_read", threads, LockArrayBenchmark(threads, &array));
+        ReportResult("TLockArray", "shared_batch_read", threads, SharedBatchBenchmark(threads, &array));
+    }
+}
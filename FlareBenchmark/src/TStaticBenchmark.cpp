@@ -0,0 +1,139 @@
+#include <cstdint>
+#include <shared_mutex>
+#include <thread>
+#include <unordered_map>
+
+#include "BenchmarkCommon.h"
+#include "BenchmarkReport.h"
+#include "Benchmarks.h"
+#include "DataTypes/TStatic.h"
+
+// The old map based TStatic kept here so there is something to compare against
+template<typename T>
+class LegacyTStatic
+{
+private:
+    std::shared_mutex                       m_mutex;
+    std::unordered_map<std::thread::id, T*> m_data;
+
+public:
+    ~LegacyTStatic()
+    {
+        Clear();
+    }
+
+    inline T* operator->() 
+    {
+        const std::thread::id id = std::this_thread::get_id();
+
+        const std::shared_lock g = std::shared_lock(m_mutex);
+        return m_data[id];
+    }
+
+    T& Push(const T& a_data)
+    {
+        const std::thread::id id = std::this_thread::get_id();
+
+        T* d = new T(a_data);
+        
+        const std::unique_lock g = std::unique_lock(m_mutex);
+
+        auto iter = m_data.find(id);
+        if (iter != m_data.end())
+        {
+            delete iter->second;
+            iter->second = d;
+        }
+        else
+        {
+            m_data.emplace(id, d);
+        }
+
+        return *d;
+    }
+
+    void Clear()
+    {
+        const std::unique_lock g = std::unique_lock(m_mutex);
+
+        for (auto iter = m_data.begin(); iter != m_data.end(); ++iter)
+        {
+            delete iter->second;
+        }
+
+        m_data.clear();
+    }
+};
+
+// About the size of a render command
+struct BenchCommand
+{
+    void*    Engine;
+    void*    GraphicsEngine;
+    void*    Swapchain;
+    uint32_t BufferIndex;
+    uint32_t Flags;
+    uint32_t RenderTexture;
+    uint32_t Material;
+    void*    CommandBuffer;
+
+    BenchCommand(uint32_t a_index) :
+        Engine(nullptr),
+        GraphicsEngine(nullptr),
+        Swapchain(nullptr),
+        BufferIndex(a_index),
+        Flags(0),
+        RenderTexture(-1),
+        Material(-1),
+        CommandBuffer(nullptr) { }
+};
+
+static constexpr uint32_t LookupCount = 1 << 22;
+static constexpr uint32_t FrameCount = 1 << 14;
+
+template<typename TStorage>
+static double LookupBenchmark(uint32_t a_threadCount)
+{
+    TStorage storage;
+
+    return TimeThreads(a_threadCount, LookupCount, [&](uint32_t a_thread) -> uint64_t
+    {
+        storage.Push(BenchCommand(a_thread));
+
+        uint64_t sum = 0;
+        for (uint32_t i = 0; i < LookupCount; ++i)
+        {
+            sum += storage->BufferIndex;
+        }
+
+        return sum;
+    });
+}
+template<typename TStorage>
+static double PushBenchmark(uint32_t a_threadCount)
+{
+    TStorage storage;
+
+    return TimeThreads(a_threadCount, FrameCount, [&](uint32_t) -> uint64_t
+    {
+        uint64_t sum = 0;
+        for (uint32_t i = 0; i < FrameCount; ++i)
+        {
+            sum += storage.Push(BenchCommand(i)).BufferIndex;
+        }
+
+        return sum;
+    });
+}
+
+void TStaticBenchmark()
+{
+    const uint32_t maxThreads = MaxBenchThreads();
+    for (uint32_t threads = 1; threads <= maxThreads; threads *= 2)
+    {
+        ReportResult("TStatic", "legacy_lookup", threads, LookupBenchmark<LegacyTStatic<BenchCommand>>(threads));
+        ReportResult("TStatic", "lookup", threads, LookupBenchmark<TStatic<BenchCommand>>(threads));
+        ReportResult("TStatic", "legacy_push", threads, PushBenchmark<LegacyTStatic<BenchCommand>>(threads));
+        ReportResult("TStatic", "push", threads, PushBenchmark<TStatic<BenchCommand>>(threads));
+    }
+}
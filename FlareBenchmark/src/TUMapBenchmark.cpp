@@ -0,0 +1,173 @@
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "BenchmarkCommon.h"
+#include "BenchmarkReport.h"
+#include "Benchmarks.h"
+#include "DataTypes/TUMap.h"
+
+// What TUMap used to be, one lock around a std::unordered_map and a std::string key for every lookup
+class LegacyTUMap
+{
+private:
+    mutable std::shared_mutex                 m_mutex;
+    std::unordered_map<std::string, uint32_t> m_data;
+
+public:
+    void Push(const std::string& a_key, uint32_t a_value)
+    {
+        const std::unique_lock g = std::unique_lock(m_mutex);
+
+        m_data[a_key] = a_value;
+    }
+
+    bool TryGet(const std::string& a_key, uint32_t* a_value) const
+    {
+        const std::shared_lock g = std::shared_lock(m_mutex);
+
+        const auto iter = m_data.find(a_key);
+        if (iter == m_data.end())
+        {
+            return false;
+        }
+
+        *a_value = iter->second;
+
+        return true;
+    }
+};
+
+static constexpr uint32_t KeyCount = 4096;
+static constexpr uint32_t LookupCount = 1 << 21;
+static constexpr uint32_t InsertRepeats = 64;
+
+// Long enough to miss the small string buffer same as most of the Scribe keys
+static std::vector<std::string> MakeKeys()
+{
+    std::vector<std::string> keys;
+    keys.reserve(KeyCount);
+    for (uint32_t i = 0; i < KeyCount; ++i)
+    {
+        keys.emplace_back("FlareEngine.Scribe.Key_" + std::to_string(i));
+    }
+
+    return keys;
+}
+
+template<typename TMap>
+static void FillMap(TMap* a_map, const std::vector<std::string>& a_keys)
+{
+    for (uint32_t i = 0; i < KeyCount; ++i)
+    {
+        a_map->Push(a_keys[i], i);
+    }
+}
+
+static double InsertBenchmark(const std::vector<std::string>& a_keys)
+{
+    return TimeThreads(1, KeyCount * InsertRepeats, [&](uint32_t) -> uint64_t
+    {
+        uint64_t sum = 0;
+        for (uint32_t r = 0; r < InsertRepeats; ++r)
+        {
+            TUMap<std::string, uint32_t> map;
+            FillMap(&map, a_keys);
+
+            sum += map.Size();
+        }
+
+        return sum;
+    });
+}
+static double LegacyInsertBenchmark(const std::vector<std::string>& a_keys)
+{
+    return TimeThreads(1, KeyCount * InsertRepeats, [&](uint32_t) -> uint64_t
+    {
+        uint64_t sum = 0;
+        for (uint32_t r = 0; r < InsertRepeats; ++r)
+        {
+            LegacyTUMap map;
+            FillMap(&map, a_keys);
+
+            uint32_t value;
+            sum += map.TryGet(a_keys[r], &value);
+        }
+
+        return sum;
+    });
+}
+
+// Lookups come in as string_views as that is what the bindings hand over, the legacy map has to build a string for each one
+static double LookupBenchmark(uint32_t a_threadCount, TUMap<std::string, uint32_t>* a_map, const std::vector<std::string>& a_keys)
+{
+    const auto write = [&](uint32_t a_index)
+    {
+        a_map->Push(a_keys[a_index % KeyCount], a_index);
+    };
+
+    return TimeThreadsWithWriter(a_threadCount, LookupCount, write, [&](uint32_t a_thread) -> uint64_t
+    {
+        uint64_t sum = 0;
+        for (uint32_t i = 0; i < LookupCount; ++i)
+        {
+            const std::string_view key = a_keys[(i * 7 + a_thread) % KeyCount];
+
+            uint32_t value;
+            if (a_map->TryGet(key, &value))
+            {
+                sum += value;
+            }
+        }
+
+        return sum;
+    });
+}
+static double LegacyLookupBenchmark(uint32_t a_threadCount, LegacyTUMap* a_map, const std::vector<std::string>& a_keys)
+{
+    const auto write = [&](uint32_t a_index)
+    {
+        a_map->Push(a_keys[a_index % KeyCount], a_index);
+    };
+
+    return TimeThreadsWithWriter(a_threadCount, LookupCount, write, [&](uint32_t a_thread) -> uint64_t
+    {
+        uint64_t sum = 0;
+        for (uint32_t i = 0; i < LookupCount; ++i)
+        {
+            const std::string_view key = a_keys[(i * 7 + a_thread) % KeyCount];
+
+            uint32_t value;
+            if (a_map->TryGet(std::string(key), &value))
+            {
+                sum += value;
+            }
+        }
+
+        return sum;
+    });
+}
+
+void TUMapBenchmark()
+{
+    const std::vector<std::string> keys = MakeKeys();
+
+    ReportResult("TUMap", "legacy_insert", 1, LegacyInsertBenchmark(keys));
+    ReportResult("TUMap", "insert", 1, InsertBenchmark(keys));
+
+    LegacyTUMap legacyMap;
+    FillMap(&legacyMap, keys);
+    TUMap<std::string, uint32_t> map;
+    FillMap(&map, keys);
+
+    const uint32_t maxThreads = MaxBenchThreads();
+    for (uint32_t threads = 1; threads <= maxThreads; threads *= 2)
+    {
+        ReportResult("TUMap", "legacy_string_lookup", threads, LegacyLookupBenchmark(threads, &legacyMap, keys));
+        ReportResult("TUMap", "string_lookup", threads, LookupBenchmark(threads, &map, keys));
+    }
+}
@@ -0,0 +1,213 @@
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "BenchmarkCommon.h"
+#include "BenchmarkReport.h"
+#include "Benchmarks.h"
+#include "Maths/TransformKernel.h"
+
+#ifdef FLAREBENCHMARK_ENABLE_GLM
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <glm/gtx/quaternion.hpp>
+#endif
+
+static constexpr uint32_t TransformCounts[] = { 10000, 100000, 1000000 };
+// Keeps the total work about the same for each size so the small ones are not all noise
+static constexpr uint32_t TotalTransforms = 1 << 24;
+
+struct TransformInput
+{
+    std::vector<float> Translations;
+    std::vector<float> Rotations;
+    std::vector<float> Scales;
+    std::vector<float> Matrices;
+    std::vector<float> Inverses;
+};
+
+static TransformInput MakeInput(uint32_t a_count)
+{
+    TransformInput input;
+    input.Translations.resize(a_count * 3);
+    input.Rotations.resize(a_count * 4);
+    input.Scales.resize(a_count * 3);
+    input.Matrices.resize(a_count * 16);
+    input.Inverses.resize(a_count * 16);
+
+    // Cheap LCG, does not need to be good just not all the same
+    uint32_t seed = a_count;
+    const auto next = [&]() -> float
+    {
+        seed = seed * 1664525 + 1013904223;
+
+        return (float)(seed >> 8) / (float)(1 << 24);
+    };
+
+    for (uint32_t i = 0; i < a_count; ++i)
+    {
+        for (uint32_t j = 0; j < 3; ++j)
+        {
+            input.Translations[i * 3 + j] = next() * 100.0f - 50.0f;
+            input.Scales[i * 3 + j] = next() * 2.0f + 0.5f;
+        }
+
+        float len = 0.0f;
+        for (uint32_t j = 0; j < 4; ++j)
+        {
+            const float v = next() * 2.0f - 1.0f;
+            input.Rotations[i * 4 + j] = v;
+            len += v * v;
+        }
+
+        const float invLen = 1.0f / std::sqrt(len);
+        for (uint32_t j = 0; j < 4; ++j)
+        {
+            input.Rotations[i * 4 + j] *= invLen;
+        }
+    }
+
+    return input;
+}
+
+// What the engine did before, three full 4x4 products then a general inverse, written out without glm so it always builds
+static void Mul4(const float* a_lhs, const float* a_rhs, float* a_out)
+{
+    for (uint32_t c = 0; c < 4; ++c)
+    {
+        for (uint32_t r = 0; r < 4; ++r)
+        {
+            a_out[c * 4 + r] = a_lhs[0 * 4 + r] * a_rhs[c * 4 + 0] + a_lhs[1 * 4 + r] * a_rhs[c * 4 + 1] + a_lhs[2 * 4 + r] * a_rhs[c * 4 + 2] + a_lhs[3 * 4 + r] * a_rhs[c * 4 + 3];
+        }
+    }
+}
+static void Inverse4(const float* m, float* a_out)
+{
+    float inv[16];
+
+    inv[0] = m[5] * m[10] * m[15] - m[5] * m[11] * m[14] - m[9] * m[6] * m[15] + m[9] * m[7] * m[14] + m[13] * m[6] * m[11] - m[13] * m[7] * m[10];
+    inv[4] = -m[4] * m[10] * m[15] + m[4] * m[11] * m[14] + m[8] * m[6] * m[15] - m[8] * m[7] * m[14] - m[12] * m[6] * m[11] + m[12] * m[7] * m[10];
+    inv[8] = m[4] * m[9] * m[15] - m[4] * m[11] * m[13] - m[8] * m[5] * m[15] + m[8] * m[7] * m[13] + m[12] * m[5] * m[11] - m[12] * m[7] * m[9];
+    inv[12] = -m[4] * m[9] * m[14] + m[4] * m[10] * m[13] + m[8] * m[5] * m[14] - m[8] * m[6] * m[13] - m[12] * m[5] * m[10] + m[12] * m[6] * m[9];
+    inv[1] = -m[1] * m[10] * m[15] + m[1] * m[11] * m[14] + m[9] * m[2] * m[15] - m[9] * m[3] * m[14] - m[13] * m[2] * m[11] + m[13] * m[3] * m[10];
+    inv[5] = m[0] * m[10] * m[15] - m[0] * m[11] * m[14] - m[8] * m[2] * m[15] + m[8] * m[3] * m[14] + m[12] * m[2] * m[11] - m[12] * m[3] * m[10];
+    inv[9] = -m[0] * m[9] * m[15] + m[0] * m[11] * m[13] + m[8] * m[1] * m[15] - m[8] * m[3] * m[13] - m[12] * m[1] * m[11] + m[12] * m[3] * m[9];
+    inv[13] = m[0] * m[9] * m[14] - m[0] * m[10] * m[13] - m[8] * m[1] * m[14] + m[8] * m[2] * m[13] + m[12] * m[1] * m[10] - m[12] * m[2] * m[9];
+    inv[2] = m[1] * m[6] * m[15] - m[1] * m[7] * m[14] - m[5] * m[2] * m[15] + m[5] * m[3] * m[14] + m[13] * m[2] * m[7] - m[13] * m[3] * m[6];
+    inv[6] = -m[0] * m[6] * m[15] + m[0] * m[7] * m[14] + m[4] * m[2] * m[15] - m[4] * m[3] * m[14] - m[12] * m[2] * m[7] + m[12] * m[3] * m[6];
+    inv[10] = m[0] * m[5] * m[15] - m[0] * m[7] * m[13] - m[4] * m[1] * m[15] + m[4] * m[3] * m[13] + m[12] * m[1] * m[7] - m[12] * m[3] * m[5];
+    inv[14] = -m[0] * m[5] * m[14] + m[0] * m[6] * m[13] + m[4] * m[1] * m[14] - m[4] * m[2] * m[13] - m[12] * m[1] * m[6] + m[12] * m[2] * m[5];
+    inv[3] = -m[1] * m[6] * m[11] + m[1] * m[7] * m[10] + m[5] * m[2] * m[11] - m[5] * m[3] * m[10] - m[9] * m[2] * m[7] + m[9] * m[3] * m[6];
+    inv[7] = m[0] * m[6] * m[11] - m[0] * m[7] * m[10] - m[4] * m[2] * m[11] + m[4] * m[3] * m[10] + m[8] * m[2] * m[7] - m[8] * m[3] * m[6];
+    inv[11] = -m[0] * m[5] * m[11] + m[0] * m[7] * m[9] + m[4] * m[1] * m[11] - m[4] * m[3] * m[9] - m[8] * m[1] * m[7] + m[8] * m[3] * m[5];
+    inv[15] = m[0] * m[5] * m[10] - m[0] * m[6] * m[9] - m[4] * m[1] * m[10] + m[4] * m[2] * m[9] + m[8] * m[1] * m[6] - m[8] * m[2] * m[5];
+
+    const float invDet = 1.0f / (m[0] * inv[0] + m[1] * inv[4] + m[2] * inv[8] + m[3] * inv[12]);
+    for (uint32_t i = 0; i < 16; ++i)
+    {
+        a_out[i] = inv[i] * invDet;
+    }
+}
+static void ComposeReference(const float* a_translations, const float* a_rotations, const float* a_scales, uint32_t a_count, float* a_matrices, float* a_inverses)
+{
+    for (uint32_t i = 0; i < a_count; ++i)
+    {
+        const float* t = a_translations + i * 3;
+        const float* q = a_rotations + i * 4;
+        const float* s = a_scales + i * 3;
+
+        const float translation[16] = { 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, t[0], t[1], t[2], 1 };
+        const float scale[16] = { s[0], 0, 0, 0, 0, s[1], 0, 0, 0, 0, s[2], 0, 0, 0, 0, 1 };
+        const float rotation[16] =
+        {
+            1 - 2 * (q[1] * q[1] + q[2] * q[2]), 2 * (q[0] * q[1] + q[3] * q[2]), 2 * (q[0] * q[2] - q[3] * q[1]), 0,
+            2 * (q[0] * q[1] - q[3] * q[2]), 1 - 2 * (q[0] * q[0] + q[2] * q[2]), 2 * (q[1] * q[2] + q[3] * q[0]), 0,
+            2 * (q[0] * q[2] + q[3] * q[1]), 2 * (q[1] * q[2] - q[3] * q[0]), 1 - 2 * (q[0] * q[0] + q[1] * q[1]), 0,
+            0, 0, 0, 1
+        };
+
+        float tr[16];
+        Mul4(translation, rotation, tr);
+        Mul4(tr, scale, a_matrices + i * 16);
+
+        Inverse4(a_matrices + i * 16, a_inverses + i * 16);
+    }
+}
+
+#ifdef FLAREBENCHMARK_ENABLE_GLM
+// The actual old path through glm when it is around
+static void ComposeGLM(const float* a_translations, const float* a_rotations, const float* a_scales, uint32_t a_count, float* a_matrices, float* a_inverses)
+{
+    constexpr glm::mat4 Iden = glm::identity<glm::mat4>();
+
+    const glm::vec3* translations = (const glm::vec3*)a_translations;
+    const glm::quat* rotations = (const glm::quat*)a_rotations;
+    const glm::vec3* scales = (const glm::vec3*)a_scales;
+    glm::mat4* matrices = (glm::mat4*)a_matrices;
+    glm::mat4* inverses = (glm::mat4*)a_inverses;
+
+    for (uint32_t i = 0; i < a_count; ++i)
+    {
+        matrices[i] = glm::translate(Iden, translations[i]) * glm::toMat4(rotations[i]) * glm::scale(Iden, scales[i]);
+        inverses[i] = glm::inverse(matrices[i]);
+    }
+}
+#endif
+
+template<typename TFunc>
+static double TimeCompose(TransformInput* a_input, uint32_t a_count, const TFunc& a_func)
+{
+    const uint32_t repeats = TotalTransforms / a_count;
+
+    // Once first so the memory is paged in and the dispatch is picked before timing
+    a_func(a_input->Translations.data(), a_input->Rotations.data(), a_input->Scales.data(), a_count, a_input->Matrices.data(), a_input->Inverses.data());
+
+    const std::chrono::high_resolution_clock::time_point startTime = std::chrono::high_resolution_clock::now();
+
+    for (uint32_t i = 0; i < repeats; ++i)
+    {
+        a_func(a_input->Translations.data(), a_input->Rotations.data(), a_input->Scales.data(), a_count, a_input->Matrices.data(), a_input->Inverses.data());
+    }
+
+    const std::chrono::high_resolution_clock::time_point endTime = std::chrono::high_resolution_clock::now();
+
+    KeepAlive(a_input->Matrices[a_count * 16 - 4] + a_input->Inverses[a_count * 16 - 4]);
+
+    return std::chrono::duration<double, std::nano>(endTime - startTime).count() / ((double)repeats * a_count);
+}
+
+void TransformKernelBenchmark()
+{
+#ifndef FLAREBENCHMARK_ENABLE_GLM
+    fprintf(stderr, "glm not found, skipping the glm comparison\n");
+#endif
+
+    for (const uint32_t count : TransformCounts)
+    {
+        TransformInput input = MakeInput(count);
+
+        char name[64];
+        const auto report = [&](const char* a_case, double a_time)
+        {
+            snprintf(name, sizeof(name), "%s_%u", a_case, count);
+            ReportResult("TransformKernel", name, 1, a_time);
+        };
+
+        report("reference", TimeCompose(&input, count, ComposeReference));
+#ifdef FLAREBENCHMARK_ENABLE_GLM
+        report("glm", TimeCompose(&input, count, ComposeGLM));
+#endif
+        report("scalar", TimeCompose(&input, count, TransformKernel::ComposeTRSScalar));
+
+        if (TransformKernel::ComposeTRSSSE(input.Translations.data(), input.Rotations.data(), input.Scales.data(), 1, input.Matrices.data(), input.Inverses.data()))
+        {
+            report("sse", TimeCompose(&input, count, TransformKernel::ComposeTRSSSE));
+        }
+        if (TransformKernel::ComposeTRSAVX2(input.Translations.data(), input.Rotations.data(), input.Scales.data(), 1, input.Matrices.data(), input.Inverses.data()))
+        {
+            report("avx2", TimeCompose(&input, count, TransformKernel::ComposeTRSAVX2));
+        }
+    }
+}
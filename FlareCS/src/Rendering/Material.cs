@@ -32,7 +32,10 @@ namespace FlareEngine.Rendering
         PointLightBuffer = 3,
         SpotLightBuffer = 4,
         Texture = 5,
-        PushTexture = 6
+        PushTexture = 6,
+        InstanceBuffer = 7,
+        PointLightClusterBuffer = 8,
+        SpotLightClusterBuffer = 9
     };
 
     public enum ShaderSlot : ushort
@@ -1,11 +1,14 @@
 using FlareEngine.Definitions;
 using System;
+using System.Collections.Generic;
 using System.Runtime.CompilerServices;
 
 namespace FlareEngine.Rendering
 {
     public class MeshRenderer : Component, IDestroy
     {
+        static Dictionary<uint, MeshRenderer> BufferLookup = new Dictionary<uint, MeshRenderer>();
+
         bool     m_disposed = false;
 
         bool     m_visible = true;
@@ -106,6 +109,8 @@ namespace FlareEngine.Rendering
 
                 DestroyBuffer(m_bufferAddr);
 
+                BufferLookup.Remove(m_bufferAddr);
+
                 m_bufferAddr = uint.MaxValue;
             }
 
@@ -113,6 +118,8 @@ namespace FlareEngine.Rendering
             {
                 m_bufferAddr = GenerateBuffer(Transform.InternalAddr, m_material.InternalAddr, m_model.InternalAddr);
 
+                BufferLookup.Add(m_bufferAddr, this);
+
                 if (m_visible)
                 {
                     GenerateRenderStack(m_bufferAddr);
@@ -120,6 +127,16 @@ namespace FlareEngine.Rendering
             }
         }
 
+        internal static MeshRenderer GetMeshRenderer(uint a_buffer)
+        {
+            if (BufferLookup.ContainsKey(a_buffer))
+            {
+                return BufferLookup[a_buffer];
+            }
+
+            return null;
+        }
+
         public override void Init()
         {
             base.Init();
@@ -160,6 +177,8 @@ namespace FlareEngine.Rendering
 
                         DestroyBuffer(m_bufferAddr);
 
+                        BufferLookup.Remove(m_bufferAddr);
+
                         m_bufferAddr = uint.MaxValue;
                     }
                 }
@@ -0,0 +1,69 @@
+using FlareEngine.Maths;
+using System.Collections.Generic;
+using System.Runtime.CompilerServices;
+
+namespace FlareEngine.Rendering
+{
+    public struct RaycastHit
+    {
+        public MeshRenderer Renderer;
+        public float Distance;
+    }
+
+    // Goes off the bounds of the models so it is close enough for picking and gameplay but not exact
+    public static class SceneQuery
+    {
+        [MethodImpl(MethodImplOptions.InternalCall)]
+        extern static uint[] GetAABBMeshes(Vector3 a_min, Vector3 a_max);
+        [MethodImpl(MethodImplOptions.InternalCall)]
+        extern static uint[] GetSphereMeshes(Vector3 a_center, float a_radius);
+        [MethodImpl(MethodImplOptions.InternalCall)]
+        extern static uint[] GetFrustumMeshes(uint a_camAddr, Vector2 a_screenSize);
+        [MethodImpl(MethodImplOptions.InternalCall)]
+        extern static uint RayCastMesh(Vector3 a_origin, Vector3 a_direction, float a_maxDistance, out float a_distance);
+
+        static MeshRenderer[] ToRenderers(uint[] a_meshes)
+        {
+            List<MeshRenderer> renderers = new List<MeshRenderer>(a_meshes.Length);
+
+            foreach (uint mesh in a_meshes)
+            {
+                MeshRenderer renderer = MeshRenderer.GetMeshRenderer(mesh);
+                if (renderer != null)
+                {
+                    renderers.Add(renderer);
+                }
+            }
+
+            return renderers.ToArray();
+        }
+
+        public static MeshRenderer[] OverlapBox(Vector3 a_min, Vector3 a_max)
+        {
+            return ToRenderers(GetAABBMeshes(a_min, a_max));
+        }
+        public static MeshRenderer[] OverlapSphere(Vector3 a_center, float a_radius)
+        {
+            return ToRenderers(GetSphereMeshes(a_center, a_radius));
+        }
+        public static MeshRenderer[] GetVisible(Camera a_camera, Vector2 a_screenSize)
+        {
+            return ToRenderers(GetFrustumMeshes(a_camera.BufferAddr, a_screenSize));
+        }
+
+        public static bool RayCast(Vector3 a_origin, Vector3 a_direction, float a_maxDistance, out RaycastHit a_hit)
+        {
+            a_hit = new RaycastHit();
+
+            uint mesh = RayCastMesh(a_origin, a_direction, a_maxDistance, out a_hit.Distance);
+            if (mesh == uint.MaxValue)
+            {
+                return false;
+            }
+
+            a_hit.Renderer = MeshRenderer.GetMeshRenderer(mesh);
+
+            return a_hit.Renderer != null;
+        }
+    }
+}
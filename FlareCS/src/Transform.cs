@@ -16,9 +16,18 @@ namespace FlareEngine
         public Vector3 Scale;
     }
 
-    public class Transform : IDestroy
+    public unsafe class Transform : IDestroy
     {      
+        // Needs to match ObjectManager.h
+        const uint      TransformPageSize = 1024;
+
         uint            m_bufferAddr = uint.MaxValue;
+
+        // Points straight into native memory so reading and writing does not need to go through an internal call
+        // Native picks up the dirty bit on the next update
+        TransformBuffer* m_buffer;
+        ulong*          m_dirtyWord;
+        ulong           m_dirtyBit;
       
         GameObject      m_object;
 
@@ -33,6 +42,8 @@ namespace FlareEngine
         extern static void SetTransformBuffer(uint a_addr, TransformBuffer a_buffer);
         [MethodImplAttribute(MethodImplOptions.InternalCall)]
         extern static void DestroyTransformBuffer(uint a_addr); 
+        [MethodImplAttribute(MethodImplOptions.InternalCall)]
+        extern static IntPtr GetTransformPage(uint a_page);
 
         public bool IsDisposed
         {
@@ -65,7 +76,8 @@ namespace FlareEngine
 
                 m_parent = value;
 
-                TransformBuffer buffer = GetTransformBuffer(m_bufferAddr);
+                // Parent changes still go through native as the hierarchy needs updating
+                TransformBuffer buffer = *m_buffer;
 
                 if (m_parent != null)
                 {
@@ -102,13 +114,12 @@ namespace FlareEngine
         {
             get
             {
-                return GetTransformBuffer(m_bufferAddr).Translation;
+                return m_buffer->Translation;
             }
             set
             {
-                TransformBuffer buffer = GetTransformBuffer(m_bufferAddr);
-                buffer.Translation = value;
-                SetTransformBuffer(m_bufferAddr, buffer);
+                m_buffer->Translation = value;
+                *m_dirtyWord |= m_dirtyBit;
             }
         }
 
@@ -116,13 +127,12 @@ namespace FlareEngine
         {
             get
             {
-                return GetTransformBuffer(m_bufferAddr).Rotation;
+                return m_buffer->Rotation;
             }
             set
             {
-                TransformBuffer buffer = GetTransformBuffer(m_bufferAddr);
-                buffer.Rotation = value;
-                SetTransformBuffer(m_bufferAddr, buffer);
+                m_buffer->Rotation = value;
+                *m_dirtyWord |= m_dirtyBit;
             }
         }
 
@@ -130,22 +140,19 @@ namespace FlareEngine
         {
             get
             {
-                return GetTransformBuffer(m_bufferAddr).Scale;
+                return m_buffer->Scale;
             }
             set
             {
-                TransformBuffer buffer = GetTransformBuffer(m_bufferAddr);
-                buffer.Scale = value;
-                SetTransformBuffer(m_bufferAddr, buffer);
+                m_buffer->Scale = value;
+                *m_dirtyWord |= m_dirtyBit;
             }
         }
 
         public Matrix4 ToMatrix()
         {
             // Probably better to do it on the C++ side but will work
-            TransformBuffer buffer = GetTransformBuffer(m_bufferAddr);
-
-            return Matrix4.FromTransform(buffer.Translation, buffer.Rotation, buffer.Scale);
+            return Matrix4.FromTransform(m_buffer->Translation, m_buffer->Rotation, m_buffer->Scale);
         }
 
         internal Transform(GameObject a_object)
@@ -154,6 +161,14 @@ namespace FlareEngine
             m_children = new List<Transform>();
 
             m_bufferAddr = GenerateTransformBuffer();
+
+            // Pages never move so this stays valid until the transform is destroyed
+            TransformBuffer* page = (TransformBuffer*)GetTransformPage(m_bufferAddr / TransformPageSize);
+            uint index = m_bufferAddr % TransformPageSize;
+
+            m_buffer = page + index;
+            m_dirtyWord = (ulong*)(page + TransformPageSize) + index / 64;
+            m_dirtyBit = 1UL << (int)(index % 64);
         }
 
         public void Dispose()
@@ -177,6 +192,8 @@ namespace FlareEngine
                 }
 
                 m_bufferAddr = uint.MaxValue;
+                m_buffer = null;
+                m_dirtyWord = null;
             }
             else
             {
@@ -33,6 +33,13 @@ private:
         ProfileTFrame Frames[FrameMax];
     };
 
+    struct ProfileTCounter
+    {
+        char Scope[NameMax];
+        char Name[NameMax];
+        uint64_t Value;
+    };
+
     static constexpr std::string_view PipeName = "FlareEngine-IPC";
 
 #if WIN32
@@ -42,6 +49,8 @@ private:
 #endif
 
     volatile bool                                  m_unlockWindow;    
+    // Older editors do not know about counters so they only get sent once the editor says it can take them
+    volatile bool                                  m_sendProfileCounters;
     bool                                           m_close;
 
     std::mutex                                     m_fLock;
@@ -6,6 +6,7 @@
 
 class Config;
 class InputManager;
+class JobSystem;
 class ObjectManager;
 class RenderEngine;
 class RuntimeManager;
@@ -22,6 +23,7 @@ private:
     ObjectManager*  m_objectManager;
     RuntimeManager* m_runtime;
     RenderEngine*   m_renderEngine;
+    JobSystem*      m_jobSystem;
 
 protected:
 
@@ -1,6 +1,6 @@
 #pragma once
 
-#include "DataTypes/TArray.h"
+#include "DataTypes/TSlotMap.h"
 
 #include <string>
 
@@ -10,7 +10,7 @@ class RuntimeManager;
 class AssetLibrary
 {
 private:
-    TArray<Font*> m_fonts;
+    TSlotMap<Font*> m_fonts;
 
     AssetLibrary();
 protected:
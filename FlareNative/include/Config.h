@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <string_view>
 
@@ -16,6 +17,9 @@ private:
 
     e_RenderingEngine m_renderingEngine = RenderingEngine_Vulkan;
 
+    // How many update ticks the renderer is allowed to trail behind, 1 or 2
+    uint32_t          m_frameLatency = 1;
+
 protected:
 
 public:
@@ -30,6 +34,10 @@ public:
     {
         return m_renderingEngine;
     }
+    inline uint32_t GetFrameLatency() const
+    {
+        return m_frameLatency;
+    }
     inline bool IsHeadless() const
     {
         return m_headless;
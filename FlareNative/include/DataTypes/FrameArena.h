@@ -0,0 +1,340 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "DataTypes/HeapAllocation.h"
+
+// Bump allocator for stuff that only lives for a frame
+// Nothing gets freed individually, the whole thing is reset in one go when the frame comes around again
+// If a frame needs more than the block it spills into extra blocks and the next reset folds them into one big enough block so it settles down after a couple of frames
+class FrameArena
+{
+private:
+    static constexpr size_t DefaultCapacity = 64 * 1024;
+
+    struct Overflow
+    {
+        Overflow* Next;
+        size_t    Size;
+    };
+
+    char*     m_block;
+    size_t    m_capacity;
+    size_t    m_offset;
+
+    Overflow* m_overflow;
+    size_t    m_overflowOffset;
+    size_t    m_overflowUsed;
+
+    uint32_t  m_heapAllocations;
+
+    static constexpr size_t Align(size_t a_value, size_t a_alignment)
+    {
+        return (a_value + a_alignment - 1) & ~(a_alignment - 1);
+    }
+
+    void* AllocateOverflow(size_t a_size, size_t a_alignment)
+    {
+        const size_t header = Align(sizeof(Overflow), a_alignment);
+
+        if (m_overflow != nullptr)
+        {
+            const size_t offset = Align(m_overflowOffset, a_alignment);
+            if (offset + a_size <= m_overflow->Size)
+            {
+                m_overflowOffset = offset + a_size;
+                m_overflowUsed += a_size;
+
+                return (char*)m_overflow + offset;
+            }
+        }
+
+        size_t size = header + a_size;
+        if (size < m_capacity)
+        {
+            size = m_capacity;
+        }
+
+        ++m_heapAllocations;
+
+        Overflow* overflow = (Overflow*)HeapAllocation::Malloc(size);
+        overflow->Next = m_overflow;
+        overflow->Size = size;
+
+        m_overflow = overflow;
+        m_overflowOffset = header + a_size;
+        m_overflowUsed += a_size;
+
+        return (char*)overflow + header;
+    }
+
+protected:
+
+public:
+    explicit FrameArena(size_t a_capacity = DefaultCapacity) :
+        m_capacity(a_capacity),
+        m_offset(0),
+        m_overflow(nullptr),
+        m_overflowOffset(0),
+        m_overflowUsed(0),
+        m_heapAllocations(1)
+    {
+        m_block = (char*)HeapAllocation::Malloc(m_capacity);
+    }
+    FrameArena(const FrameArena&) = delete;
+    ~FrameArena()
+    {
+        Reset();
+
+        free(m_block);
+    }
+
+    FrameArena& operator =(const FrameArena&) = delete;
+
+    // Everything handed out before this is invalid afterwards
+    void Reset()
+    {
+        if (m_overflow != nullptr)
+        {
+            const size_t required = m_offset + m_overflowUsed;
+
+            while (m_overflow != nullptr)
+            {
+                Overflow* next = m_overflow->Next;
+                free(m_overflow);
+                m_overflow = next;
+            }
+
+            // Bit of headroom so it does not end up creeping up a few bytes at a time
+            m_capacity = Align(required + (required >> 2), 4096);
+
+            free(m_block);
+            m_block = (char*)HeapAllocation::Malloc(m_capacity);
+
+            ++m_heapAllocations;
+        }
+
+        m_offset = 0;
+        m_overflowOffset = 0;
+        m_overflowUsed = 0;
+    }
+
+    void* Allocate(size_t a_size, size_t a_alignment = alignof(std::max_align_t))
+    {
+        const size_t offset = Align(m_offset, a_alignment);
+        if (offset + a_size <= m_capacity)
+        {
+            m_offset = offset + a_size;
+
+            return m_block + offset;
+        }
+
+        return AllocateOverflow(a_size, a_alignment);
+    }
+    template<typename T>
+    inline T* Allocate(uint32_t a_count)
+    {
+        return (T*)Allocate(sizeof(T) * a_count, alignof(T));
+    }
+
+    inline size_t Used() const
+    {
+        return m_offset + m_overflowUsed;
+    }
+    inline size_t Capacity() const
+    {
+        return m_capacity;
+    }
+    // Times this has gone to the heap since it was created, should stop going up once it has warmed up
+    inline uint32_t HeapAllocations() const
+    {
+        return m_heapAllocations;
+    }
+};
+
+// Pointer and size into memory someone else owns, usually a frame arena
+template<typename T>
+class TArenaView
+{
+private:
+    T*       m_data;
+    uint32_t m_size;
+
+protected:
+
+public:
+    constexpr TArenaView() :
+        m_data(nullptr),
+        m_size(0) { }
+    constexpr TArenaView(T* a_data, uint32_t a_size) :
+        m_data(a_data),
+        m_size(a_size) { }
+
+    constexpr uint32_t Size() const
+    {
+        return m_size;
+    }
+    constexpr T* Data() const
+    {
+        return m_data;
+    }
+    constexpr bool Empty() const
+    {
+        return m_size <= 0;
+    }
+
+    constexpr T& operator [](uint32_t a_index) const
+    {
+        return m_data[a_index];
+    }
+
+    constexpr T* begin() const
+    {
+        return m_data;
+    }
+    constexpr T* end() const
+    {
+        return m_data + m_size;
+    }
+};
+
+// Growable array that takes its memory from a frame arena
+// Growing leaves the old memory behind in the arena so Reserve up front when the size is known
+template<typename T>
+class TArenaArray
+{
+private:
+    FrameArena* m_arena;
+    T*          m_data;
+    uint32_t    m_size;
+    uint32_t    m_capacity;
+
+    void Reallocate(uint32_t a_capacity)
+    {
+        T* data = m_arena->Allocate<T>(a_capacity);
+
+        if constexpr (std::is_trivially_copyable<T>())
+        {
+            if (m_size > 0)
+            {
+                memcpy(data, m_data, sizeof(T) * m_size);
+            }
+        }
+        else
+        {
+            for (uint32_t i = 0; i < m_size; ++i)
+            {
+                new (&data[i]) T(std::move(m_data[i]));
+                (&(m_data[i]))->~T();
+            }
+        }
+
+        m_data = data;
+        m_capacity = a_capacity;
+    }
+
+protected:
+
+public:
+    explicit TArenaArray(FrameArena* a_arena, uint32_t a_capacity = 0) :
+        m_arena(a_arena),
+        m_data(nullptr),
+        m_size(0),
+        m_capacity(0)
+    {
+        if (a_capacity > 0)
+        {
+            Reallocate(a_capacity);
+        }
+    }
+    TArenaArray(const TArenaArray&) = delete;
+    ~TArenaArray()
+    {
+        if constexpr (!std::is_trivially_destructible<T>())
+        {
+            for (uint32_t i = 0; i < m_size; ++i)
+            {
+                (&(m_data[i]))->~T();
+            }
+        }
+    }
+
+    TArenaArray& operator =(const TArenaArray&) = delete;
+
+    constexpr uint32_t Size() const
+    {
+        return m_size;
+    }
+    constexpr T* Data() const
+    {
+        return m_data;
+    }
+    constexpr bool Empty() const
+    {
+        return m_size <= 0;
+    }
+
+    inline void Reserve(uint32_t a_capacity)
+    {
+        if (a_capacity > m_capacity)
+        {
+            Reallocate(a_capacity);
+        }
+    }
+
+    template<typename... TArgs>
+    T& Emplace(TArgs&&... a_args)
+    {
+        if (m_size >= m_capacity)
+        {
+            Reallocate(m_capacity > 0 ? m_capacity * 2 : 8);
+        }
+
+        return *new (&m_data[m_size++]) T(std::forward<TArgs>(a_args)...);
+    }
+    inline uint32_t Push(const T& a_value)
+    {
+        Emplace(a_value);
+
+        return m_size - 1;
+    }
+
+    inline void Clear()
+    {
+        if constexpr (!std::is_trivially_destructible<T>())
+        {
+            for (uint32_t i = 0; i < m_size; ++i)
+            {
+                (&(m_data[i]))->~T();
+            }
+        }
+
+        m_size = 0;
+    }
+
+    constexpr T& operator [](uint32_t a_index) const
+    {
+        return m_data[a_index];
+    }
+
+    // View stays valid until the arena is reset even after this goes away as long as T does not need destroying
+    constexpr TArenaView<T> View() const
+    {
+        return TArenaView<T>(m_data, m_size);
+    }
+
+    constexpr T* begin() const
+    {
+        return m_data;
+    }
+    constexpr T* end() const
+    {
+        return m_data + m_size;
+    }
+};
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+
+// Containers allocate with malloc and realloc instead of new so they go through here to end up in the same count as operator new
+// Only counts when the profiler is enabled
+class HeapAllocation
+{
+private:
+    // Plain counter so it is safe to touch before anything else on the thread has been set up
+    static inline thread_local uint64_t ThreadAllocations = 0;
+
+protected:
+
+public:
+    static inline void Count()
+    {
+#ifdef FLARENATIVE_ENABLE_PROFILER
+        ++ThreadAllocations;
+#endif
+    }
+    static inline uint64_t GetThreadAllocations()
+    {
+        return ThreadAllocations;
+    }
+
+    static inline void* Malloc(size_t a_size)
+    {
+        Count();
+
+        return malloc(a_size);
+    }
+    static inline void* Realloc(void* a_ptr, size_t a_size)
+    {
+        Count();
+
+        return realloc(a_ptr, a_size);
+    }
+};
\ No newline at end of file
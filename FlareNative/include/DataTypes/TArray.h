@@ -2,10 +2,13 @@
 
 #include <cstring>
 #include <mutex>
+#include <new>
 #include <shared_mutex>
 #include <vector>
 
+#include "DataTypes/HeapAllocation.h"
 #include "DataTypes/TLockArray.h"
+#include "DataTypes/TSnapshot.h"
 
 // When in doubt with memory issues write it C style with C++ features
 // Using C++ memory features was causing seg-faults and leaks so just done it C style and just manually call the deconstructor when I need to
@@ -14,9 +17,29 @@ template<typename T>
 class TArray
 {
 private:
-    std::shared_mutex m_mutex;
-    uint32_t          m_size;
-    T*                m_data;
+    // Grow by half again so pushing N elements is amortised O(N) instead of reallocating on every push
+    static constexpr uint32_t MinCapacity = 4;
+    // Writes get tracked per page so a reused snapshot only copies the pages written since it was built
+    static constexpr uint32_t SnapshotPageShift = 6;
+    // Readers hold onto snapshots for a few frames so the old ones get kept to reuse instead of copying everything into a new one
+    static constexpr uint32_t SpareSnapshotCount = 4;
+
+    std::shared_mutex     m_mutex;
+    uint32_t              m_size;
+    uint32_t              m_capacity;
+    T*                    m_data;
+
+    // Bumped by anything that can write through the lock so snapshots know when they are stale
+    // Writing through the reference from operator[] is not tracked use LockSet or ToLockArray for that
+    uint64_t              m_version;
+    uint64_t              m_snapshotVersion;
+    TSnapshotData<T>*     m_snapshot;
+
+    // Version of the last write to each page, snapshots built before m_fullWriteVersion get copied in full as something wrote without saying where
+    std::vector<uint64_t> m_pageVersions;
+    uint64_t              m_fullWriteVersion;
+    TSnapshotData<T>*     m_spareSnapshots[SpareSnapshotCount];
+    uint32_t              m_spareSnapshotCount;
 
     inline void DestroyData()
     {
@@ -29,20 +52,190 @@ private:
         }
     }
 
+    void Reallocate(uint32_t a_capacity)
+    {
+        if (a_capacity == m_capacity)
+        {
+            return;
+        }
+
+        if (a_capacity <= 0)
+        {
+            free(m_data);
+
+            m_capacity = 0;
+            m_data = nullptr;
+
+            return;
+        }
+
+        // Moving the memory about is fine as everything is relocated the same way it was before
+        T* dat = (T*)HeapAllocation::Realloc(m_data, a_capacity * sizeof(T));
+        if (a_capacity > m_capacity)
+        {
+            memset(dat + m_capacity, 0, (a_capacity - m_capacity) * sizeof(T));
+        }
+
+        m_capacity = a_capacity;
+        m_data = dat;
+    }
+    inline void Grow(uint32_t a_size)
+    {
+        if (a_size <= m_capacity)
+        {
+            return;
+        }
+
+        uint32_t capacity = m_capacity + (m_capacity >> 1);
+        if (capacity < MinCapacity)
+        {
+            capacity = MinCapacity;
+        }
+        if (capacity < a_size)
+        {
+            capacity = a_size;
+        }
+
+        Reallocate(capacity);
+    }
+
+    void UMarkWrittenRange(uint32_t a_start, uint32_t a_end)
+    {
+        ++m_version;
+
+        if (a_start >= a_end)
+        {
+            return;
+        }
+
+        const uint32_t endPage = ((a_end - 1) >> SnapshotPageShift) + 1;
+        if (endPage > m_pageVersions.size())
+        {
+            m_pageVersions.resize(endPage, 0);
+        }
+
+        for (uint32_t i = a_start >> SnapshotPageShift; i < endPage; ++i)
+        {
+            m_pageVersions[i] = m_version;
+        }
+    }
+    inline void UMarkAllWritten()
+    {
+        ++m_version;
+        m_fullWriteVersion = m_version;
+    }
+
+    // Brings a snapshot only the array is holding up to date
+    void UUpdateSnapshot(TSnapshotData<T>* a_snapshot)
+    {
+        const uint32_t keep = a_snapshot->Size < m_size ? a_snapshot->Size : m_size;
+        a_snapshot->Truncate(keep);
+
+        if (a_snapshot->Version < m_fullWriteVersion)
+        {
+            a_snapshot->CopyRange(m_data, 0, keep);
+        }
+        else
+        {
+            const uint32_t pageCount = (uint32_t)m_pageVersions.size();
+            for (uint32_t i = 0; i < pageCount; ++i)
+            {
+                const uint32_t start = i << SnapshotPageShift;
+                if (start >= keep)
+                {
+                    break;
+                }
+
+                if (m_pageVersions[i] > a_snapshot->Version)
+                {
+                    const uint32_t end = start + (0b1 << SnapshotPageShift);
+
+                    a_snapshot->CopyRange(m_data, start, end < keep ? end : keep);
+                }
+            }
+        }
+
+        a_snapshot->CopyRange(m_data, keep, m_size);
+        a_snapshot->Size = m_size;
+        a_snapshot->Version = m_version;
+    }
+    TSnapshotData<T>* UBuildSnapshot()
+    {
+        if (m_snapshot != nullptr)
+        {
+            // Holding the only reference means no reader can see it so it can be written over
+            if (m_snapshot->RefCount.load(std::memory_order_acquire) == 1 && m_snapshot->Capacity >= m_size)
+            {
+                UUpdateSnapshot(m_snapshot);
+
+                return m_snapshot;
+            }
+
+            if (m_spareSnapshotCount >= SpareSnapshotCount)
+            {
+                m_spareSnapshots[0]->Release();
+
+                --m_spareSnapshotCount;
+                for (uint32_t i = 0; i < m_spareSnapshotCount; ++i)
+                {
+                    m_spareSnapshots[i] = m_spareSnapshots[i + 1];
+                }
+            }
+
+            m_spareSnapshots[m_spareSnapshotCount++] = m_snapshot;
+            m_snapshot = nullptr;
+        }
+
+        // Newest first as it has the least to copy
+        for (uint32_t i = m_spareSnapshotCount; i > 0; --i)
+        {
+            TSnapshotData<T>* snapshot = m_spareSnapshots[i - 1];
+            if (snapshot->RefCount.load(std::memory_order_acquire) == 1 && snapshot->Capacity >= m_size)
+            {
+                --m_spareSnapshotCount;
+                for (uint32_t j = i - 1; j < m_spareSnapshotCount; ++j)
+                {
+                    m_spareSnapshots[j] = m_spareSnapshots[j + 1];
+                }
+
+                UUpdateSnapshot(snapshot);
+
+                return snapshot;
+            }
+        }
+
+        TSnapshotData<T>* snapshot = TSnapshotData<T>::Create(m_data, m_size, m_capacity);
+        snapshot->Version = m_version;
+
+        return snapshot;
+    }
+
 protected:
 
 public:
     constexpr TArray() :
         m_size(0),
-        m_data(nullptr) { }
+        m_capacity(0),
+        m_data(nullptr),
+        m_version(0),
+        m_snapshotVersion(0),
+        m_snapshot(nullptr),
+        m_fullWriteVersion(0),
+        m_spareSnapshotCount(0) { }
     TArray(const TArray& a_other)
     {
         const std::unique_lock<std::shared_mutex> otherG = std::unique_lock<std::shared_mutex>(a_other.m_mutex);
         const std::unique_lock<std::shared_mutex> g = std::unique_lock<std::shared_mutex>(m_mutex);
 
         m_size = a_other.m_size;
+        m_capacity = m_size;
+        m_version = 0;
+        m_snapshotVersion = 0;
+        m_snapshot = nullptr;
+        m_fullWriteVersion = 0;
+        m_spareSnapshotCount = 0;
         const uint32_t aSize = sizeof(T) * m_size;
-        m_data = (T*)malloc(aSize);
+        m_data = (T*)HeapAllocation::Malloc(aSize);
         memcpy(m_data, a_other.m_data, aSize);
     }
     TArray(TArray&& a_other)
@@ -51,17 +244,37 @@ public:
         const std::unique_lock<std::shared_mutex> g = std::unique_lock<std::shared_mutex>(m_mutex);
 
         m_size = a_other.m_size;
+        m_capacity = a_other.m_capacity;
         m_data = a_other.m_data;
+        m_version = a_other.m_version;
+        m_snapshotVersion = a_other.m_snapshotVersion;
+        m_snapshot = a_other.m_snapshot;
+        m_pageVersions = std::move(a_other.m_pageVersions);
+        m_fullWriteVersion = a_other.m_fullWriteVersion;
+        m_spareSnapshotCount = a_other.m_spareSnapshotCount;
+        for (uint32_t i = 0; i < m_spareSnapshotCount; ++i)
+        {
+            m_spareSnapshots[i] = a_other.m_spareSnapshots[i];
+        }
         a_other.m_size = 0;
+        a_other.m_capacity = 0;
         a_other.m_data = nullptr;
+        a_other.m_snapshot = nullptr;
+        a_other.m_spareSnapshotCount = 0;
     }
     TArray(const T* a_data, uint32_t a_size)
     {
         const std::unique_lock<std::shared_mutex> g = std::unique_lock<std::shared_mutex>(m_mutex);
 
         m_size = a_size;
+        m_capacity = m_size;
+        m_version = 0;
+        m_snapshotVersion = 0;
+        m_snapshot = nullptr;
+        m_fullWriteVersion = 0;
+        m_spareSnapshotCount = 0;
         const uint32_t aSize = sizeof(T) * m_size;
-        m_data = (T*)malloc(aSize);
+        m_data = (T*)HeapAllocation::Malloc(aSize);
         memset(m_data, 0, aSize);
         for (uint32_t i = 0; i < m_size; ++i)
         {
@@ -72,9 +285,15 @@ public:
     {
         const std::unique_lock<std::shared_mutex> g = std::unique_lock<std::shared_mutex>(m_mutex);
         
-        const uint32_t aSize = a_end - a_start;
-        m_size = aSize / sizeof(T);
-        m_data = (T*)malloc(aSize);
+        m_size = (uint32_t)(a_end - a_start);
+        m_capacity = m_size;
+        m_version = 0;
+        m_snapshotVersion = 0;
+        m_snapshot = nullptr;
+        m_fullWriteVersion = 0;
+        m_spareSnapshotCount = 0;
+        const uint32_t aSize = sizeof(T) * m_size;
+        m_data = (T*)HeapAllocation::Malloc(aSize);
         memset(m_data, 0, aSize);
         for (uint32_t i = 0; i < m_size; ++i)
         {
@@ -86,8 +305,14 @@ public:
         const std::unique_lock<std::shared_mutex> g = std::unique_lock<std::shared_mutex>(m_mutex);
 
         m_size = (uint32_t)a_vec.size();
+        m_capacity = m_size;
+        m_version = 0;
+        m_snapshotVersion = 0;
+        m_snapshot = nullptr;
+        m_fullWriteVersion = 0;
+        m_spareSnapshotCount = 0;
         const uint32_t aSize = sizeof(T) * m_size;
-        m_data = (T*)malloc(aSize);
+        m_data = (T*)HeapAllocation::Malloc(aSize);
         memset(m_data, 0, aSize);
         for (uint32_t i = 0; i < m_size; ++i)
         {
@@ -98,6 +323,15 @@ public:
     {
         const std::unique_lock<std::shared_mutex> g = std::unique_lock<std::shared_mutex>(m_mutex);
 
+        if (m_snapshot != nullptr)
+        {
+            m_snapshot->Release();
+        }
+        for (uint32_t i = 0; i < m_spareSnapshotCount; ++i)
+        {
+            m_spareSnapshots[i]->Release();
+        }
+
         if (m_data != nullptr)
         {
             DestroyData();
@@ -118,9 +352,11 @@ public:
             free(m_data);
         }
 
+        UMarkAllWritten();
         m_size = a_other.m_size;
+        m_capacity = m_size;
         const uint32_t aSize = m_size * sizeof(T);
-        m_data = (T*)malloc(aSize);
+        m_data = (T*)HeapAllocation::Malloc(aSize);
         memset(m_data, 0, aSize);
         for (uint32_t i = 0; i < m_size; ++i)
         {
@@ -141,10 +377,26 @@ public:
 
         return std::vector<T>(m_data, m_data + m_size);
     }
+    // For writing to a known set of indices, UMarkWritten needs calling for each one before the lock goes so the snapshots pick them up
+    TLockArray<T> ToUntrackedLockArray()
+    {
+        TLockArray<T> a = TLockArray<T>(m_mutex);
+
+        a.SetData(m_data, m_size);
+
+        return a;
+    }
+    inline void UMarkWritten(uint32_t a_index)
+    {
+        UMarkWrittenRange(a_index, a_index + 1);
+    }
     TLockArray<T> ToLockArray()
     {
         TLockArray<T> a = TLockArray<T>(m_mutex);
 
+        // Have to assume it is getting written to
+        UMarkAllWritten();
+
         a.SetData(m_data, m_size);
 
         return a;
@@ -158,6 +410,10 @@ public:
     {
         return m_size;
     }
+    constexpr uint32_t Capacity() const
+    {
+        return m_capacity;
+    }
     constexpr T* Data() const
     {
         return m_data;
@@ -173,35 +429,111 @@ public:
 
         return m_data[a_index];
     }
+    // For writing in place while already holding the lock so the snapshots still know it changed
+    inline T& UGet(uint32_t a_index)
+    {
+        UMarkWrittenRange(a_index, a_index + 1);
+
+        return m_data[a_index];
+    }
     inline void LockSet(uint32_t a_index, const T& a_value)
     {
         const std::unique_lock<std::shared_mutex> g = std::unique_lock<std::shared_mutex>(m_mutex);
 
+        USet(a_index, a_value);
+    }
+    inline void USet(uint32_t a_index, const T& a_value)
+    {
+        UMarkWrittenRange(a_index, a_index + 1);
         m_data[a_index] = a_value;
     }
 
-    void Push(const T& a_data)
+    // Hands out an immutable copy that can be indexed without locking for as long as the reader holds onto it
+    // Only copies when something has been written since the last one otherwise it is just a ref count bump
+    // Old copies get reused once readers are done with them and only have the pages written since brought up to date
+    TSnapshot<T> Snapshot()
     {
+        {
+            const std::shared_lock<std::shared_mutex> g = std::shared_lock<std::shared_mutex>(m_mutex);
+
+            if (m_snapshot != nullptr && m_snapshotVersion == m_version)
+            {
+                return TSnapshot<T>(m_snapshot);
+            }
+        }
+
         const std::unique_lock<std::shared_mutex> g = std::unique_lock<std::shared_mutex>(m_mutex);
 
-        const uint32_t aSize = (m_size + 1) * sizeof(T);
-        T* dat = (T*)malloc(aSize);
-        memset(dat, 0, aSize);
-        if (m_data != nullptr)
-        {   
-            memcpy(dat, m_data, m_size * sizeof(T));
+        if (m_snapshot == nullptr || m_snapshotVersion != m_version)
+        {
+            m_snapshot = UBuildSnapshot();
+            m_snapshotVersion = m_version;
+        }
 
-            free(m_data);
+        return TSnapshot<T>(m_snapshot);
+    }
+
+    inline void Reserve(uint32_t a_capacity)
+    {
+        const std::unique_lock<std::shared_mutex> g = std::unique_lock<std::shared_mutex>(m_mutex);
+
+        UReserve(a_capacity);
+    }
+    void UReserve(uint32_t a_capacity)
+    {
+        if (a_capacity > m_capacity)
+        {
+            Reallocate(a_capacity);
         }
+    }
+    inline void ShrinkToFit()
+    {
+        const std::unique_lock<std::shared_mutex> g = std::unique_lock<std::shared_mutex>(m_mutex);
 
-        dat[m_size++] = a_data;
-        
-        m_data = dat;
+        Reallocate(m_size);
     }
-    T Pop()
+
+    inline uint32_t Push(const T& a_data)
     {
         const std::unique_lock<std::shared_mutex> g = std::unique_lock<std::shared_mutex>(m_mutex);
-        
+
+        return UPush(a_data);
+    }
+    uint32_t UPush(const T& a_data)
+    {
+        UMarkWrittenRange(m_size, m_size + 1);
+        Grow(m_size + 1);
+
+        new (&m_data[m_size]) T(a_data);
+
+        return m_size++;
+    }
+    // Returns the index of the first element pushed
+    uint32_t PushRange(const T* a_data, uint32_t a_count)
+    {
+        const std::unique_lock<std::shared_mutex> g = std::unique_lock<std::shared_mutex>(m_mutex);
+
+        UMarkWrittenRange(m_size, m_size + a_count);
+        const uint32_t index = m_size;
+
+        Grow(m_size + a_count);
+
+        for (uint32_t i = 0; i < a_count; ++i)
+        {
+            new (&m_data[m_size++]) T(a_data[i]);
+        }
+
+        return index;
+    }
+    inline T Pop()
+    {
+        const std::unique_lock<std::shared_mutex> g = std::unique_lock<std::shared_mutex>(m_mutex);
+
+        return UPop();
+    }
+    T UPop()
+    {
+        ++m_version;
         T dat = m_data[--m_size];
 
         if constexpr (std::is_destructible<T>())
@@ -219,40 +551,25 @@ public:
     }
     void UErase(uint32_t a_index)
     {
-        constexpr uint32_t Stride = sizeof(T);
-
-        const uint32_t aSize = (m_size - 1) * Stride;
+        // Everything after it moves down
+        UMarkWrittenRange(a_index, m_size);
 
         if constexpr (std::is_destructible<T>())
         {
             (&(m_data[a_index]))->~T();
         }
 
-        const uint32_t offset = a_index * Stride;
-
-        T* dat = (T*)malloc(aSize);
-        memset(dat, 0, aSize);
-        if (m_data != nullptr)
-        {
-            memcpy(dat, m_data, offset);
-            memcpy(((char*)dat) + offset, ((char*)m_data) + ((a_index + 1) * Stride), (m_size - a_index - 1) * Stride);
+        memmove(m_data + a_index, m_data + a_index + 1, (m_size - a_index - 1) * sizeof(T));
 
-            free(m_data);
-        }
-
-        --m_size;
-        m_data = dat;
+        memset(m_data + --m_size, 0, sizeof(T));
     }
     void Erase(uint32_t a_start, uint32_t a_end)
     {
-        constexpr uint32_t Stride = sizeof(T);
-
         const std::unique_lock<std::shared_mutex> g = std::unique_lock<std::shared_mutex>(m_mutex);
 
+        UMarkWrittenRange(a_start, m_size);
         const uint32_t diff = a_end - a_start;
 
-        const uint32_t aSize = (m_size - diff) * Stride;
-
         if constexpr (std::is_destructible<T>())
         {
             for (uint32_t i = a_start; i < a_end; ++i)
@@ -261,22 +578,40 @@ public:
             }
         }
 
-        const uint32_t offset = a_start * Stride;
+        memmove(m_data + a_start, m_data + a_end, (m_size - a_end) * sizeof(T));
 
-        T* dat = (T*)malloc(aSize);
-        memset(dat, 0, aSize);
-        if (m_data != nullptr)
+        m_size -= diff;
+        memset(m_data + m_size, 0, diff * sizeof(T));
+    }
+    // Does not keep the order but is O(1) as it just moves the last element into the hole
+    // Returns the old index of the element that got moved so anything pointing at it can be fixed up
+    inline uint32_t SwapErase(uint32_t a_index)
+    {
+        const std::unique_lock<std::shared_mutex> g = std::unique_lock<std::shared_mutex>(m_mutex);
+
+        return USwapErase(a_index);
+    }
+    uint32_t USwapErase(uint32_t a_index)
+    {
+        UMarkWrittenRange(a_index, a_index + 1);
+
+        if constexpr (std::is_destructible<T>())
         {
-            memcpy(dat, m_data, offset);
-            memcpy(((char*)dat) + offset, ((char*)m_data) + ((a_end + 1) * Stride), (m_size - a_start - diff) * Stride);
+            (&(m_data[a_index]))->~T();
+        }
 
-            free(m_data);
+        const uint32_t last = --m_size;
+        if (a_index != last)
+        {
+            memcpy(m_data + a_index, m_data + last, sizeof(T));
         }
 
-        m_size -= diff;
-        m_data = dat;
+        memset(m_data + last, 0, sizeof(T));
+
+        return last;
     }
 
+    // Keeps the memory around so refilling it does not need to allocate again use ShrinkToFit if the memory is wanted back
     inline void Clear()
     {
         const std::unique_lock<std::shared_mutex> g = std::unique_lock<std::shared_mutex>(m_mutex);
@@ -285,11 +620,15 @@ public:
     }
     void UClear()
     {
+        ++m_version;
+
         DestroyData();
 
-        free(m_data);
+        if (m_data != nullptr)
+        {
+            memset(m_data, 0, m_size * sizeof(T));
+        }
 
         m_size = 0;
-        m_data = nullptr;
     }
 };
\ No newline at end of file
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// Hands whole frames from one thread to another without either side locking
+// Works like a triple buffer, the producer fills the back slot then swaps it into the mailbox and the consumer swaps out of the mailbox when there is something new
+// The consumer holds onto up to latency frames and always uses the oldest so latency 2 renders one tick behind to give the producer a full tick of slack
+// Only one producer thread and one consumer thread
+template<typename T, uint32_t MaxLatency = 2>
+class TFrameMailbox
+{
+private:
+    static constexpr uint32_t SlotCount = MaxLatency + 2;
+    static constexpr uint32_t IndexMask = 0xFF;
+    static constexpr uint32_t FreshBit = 0b1 << 8;
+
+    T                     m_slots[SlotCount];
+
+    uint32_t              m_latency;
+
+    // Producer side
+    uint32_t              m_back;
+
+    std::atomic<uint32_t> m_mailbox;
+
+    // Consumer side, oldest first
+    uint32_t              m_held[MaxLatency];
+    uint32_t              m_heldCount;
+    uint32_t              m_spare[MaxLatency];
+    uint32_t              m_spareCount;
+
+protected:
+
+public:
+    TFrameMailbox() :
+        m_latency(1),
+        m_back(0),
+        m_mailbox(1),
+        m_heldCount(1),
+        m_spareCount(0)
+    {
+        // Starts off holding an empty frame so there is always something to hand out
+        m_held[0] = 2;
+
+        for (uint32_t i = 3; i < SlotCount; ++i)
+        {
+            m_spare[m_spareCount++] = i;
+        }
+    }
+    TFrameMailbox(const TFrameMailbox&) = delete;
+    ~TFrameMailbox() { }
+
+    TFrameMailbox& operator =(const TFrameMailbox&) = delete;
+
+    // Needs to be set before the threads start using it
+    inline void SetLatency(uint32_t a_latency)
+    {
+        m_latency = a_latency < 1 ? 1 : (a_latency > MaxLatency ? MaxLatency : a_latency);
+    }
+    constexpr uint32_t GetLatency() const
+    {
+        return m_latency;
+    }
+
+    // Producer writes the next frame into this then calls Publish
+    inline T& Back()
+    {
+        return m_slots[m_back];
+    }
+    // Anything that was published and not picked up yet gets dropped in favour of this one
+    inline void Publish()
+    {
+        m_back = m_mailbox.exchange(m_back | FreshBit, std::memory_order_acq_rel) & IndexMask;
+    }
+
+    // Frame for the consumer to use, stays valid until the next call
+    const T& Acquire()
+    {
+        if (m_mailbox.load(std::memory_order_acquire) & FreshBit)
+        {
+            uint32_t giveBack;
+            if (m_heldCount >= m_latency)
+            {
+                giveBack = m_held[0];
+
+                --m_heldCount;
+                for (uint32_t i = 0; i < m_heldCount; ++i)
+                {
+                    m_held[i] = m_held[i + 1];
+                }
+            }
+            else
+            {
+                giveBack = m_spare[--m_spareCount];
+            }
+
+            // Only the consumer ever clears the bit so this is always a fresh frame
+            m_held[m_heldCount++] = m_mailbox.exchange(giveBack, std::memory_order_acq_rel) & IndexMask;
+        }
+
+        return m_slots[m_held[0]];
+    }
+};
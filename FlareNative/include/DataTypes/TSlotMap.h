@@ -0,0 +1,209 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+#include <vector>
+
+// Hands out index + generation handles so a stale address cannot alias whatever got put in the slot after it
+// Still fits in 32 bits so C# can keep treating them as a uint with -1 being invalid
+template<typename T>
+class TSlotMap
+{
+public:
+    static constexpr uint32_t IndexBits = 24;
+    static constexpr uint32_t IndexMask = (0b1 << IndexBits) - 1;
+    static constexpr uint32_t GenerationMask = 0xFF;
+    // Top index is never handed out so a handle cannot end up as -1
+    static constexpr uint32_t MaxSlots = IndexMask;
+
+private:
+    static constexpr uint32_t EndOfList = -1;
+
+    struct Slot
+    {
+        T        Value;
+        uint32_t Generation;
+        uint32_t NextFree;
+        bool     Alive;
+    };
+
+    std::shared_mutex m_mutex;
+    std::vector<Slot> m_slots;
+
+    // Free slots are reused oldest first so it takes as long as possible for a generation to wrap around
+    uint32_t          m_freeHead;
+    uint32_t          m_freeTail;
+    uint32_t          m_count;
+
+    inline const Slot* GetSlot(uint32_t a_handle) const
+    {
+        const uint32_t index = ToIndex(a_handle);
+        if (index >= m_slots.size())
+        {
+            return nullptr;
+        }
+
+        const Slot& slot = m_slots[index];
+        if (!slot.Alive || slot.Generation != ToGeneration(a_handle))
+        {
+            return nullptr;
+        }
+
+        return &slot;
+    }
+
+protected:
+
+public:
+    static constexpr uint32_t ToIndex(uint32_t a_handle)
+    {
+        return a_handle & IndexMask;
+    }
+    static constexpr uint32_t ToGeneration(uint32_t a_handle)
+    {
+        return (a_handle >> IndexBits) & GenerationMask;
+    }
+    static constexpr uint32_t ToHandle(uint32_t a_index, uint32_t a_generation)
+    {
+        return (a_index & IndexMask) | (a_generation & GenerationMask) << IndexBits;
+    }
+
+    TSlotMap() :
+        m_freeHead(EndOfList),
+        m_freeTail(EndOfList),
+        m_count(0) { }
+    TSlotMap(const TSlotMap&) = delete;
+    ~TSlotMap() { }
+
+    TSlotMap& operator =(const TSlotMap&) = delete;
+
+    // Returns -1 if it is out of slots
+    uint32_t Insert(const T& a_value)
+    {
+        const std::unique_lock<std::shared_mutex> g = std::unique_lock<std::shared_mutex>(m_mutex);
+
+        uint32_t index = m_freeHead;
+        if (index != EndOfList)
+        {
+            m_freeHead = m_slots[index].NextFree;
+            if (m_freeHead == EndOfList)
+            {
+                m_freeTail = EndOfList;
+            }
+        }
+        else
+        {
+            index = (uint32_t)m_slots.size();
+            if (index >= MaxSlots)
+            {
+                return -1;
+            }
+
+            m_slots.emplace_back(Slot{ T(), 0, EndOfList, false });
+        }
+
+        Slot& slot = m_slots[index];
+        slot.Value = a_value;
+        slot.NextFree = EndOfList;
+        slot.Alive = true;
+
+        ++m_count;
+
+        return ToHandle(index, slot.Generation);
+    }
+
+    inline bool Valid(uint32_t a_handle)
+    {
+        const std::shared_lock<std::shared_mutex> g = std::shared_lock<std::shared_mutex>(m_mutex);
+
+        return GetSlot(a_handle) != nullptr;
+    }
+
+    // Stale or invalid handles get a default constructed value back so nullptr for the resource tables
+    T Get(uint32_t a_handle)
+    {
+        const std::shared_lock<std::shared_mutex> g = std::shared_lock<std::shared_mutex>(m_mutex);
+
+        const Slot* slot = GetSlot(a_handle);
+        if (slot == nullptr)
+        {
+            return T();
+        }
+
+        return slot->Value;
+    }
+    bool Set(uint32_t a_handle, const T& a_value)
+    {
+        const std::unique_lock<std::shared_mutex> g = std::unique_lock<std::shared_mutex>(m_mutex);
+
+        Slot* slot = (Slot*)GetSlot(a_handle);
+        if (slot == nullptr)
+        {
+            return false;
+        }
+
+        slot->Value = a_value;
+
+        return true;
+    }
+
+    // Returns what was in the slot so the caller can clean it up
+    T Erase(uint32_t a_handle)
+    {
+        const std::unique_lock<std::shared_mutex> g = std::unique_lock<std::shared_mutex>(m_mutex);
+
+        Slot* slot = (Slot*)GetSlot(a_handle);
+        if (slot == nullptr)
+        {
+            return T();
+        }
+
+        const T value = slot->Value;
+
+        slot->Value = T();
+        slot->Alive = false;
+        slot->Generation = (slot->Generation + 1) & GenerationMask;
+        slot->NextFree = EndOfList;
+
+        const uint32_t index = ToIndex(a_handle);
+        if (m_freeTail != EndOfList)
+        {
+            m_slots[m_freeTail].NextFree = index;
+        }
+        else
+        {
+            m_freeHead = index;
+        }
+        m_freeTail = index;
+
+        --m_count;
+
+        return value;
+    }
+
+    inline uint32_t Count()
+    {
+        const std::shared_lock<std::shared_mutex> g = std::shared_lock<std::shared_mutex>(m_mutex);
+
+        return m_count;
+    }
+
+    // Everything still alive mostly for cleaning up on shutdown
+    std::vector<T> ToVector()
+    {
+        const std::shared_lock<std::shared_mutex> g = std::shared_lock<std::shared_mutex>(m_mutex);
+
+        std::vector<T> values;
+        values.reserve(m_count);
+        for (const Slot& slot : m_slots)
+        {
+            if (slot.Alive)
+            {
+                values.emplace_back(slot.Value);
+            }
+        }
+
+        return values;
+    }
+};
@@ -0,0 +1,247 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "DataTypes/HeapAllocation.h"
+
+// Immutable copy of a TArray that gets handed out to readers
+// The array keeps a reference to the newest one and every reader holds their own so the old ones go away when the last reader lets go
+template<typename T>
+struct TSnapshotData
+{
+    std::atomic<uint32_t> RefCount;
+    uint32_t              Size;
+    uint32_t              Capacity;
+    T*                    Data;
+    // Owner only, lets it work out what has been written since this was built when it gets reused
+    uint64_t              Version;
+
+    static TSnapshotData* Create(const T* a_data, uint32_t a_size, uint32_t a_capacity = 0)
+    {
+        if (a_capacity < a_size)
+        {
+            a_capacity = a_size;
+        }
+
+        // Single block so a snapshot is one allocation and the data sits right after the header
+        constexpr size_t HeaderSize = (sizeof(TSnapshotData) + alignof(T) - 1) & ~(alignof(T) - 1);
+
+        char* block = (char*)HeapAllocation::Malloc(HeaderSize + sizeof(T) * a_capacity);
+
+        TSnapshotData* snapshot = new (block) TSnapshotData();
+        snapshot->RefCount = 1;
+        snapshot->Size = a_size;
+        snapshot->Capacity = a_capacity;
+        snapshot->Data = (T*)(block + HeaderSize);
+        snapshot->Version = 0;
+
+        for (uint32_t i = 0; i < a_size; ++i)
+        {
+            new (&snapshot->Data[i]) T(a_data[i]);
+        }
+
+        return snapshot;
+    }
+    // Copies over the old one in place if the owner is the only one left holding it so a snapshot every frame does not mean an allocation every frame
+    // Whatever hands out references needs to be locked so the count cannot go up while this is going on
+    static TSnapshotData* Rebuild(TSnapshotData* a_snapshot, const T* a_data, uint32_t a_size, uint32_t a_capacity = 0)
+    {
+        if (a_snapshot != nullptr)
+        {
+            if (a_snapshot->RefCount.load(std::memory_order_acquire) == 1 && a_snapshot->Capacity >= a_size)
+            {
+                a_snapshot->DestroyData();
+
+                for (uint32_t i = 0; i < a_size; ++i)
+                {
+                    new (&a_snapshot->Data[i]) T(a_data[i]);
+                }
+                a_snapshot->Size = a_size;
+
+                return a_snapshot;
+            }
+
+            a_snapshot->Release();
+        }
+
+        return Create(a_data, a_size, a_capacity);
+    }
+
+    // Only for the owner while it holds the only reference, anything past the size gets constructed instead of copied over
+    void CopyRange(const T* a_data, uint32_t a_start, uint32_t a_end)
+    {
+        for (uint32_t i = a_start; i < a_end; ++i)
+        {
+            if constexpr (std::is_destructible<T>())
+            {
+                if (i < Size)
+                {
+                    (&(Data[i]))->~T();
+                }
+            }
+
+            new (&Data[i]) T(a_data[i]);
+        }
+    }
+    void Truncate(uint32_t a_size)
+    {
+        if (a_size >= Size)
+        {
+            return;
+        }
+
+        if constexpr (std::is_destructible<T>())
+        {
+            for (uint32_t i = a_size; i < Size; ++i)
+            {
+                (&(Data[i]))->~T();
+            }
+        }
+
+        Size = a_size;
+    }
+
+    inline void DestroyData()
+    {
+        if constexpr (std::is_destructible<T>())
+        {
+            for (uint32_t i = 0; i < Size; ++i)
+            {
+                (&(Data[i]))->~T();
+            }
+        }
+    }
+
+    inline void Acquire()
+    {
+        RefCount.fetch_add(1, std::memory_order_relaxed);
+    }
+    void Release()
+    {
+        if (RefCount.fetch_sub(1, std::memory_order_acq_rel) != 1)
+        {
+            return;
+        }
+
+        DestroyData();
+
+        this->~TSnapshotData();
+        free(this);
+    }
+};
+
+// Reader side of a snapshot
+// Only touches the ref count when it is copied or destroyed so indexing is just a pointer offset
+template<typename T>
+class TSnapshot
+{
+private:
+    TSnapshotData<T>* m_snapshot;
+    const T*          m_data;
+    uint32_t          m_size;
+
+protected:
+
+public:
+    constexpr TSnapshot() :
+        m_snapshot(nullptr),
+        m_data(nullptr),
+        m_size(0) { }
+    // Takes a new reference
+    explicit TSnapshot(TSnapshotData<T>* a_snapshot) :
+        m_snapshot(a_snapshot),
+        m_data(nullptr),
+        m_size(0)
+    {
+        if (m_snapshot != nullptr)
+        {
+            m_snapshot->Acquire();
+
+            m_data = m_snapshot->Data;
+            m_size = m_snapshot->Size;
+        }
+    }
+    TSnapshot(const TSnapshot& a_other) :
+        TSnapshot(a_other.m_snapshot) { }
+    TSnapshot(TSnapshot&& a_other) :
+        m_snapshot(a_other.m_snapshot),
+        m_data(a_other.m_data),
+        m_size(a_other.m_size)
+    {
+        a_other.m_snapshot = nullptr;
+        a_other.m_data = nullptr;
+        a_other.m_size = 0;
+    }
+    ~TSnapshot()
+    {
+        if (m_snapshot != nullptr)
+        {
+            m_snapshot->Release();
+        }
+    }
+
+    TSnapshot& operator =(const TSnapshot& a_other)
+    {
+        if (m_snapshot != a_other.m_snapshot)
+        {
+            TSnapshot tmp = TSnapshot(a_other);
+
+            *this = std::move(tmp);
+        }
+
+        return *this;
+    }
+    TSnapshot& operator =(TSnapshot&& a_other)
+    {
+        if (this != &a_other)
+        {
+            if (m_snapshot != nullptr)
+            {
+                m_snapshot->Release();
+            }
+
+            m_snapshot = a_other.m_snapshot;
+            m_data = a_other.m_data;
+            m_size = a_other.m_size;
+
+            a_other.m_snapshot = nullptr;
+            a_other.m_data = nullptr;
+            a_other.m_size = 0;
+        }
+
+        return *this;
+    }
+
+    constexpr uint32_t Size() const
+    {
+        return m_size;
+    }
+    constexpr const T* Data() const
+    {
+        return m_data;
+    }
+    constexpr bool Empty() const
+    {
+        return m_size <= 0;
+    }
+
+    constexpr const T& operator [](uint32_t a_index) const
+    {
+        return m_data[a_index];
+    }
+
+    constexpr const T* begin() const
+    {
+        return m_data;
+    }
+    constexpr const T* end() const
+    {
+        return m_data + m_size;
+    }
+};
@@ -0,0 +1,301 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <shared_mutex>
+#include <tuple>
+#include <type_traits>
+
+#include "DataTypes/HeapAllocation.h"
+#include "DataTypes/TSnapshot.h"
+
+template<typename TMember>
+struct TSoAMemberType;
+template<typename TClass, typename TField>
+struct TSoAMemberType<TField TClass::*>
+{
+    using Type = TField;
+};
+
+template<auto Member>
+using TSoAColumnType = typename TSoAMemberType<decltype(Member)>::Type;
+
+// Works out which column a member lives in at compile time
+template<auto Member, auto... Members>
+constexpr uint32_t TSoAColumnIndex()
+{
+    constexpr bool Matches[] = { std::is_same_v<std::integral_constant<decltype(Member), Member>, std::integral_constant<decltype(Members), Members>>... };
+
+    for (uint32_t i = 0; i < sizeof...(Members); ++i)
+    {
+        if (Matches[i])
+        {
+            return i;
+        }
+    }
+
+    return sizeof...(Members);
+}
+
+// Immutable copy of every column for the render threads same as TSnapshot is for TArray
+template<typename T, auto... Members>
+class TSoASnapshot
+{
+private:
+    std::tuple<TSnapshot<TSoAColumnType<Members>>...> m_columns;
+    uint32_t                                          m_size;
+
+protected:
+
+public:
+    TSoASnapshot() :
+        m_size(0) { }
+    TSoASnapshot(const std::tuple<TSnapshot<TSoAColumnType<Members>>...>& a_columns, uint32_t a_size) :
+        m_columns(a_columns),
+        m_size(a_size) { }
+
+    constexpr uint32_t Size() const
+    {
+        return m_size;
+    }
+    constexpr bool Empty() const
+    {
+        return m_size <= 0;
+    }
+
+    template<auto Member>
+    inline const TSnapshot<TSoAColumnType<Member>>& Column() const
+    {
+        return std::get<TSoAColumnIndex<Member, Members...>()>(m_columns);
+    }
+
+    T Get(uint32_t a_index) const
+    {
+        T value;
+        ((value.*Members = Column<Members>()[a_index]), ...);
+
+        return value;
+    }
+};
+
+// Stores each listed member of T in its own array so a loop that only reads a couple of them is not pulling the rest through the cache
+// Every member of T needs to be listed otherwise Get will hand back the default for the missing ones
+template<typename T, auto... Members>
+class TSoAArray
+{
+public:
+    using Snapshot_t = TSoASnapshot<T, Members...>;
+
+private:
+    static constexpr uint32_t MinCapacity = 4;
+
+    std::shared_mutex                                      m_mutex;
+    uint32_t                                               m_size;
+    uint32_t                                               m_capacity;
+    std::tuple<TSoAColumnType<Members>*...>                m_columns;
+
+    uint64_t                                               m_version;
+    uint64_t                                               m_snapshotVersion;
+    std::tuple<TSnapshotData<TSoAColumnType<Members>>*...> m_snapshot;
+
+    template<typename TColumn>
+    static void ReallocateColumn(TColumn*& a_column, uint32_t a_oldCapacity, uint32_t a_capacity)
+    {
+        if (a_capacity <= 0)
+        {
+            free(a_column);
+            a_column = nullptr;
+
+            return;
+        }
+
+        TColumn* dat = (TColumn*)HeapAllocation::Realloc(a_column, a_capacity * sizeof(TColumn));
+        if (a_capacity > a_oldCapacity)
+        {
+            memset(dat + a_oldCapacity, 0, (a_capacity - a_oldCapacity) * sizeof(TColumn));
+        }
+
+        a_column = dat;
+    }
+    void Reallocate(uint32_t a_capacity)
+    {
+        if (a_capacity == m_capacity)
+        {
+            return;
+        }
+
+        std::apply([&](auto&... a_columns)
+        {
+            (ReallocateColumn(a_columns, m_capacity, a_capacity), ...);
+        }, m_columns);
+
+        m_capacity = a_capacity;
+    }
+    inline void Grow(uint32_t a_size)
+    {
+        if (a_size <= m_capacity)
+        {
+            return;
+        }
+
+        uint32_t capacity = m_capacity + (m_capacity >> 1);
+        if (capacity < MinCapacity)
+        {
+            capacity = MinCapacity;
+        }
+        if (capacity < a_size)
+        {
+            capacity = a_size;
+        }
+
+        Reallocate(capacity);
+    }
+
+    template<auto Member>
+    void RebuildColumnSnapshot()
+    {
+        TSnapshotData<TSoAColumnType<Member>>*& snapshot = std::get<TSoAColumnIndex<Member, Members...>()>(m_snapshot);
+
+        snapshot = TSnapshotData<TSoAColumnType<Member>>::Rebuild(snapshot, UColumn<Member>(), m_size, m_capacity);
+    }
+    inline Snapshot_t MakeSnapshot() const
+    {
+        return std::apply([&](auto*... a_snapshots)
+        {
+            return Snapshot_t(std::make_tuple(TSnapshot(a_snapshots)...), m_size);
+        }, m_snapshot);
+    }
+
+protected:
+
+public:
+    TSoAArray() :
+        m_size(0),
+        m_capacity(0),
+        m_version(0),
+        m_snapshotVersion(-1)
+    {
+        std::apply([](auto&... a_columns)
+        {
+            ((a_columns = nullptr), ...);
+        }, m_columns);
+        std::apply([](auto&... a_snapshots)
+        {
+            ((a_snapshots = nullptr), ...);
+        }, m_snapshot);
+    }
+    TSoAArray(const TSoAArray&) = delete;
+    ~TSoAArray()
+    {
+        std::apply([](auto*... a_snapshots)
+        {
+            ((a_snapshots != nullptr ? a_snapshots->Release() : void()), ...);
+        }, m_snapshot);
+
+        Reallocate(0);
+    }
+
+    TSoAArray& operator =(const TSoAArray&) = delete;
+
+    inline std::shared_mutex& Lock()
+    {
+        return m_mutex;
+    }
+    constexpr uint32_t Size() const
+    {
+        return m_size;
+    }
+    constexpr uint32_t Capacity() const
+    {
+        return m_capacity;
+    }
+
+    // Raw column needs the lock held and anything written through it needs a MarkDirty
+    template<auto Member>
+    constexpr TSoAColumnType<Member>* UColumn() const
+    {
+        return std::get<TSoAColumnIndex<Member, Members...>()>(m_columns);
+    }
+    inline void MarkDirty()
+    {
+        ++m_version;
+    }
+
+    T UGet(uint32_t a_index) const
+    {
+        T value;
+        ((value.*Members = UColumn<Members>()[a_index]), ...);
+
+        return value;
+    }
+    inline T Get(uint32_t a_index)
+    {
+        const std::shared_lock<std::shared_mutex> g = std::shared_lock<std::shared_mutex>(m_mutex);
+
+        return UGet(a_index);
+    }
+    inline T operator [](uint32_t a_index)
+    {
+        return Get(a_index);
+    }
+
+    void USet(uint32_t a_index, const T& a_value)
+    {
+        ++m_version;
+        ((UColumn<Members>()[a_index] = a_value.*Members), ...);
+    }
+    inline void LockSet(uint32_t a_index, const T& a_value)
+    {
+        const std::unique_lock<std::shared_mutex> g = std::unique_lock<std::shared_mutex>(m_mutex);
+
+        USet(a_index, a_value);
+    }
+
+    uint32_t UPush(const T& a_value)
+    {
+        Grow(m_size + 1);
+
+        USet(m_size, a_value);
+
+        return m_size++;
+    }
+    inline uint32_t Push(const T& a_value)
+    {
+        const std::unique_lock<std::shared_mutex> g = std::unique_lock<std::shared_mutex>(m_mutex);
+
+        return UPush(a_value);
+    }
+
+    inline void Clear()
+    {
+        const std::unique_lock<std::shared_mutex> g = std::unique_lock<std::shared_mutex>(m_mutex);
+
+        ++m_version;
+        m_size = 0;
+    }
+
+    // Only copies the columns when something has changed since the last one
+    Snapshot_t Snapshot()
+    {
+        {
+            const std::shared_lock<std::shared_mutex> g = std::shared_lock<std::shared_mutex>(m_mutex);
+
+            if (m_snapshotVersion == m_version)
+            {
+                return MakeSnapshot();
+            }
+        }
+
+        const std::unique_lock<std::shared_mutex> g = std::unique_lock<std::shared_mutex>(m_mutex);
+
+        if (m_snapshotVersion != m_version)
+        {
+            (RebuildColumnSnapshot<Members>(), ...);
+            m_snapshotVersion = m_version;
+        }
+
+        return MakeSnapshot();
+    }
+};
@@ -1,87 +1,176 @@
 #pragma once
 
+#include <cstdint>
+#include <cstdlib>
 #include <mutex>
-#include <shared_mutex>
-#include <thread>
-#include <unordered_map>
+#include <new>
+#include <utility>
+#include <vector>
 
+// One T per thread per instance
+// Every thread gets a block of slots in thread_local storage and each instance owns an index into it so looking up is just an offset with no locking or hashing
+// The only locking is the first time a thread uses an instance and when clearing or when a thread/instance goes away
 template<typename T>
 class TStatic
 {
 private:
-    std::shared_mutex                       m_mutex;
-    std::unordered_map<std::thread::id, T*> m_data;
+    static constexpr uint32_t MaxInstances = 64;
 
-protected:
+    struct Slot
+    {
+        alignas(T) unsigned char Data[sizeof(T)];
+        TStatic*                 Owner;
+        bool                     Constructed;
+    };
 
-public:
-    TStatic()
+    struct ThreadSlots
+    {
+        Slot Slots[MaxInstances];
+
+        ThreadSlots()
+        {
+            for (uint32_t i = 0; i < MaxInstances; ++i)
+            {
+                Slots[i].Owner = nullptr;
+                Slots[i].Constructed = false;
+            }
+        }
+        ~ThreadSlots()
+        {
+            // Thread is going away so need to clean up and make sure the owners do not try to touch it later
+            const std::lock_guard g = std::lock_guard(RegistryLock());
+
+            for (uint32_t i = 0; i < MaxInstances; ++i)
+            {
+                Slot& slot = Slots[i];
+                if (slot.Owner != nullptr)
+                {
+                    slot.Owner->UnregisterSlot(&slot);
+                }
+            }
+        }
+    };
+
+    static thread_local ThreadSlots ThreadData;
+
+    static std::mutex& RegistryLock()
     {
-        m_data = std::unordered_map<std::thread::id, T*>();
+        static std::mutex Lock;
+
+        return Lock;
     }
-    TStatic(const TStatic& a_other)
+    static uint64_t& UsedIndices()
     {
-        const std::unique_lock otherG = std::unique_lock(a_other.m_mutex);
-        const std::unique_lock g = std::unique_lock(m_mutex);
+        static uint64_t Indices = 0;
 
-        m_data = a_other.m_data;
+        return Indices;
     }
-    ~TStatic()
+
+    uint32_t           m_index;
+    // Slots from every thread that has used this instance
+    std::vector<Slot*> m_slots;
+
+    static inline void DestroySlot(Slot& a_slot)
     {
-        Clear();
+        if (a_slot.Constructed)
+        {
+            ((T*)a_slot.Data)->~T();
+
+            a_slot.Constructed = false;
+        }
     }
 
-    TStatic& operator =(const TStatic& a_other)
+    // Needs the registry lock
+    void UnregisterSlot(Slot* a_slot)
     {
-        const std::unique_lock otherG = std::unique_lock(a_other.m_mutex);
-        const std::unique_lock g = std::unique_lock(m_mutex);
+        DestroySlot(*a_slot);
+        a_slot->Owner = nullptr;
 
-        for (auto iter = m_data.begin(); iter != m_data.end(); ++iter)
+        const uint32_t size = (uint32_t)m_slots.size();
+        for (uint32_t i = 0; i < size; ++i)
         {
-            if (iter->second != nullptr)
+            if (m_slots[i] == a_slot)
             {
-                delete iter->second;
+                m_slots[i] = m_slots[size - 1];
+                m_slots.pop_back();
+
+                return;
             }
         }
-
-        m_data = a_other.m_data;
     }
 
-    inline T& operator*() 
+protected:
+
+public:
+    TStatic()
     {
-        const std::thread::id id = std::this_thread::get_id();
+        const std::lock_guard g = std::lock_guard(RegistryLock());
+
+        uint64_t& used = UsedIndices();
+        for (m_index = 0; m_index < MaxInstances; ++m_index)
+        {
+            if (!(used & 0b1ULL << m_index))
+            {
+                used |= 0b1ULL << m_index;
+
+                return;
+            }
+        }
 
-        const std::shared_lock g = std::shared_lock(m_mutex);
-        return *(m_data[id]);
+        // Should not be anywhere close to this many, if it happens bump MaxInstances
+        abort();
     }
-    inline T* operator->() 
+    TStatic(const TStatic&) = delete;
+    ~TStatic()
     {
-        const std::thread::id id = std::this_thread::get_id();
+        const std::lock_guard g = std::lock_guard(RegistryLock());
 
-        const std::shared_lock g = std::shared_lock(m_mutex);
-        return m_data[id];
+        for (Slot* slot : m_slots)
+        {
+            DestroySlot(*slot);
+            slot->Owner = nullptr;
+        }
+        m_slots.clear();
+
+        UsedIndices() &= ~(0b1ULL << m_index);
     }
 
-    T& Push(const T& a_data)
-    {
-        const std::thread::id id = std::this_thread::get_id();
+    TStatic& operator =(const TStatic&) = delete;
 
-        T* d = new T(a_data);
-        
-        const std::unique_lock g = std::unique_lock(m_mutex);
+    inline T& operator*()
+    {
+        return *Get();
+    }
+    inline T* operator->()
+    {
+        return Get();
+    }
 
-        auto iter = m_data.find(id);
-        if (iter != m_data.end())
+    // Constructs in the slot for the calling thread replacing anything that was already there
+    template<typename... TArgs>
+    T& Emplace(TArgs&&... a_args)
+    {
+        Slot& slot = ThreadData.Slots[m_index];
+        if (slot.Owner != this)
         {
-            delete iter->second;
-            iter->second = d;
+            const std::lock_guard g = std::lock_guard(RegistryLock());
+
+            m_slots.emplace_back(&slot);
+            slot.Owner = this;
         }
         else
         {
-            m_data.emplace(id, d);
+            DestroySlot(slot);
         }
 
-        return *d;
+        T* data = new (slot.Data) T(std::forward<TArgs>(a_args)...);
+        slot.Constructed = true;
+
+        return *data;
+    }
+    inline T& Push(const T& a_data)
+    {
+        return Emplace(a_data);
     }
 
     inline bool Exists()
@@ -89,43 +178,38 @@ public:
         return Get() != nullptr;
     }
 
-    T* Get()
+    inline T* Get()
     {
-        const std::thread::id id = std::this_thread::get_id();
-
-        const std::shared_lock g = std::shared_lock(m_mutex);
-        const auto iter = m_data.find(id);
-        if (iter != m_data.end())
+        Slot& slot = ThreadData.Slots[m_index];
+        if (slot.Owner != this || !slot.Constructed)
         {
-            return iter->second;
+            return nullptr;
         }
 
-        return nullptr;
+        return (T*)slot.Data;
     }
 
     void Erase()
     {
-        const std::thread::id id = std::this_thread::get_id();
-
-        const std::unique_lock g = std::unique_lock(m_mutex);
-        auto iter = m_data.find(id);
-        if (iter != m_data.end())
+        Slot& slot = ThreadData.Slots[m_index];
+        if (slot.Owner == this)
         {
-            delete iter->second;
-
-            m_data.erase(iter);
+            DestroySlot(slot);
         }
     }
 
+    // Destroys the value on every thread but keeps the slots so the next Emplace does not need to lock
+    // Not safe to call while other threads are still using their values
     void Clear()
     {
-        const std::unique_lock g = std::unique_lock(m_mutex);
+        const std::lock_guard g = std::lock_guard(RegistryLock());
 
-        for (auto iter = m_data.begin(); iter != m_data.end(); ++iter)
+        for (Slot* slot : m_slots)
         {
-            delete iter->second;
+            DestroySlot(*slot);
         }
-
-        m_data.clear();
     }
-};
\ No newline at end of file
+};
+
+template<typename T>
+thread_local typename TStatic<T>::ThreadSlots TStatic<T>::ThreadData;
@@ -1,15 +1,178 @@
 #pragma once
 
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
 #include <mutex>
 #include <shared_mutex>
-#include <unordered_map>
+#include <string>
+#include <string_view>
 
-template<typename TKey, typename TValue>
+#include "DataTypes/HeapAllocation.h"
+
+// Hashes anything that can be compared against the key
+// Strings hash through string_view so lookups with a string_view or char* do not have to build a std::string first
+// Same values as std::hash<std::string> anyway
+template<typename TKey>
+struct TUMapHash
+{
+    inline size_t operator()(const TKey& a_key) const
+    {
+        return std::hash<TKey>()(a_key);
+    }
+};
+template<>
+struct TUMapHash<std::string>
+{
+    inline size_t operator()(const std::string_view& a_key) const
+    {
+        return std::hash<std::string_view>()(a_key);
+    }
+};
+
+// Split into shards each with their own lock so threads working on different keys do not end up waiting on each other
+// Could not use std::unordered_map for the shards as it only gets heterogeneous lookup in C++20
+template<typename TKey, typename TValue, uint32_t ShardCount = 16, typename THash = TUMapHash<TKey>>
 class TUMap
 {
 private:
-    std::shared_mutex                m_mutex;
-    std::unordered_map<TKey, TValue> m_map;
+    static_assert((ShardCount & (ShardCount - 1)) == 0, "TUMap ShardCount must be a power of 2");
+
+    static constexpr uint32_t MinBucketCount = 8;
+
+    struct Node
+    {
+        TKey   Key;
+        TValue Value;
+        size_t Hash;
+        Node*  Next;
+    };
+
+    // Own cache line so the locks are not fighting over the same one
+    struct alignas(64) Shard
+    {
+        mutable std::shared_mutex Mutex;
+        Node**                    Buckets = nullptr;
+        uint32_t                  BucketCount = 0;
+        uint32_t                  Count = 0;
+    };
+
+    Shard m_shards[ShardCount];
+
+    // Mixing so hashes that only use the low bits like ints still spread over the shards
+    static constexpr uint32_t ShardIndex(size_t a_hash)
+    {
+        return (uint32_t)(((uint64_t)a_hash * 0x9E3779B97F4A7C15ULL) >> 32) & (ShardCount - 1);
+    }
+
+    template<typename TLookup>
+    static Node* FindNode(const Shard& a_shard, const TLookup& a_key, size_t a_hash)
+    {
+        if (a_shard.BucketCount <= 0)
+        {
+            return nullptr;
+        }
+
+        Node* node = a_shard.Buckets[a_hash & (a_shard.BucketCount - 1)];
+        while (node != nullptr)
+        {
+            if (node->Hash == a_hash && node->Key == a_key)
+            {
+                return node;
+            }
+
+            node = node->Next;
+        }
+
+        return nullptr;
+    }
+
+    static void Rehash(Shard& a_shard, uint32_t a_bucketCount)
+    {
+        Node** buckets = (Node**)HeapAllocation::Malloc(sizeof(Node*) * a_bucketCount);
+        memset(buckets, 0, sizeof(Node*) * a_bucketCount);
+
+        for (uint32_t i = 0; i < a_shard.BucketCount; ++i)
+        {
+            Node* node = a_shard.Buckets[i];
+            while (node != nullptr)
+            {
+                Node* next = node->Next;
+
+                Node*& bucket = buckets[node->Hash & (a_bucketCount - 1)];
+                node->Next = bucket;
+                bucket = node;
+
+                node = next;
+            }
+        }
+
+        if (a_shard.Buckets != nullptr)
+        {
+            free(a_shard.Buckets);
+        }
+
+        a_shard.Buckets = buckets;
+        a_shard.BucketCount = a_bucketCount;
+    }
+
+    // Needs the shard lock
+    static Node* InsertNode(Shard& a_shard, const TKey& a_key, const TValue& a_value, size_t a_hash)
+    {
+        if (a_shard.Count >= a_shard.BucketCount)
+        {
+            Rehash(a_shard, a_shard.BucketCount > 0 ? a_shard.BucketCount * 2 : MinBucketCount);
+        }
+
+        Node*& bucket = a_shard.Buckets[a_hash & (a_shard.BucketCount - 1)];
+        Node* node = new Node{ a_key, a_value, a_hash, bucket };
+        bucket = node;
+
+        ++a_shard.Count;
+
+        return node;
+    }
+
+    static void ClearShard(Shard& a_shard)
+    {
+        for (uint32_t i = 0; i < a_shard.BucketCount; ++i)
+        {
+            Node* node = a_shard.Buckets[i];
+            while (node != nullptr)
+            {
+                Node* next = node->Next;
+                delete node;
+                node = next;
+            }
+
+            a_shard.Buckets[i] = nullptr;
+        }
+
+        a_shard.Count = 0;
+    }
+
+    void Copy(const TUMap& a_other)
+    {
+        for (uint32_t i = 0; i < ShardCount; ++i)
+        {
+            Shard& shard = m_shards[i];
+            const Shard& otherShard = a_other.m_shards[i];
+
+            const std::unique_lock g = std::unique_lock(shard.Mutex);
+            const std::shared_lock otherG = std::shared_lock(otherShard.Mutex);
+
+            ClearShard(shard);
+
+            for (uint32_t j = 0; j < otherShard.BucketCount; ++j)
+            {
+                for (const Node* node = otherShard.Buckets[j]; node != nullptr; node = node->Next)
+                {
+                    InsertNode(shard, node->Key, node->Value, node->Hash);
+                }
+            }
+        }
+    }
 
 protected:
 
@@ -20,58 +183,164 @@ public:
     }
     TUMap(const TUMap& a_other)
     {
-        const std::unique_lock g = std::unique_lock(m_mutex);
-        const std::unique_lock otherG = std::unique_lock(a_other.m_mutex);
-        
-        m_map = a_other.m_map;
+        Copy(a_other);
     }
     ~TUMap()
     {
+        for (uint32_t i = 0; i < ShardCount; ++i)
+        {
+            Shard& shard = m_shards[i];
 
+            ClearShard(shard);
+
+            if (shard.Buckets != nullptr)
+            {
+                free(shard.Buckets);
+            }
+        }
     }
 
     TUMap& operator =(const TUMap& a_other)
     {
-        const std::unique_lock g = std::unique_lock(m_mutex);
-        const std::unique_lock otherG = std::unique_lock(a_other.m_mutex);
-
-        m_map = a_other.m_map;
+        if (this != &a_other)
+        {
+            Copy(a_other);
+        }
 
         return *this;
     }
 
     void Push(const TKey& a_key, const TValue& a_value)
     {
-        const std::unique_lock g = std::unique_lock(m_mutex);
+        const size_t hash = THash()(a_key);
+        Shard& shard = m_shards[ShardIndex(hash)];
+
+        const std::unique_lock g = std::unique_lock(shard.Mutex);
 
-        const auto iter = m_map.find(a_key);
-        if (iter != m_map.end())
+        Node* node = FindNode(shard, a_key, hash);
+        if (node != nullptr)
         {
-            iter->second = a_value;
+            node->Value = a_value;
 
             return;
         }
 
-        m_map.emplace(a_key, a_value);
+        InsertNode(shard, a_key, a_value, hash);
     }
 
-    inline bool Exists(const TKey& a_key)
+    template<typename TLookup>
+    bool Erase(const TLookup& a_key)
     {
-        const std::shared_lock g = std::shared_lock(m_mutex);
+        const size_t hash = THash()(a_key);
+        Shard& shard = m_shards[ShardIndex(hash)];
+
+        const std::unique_lock g = std::unique_lock(shard.Mutex);
 
-        return m_map.find(a_key) != m_map.end(); 
+        if (shard.BucketCount <= 0)
+        {
+            return false;
+        }
+
+        Node** link = &shard.Buckets[hash & (shard.BucketCount - 1)];
+        while (*link != nullptr)
+        {
+            Node* node = *link;
+            if (node->Hash == hash && node->Key == a_key)
+            {
+                *link = node->Next;
+                delete node;
+
+                --shard.Count;
+
+                return true;
+            }
+
+            link = &node->Next;
+        }
+
+        return false;
     }
-    inline void Clear()
+
+    template<typename TLookup>
+    inline bool Exists(const TLookup& a_key) const
     {
-        const std::unique_lock g = std::unique_lock(m_mutex);
+        const size_t hash = THash()(a_key);
+        const Shard& shard = m_shards[ShardIndex(hash)];
+
+        const std::shared_lock g = std::shared_lock(shard.Mutex);
 
-        m_map.clear();
+        return FindNode(shard, a_key, hash) != nullptr;
     }
 
-    inline TValue& operator [](const TKey& a_key)
+    // Single lookup instead of Exists then operator[]
+    // Copies out under the lock so the value cannot change underneath the caller
+    template<typename TLookup>
+    bool TryGet(const TLookup& a_key, TValue* a_value) const
     {
-        const std::shared_lock g = std::shared_lock(m_mutex);
+        const size_t hash = THash()(a_key);
+        const Shard& shard = m_shards[ShardIndex(hash)];
+
+        const std::shared_lock g = std::shared_lock(shard.Mutex);
+
+        const Node* node = FindNode(shard, a_key, hash);
+        if (node == nullptr)
+        {
+            return false;
+        }
+
+        *a_value = node->Value;
+
+        return true;
+    }
+
+    uint32_t Size() const
+    {
+        uint32_t size = 0;
+        for (uint32_t i = 0; i < ShardCount; ++i)
+        {
+            const std::shared_lock g = std::shared_lock(m_shards[i].Mutex);
+
+            size += m_shards[i].Count;
+        }
+
+        return size;
+    }
+
+    void Clear()
+    {
+        for (uint32_t i = 0; i < ShardCount; ++i)
+        {
+            const std::unique_lock g = std::unique_lock(m_shards[i].Mutex);
+
+            ClearShard(m_shards[i]);
+        }
+    }
+
+    // Nodes do not move so the reference stays good until the key is erased or the map is cleared
+    TValue& operator [](const TKey& a_key)
+    {
+        const size_t hash = THash()(a_key);
+        Shard& shard = m_shards[ShardIndex(hash)];
+
+        {
+            const std::shared_lock g = std::shared_lock(shard.Mutex);
+
+            Node* node = FindNode(shard, a_key, hash);
+            if (node != nullptr)
+            {
+                return node->Value;
+            }
+        }
+
+        const std::unique_lock g = std::unique_lock(shard.Mutex);
+
+        // Someone else may have got in between the locks
+        Node* node = FindNode(shard, a_key, hash);
+        if (node == nullptr)
+        {
+            node = InsertNode(shard, a_key, TValue(), hash);
+        }
 
-        return m_map[a_key];
+        return node->Value;
     }
-};
\ No newline at end of file
+};
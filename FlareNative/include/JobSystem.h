@@ -0,0 +1,146 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class RuntimeManager;
+
+// Goes up when jobs get handed out and back down as they finish so it can be waited on like a fence
+class JobCounter
+{
+private:
+    friend class JobSystem;
+
+    std::atomic<uint32_t> m_count;
+
+protected:
+
+public:
+    JobCounter() :
+        m_count(0)
+    {
+
+    }
+    JobCounter(const JobCounter&) = delete;
+
+    JobCounter& operator =(const JobCounter&) = delete;
+
+    inline bool Done() const
+    {
+        return m_count.load(std::memory_order_acquire) <= 0;
+    }
+};
+
+// Fixed set of worker threads that live for the whole app so nothing has to spin up threads or attach to mono per frame
+// Each worker has its own queue and steals off the others when it runs dry, anything not on a worker goes into a shared queue
+// Waiting on a counter runs jobs instead of blocking so jobs can hand out and wait on more jobs
+// Only jobs for the counter being waited on get picked up so nothing else runs in the middle of whatever the waiting thread was doing
+class JobSystem
+{
+private:
+    using TaskFunc = void (*)(void* a_data, uint32_t a_start, uint32_t a_end);
+
+    struct Job
+    {
+        TaskFunc    Func;
+        void*       Data;
+        uint32_t    Start;
+        uint32_t    End;
+        JobCounter* Counter;
+    };
+
+    // Owner takes from the back to keep working on what it just pushed while it is warm, thieves take from the front
+    // Lock only gets fought over when someone is stealing
+    struct JobQueue
+    {
+        std::mutex       Lock;
+        std::vector<Job> Jobs;
+        uint32_t         Head;
+        uint32_t         Count;
+    };
+
+    RuntimeManager*          m_runtime;
+
+    std::vector<std::thread> m_threads;
+    // One per worker with the shared queue on the end
+    JobQueue*                m_queues;
+    uint32_t                 m_queueCount;
+
+    std::mutex               m_mutex;
+    std::condition_variable  m_signal;
+    std::atomic<int32_t>     m_pending;
+    bool                     m_shutdown;
+
+    uint32_t GetQueueIndex() const;
+
+    void Push(uint32_t a_queue, const Job* a_jobs, uint32_t a_count);
+    bool Pop(uint32_t a_queue, Job* a_job);
+    bool Steal(uint32_t a_queue, Job* a_job);
+    bool Take(uint32_t a_queue, const JobCounter* a_counter, Job* a_job);
+
+    void Execute(const Job& a_job);
+    bool RunJob(uint32_t a_queue);
+
+    void WorkerLoop(uint32_t a_index);
+
+    void Dispatch(JobCounter* a_counter, uint32_t a_count, uint32_t a_grainSize, TaskFunc a_task, void* a_data);
+
+protected:
+
+public:
+    // 0 uses one less than the number of cores as the waiting thread joins in
+    explicit JobSystem(RuntimeManager* a_runtime, uint32_t a_threadCount = 0);
+    JobSystem(const JobSystem&) = delete;
+    ~JobSystem();
+
+    JobSystem& operator =(const JobSystem&) = delete;
+
+    // Joins the workers, needs to happen before the runtime goes as they are attached to it
+    // Anything run after this gets done by whoever waits on it
+    void Shutdown();
+
+    inline uint32_t GetThreadCount() const
+    {
+        return (uint32_t)m_threads.size() + 1;
+    }
+
+    // Splits [0, count) into jobs of at most grain size and returns straight away, the counter drops to 0 once they are all done
+    // The function only gets referenced so it needs to stay alive until the counter has been waited on
+    template<typename TFunc>
+    void Run(JobCounter* a_counter, uint32_t a_count, uint32_t a_grainSize, const TFunc& a_func)
+    {
+        Dispatch(a_counter, a_count, a_grainSize, [](void* a_data, uint32_t a_start, uint32_t a_end)
+        {
+            (*(const TFunc*)a_data)(a_start, a_end);
+        }, (void*)&a_func);
+    }
+
+    // Works through the counters jobs until it is done, only sleeps once the rest are running on other threads
+    void Wait(JobCounter* a_counter);
+
+    // Calls the function with [start, end) ranges of at most grain size until the whole count is covered
+    // Anything smaller than a single grain just runs on the calling thread without waking anyone
+    // Safe to call from inside a job
+    template<typename TFunc>
+    void ParallelFor(uint32_t a_count, uint32_t a_grainSize, const TFunc& a_func)
+    {
+        if (a_count <= a_grainSize || m_threads.empty())
+        {
+            if (a_count > 0)
+            {
+                a_func(0, a_count);
+            }
+
+            return;
+        }
+
+        JobCounter counter;
+        Run(&counter, a_count, a_grainSize, a_func);
+
+        Wait(&counter);
+    }
+};
\ No newline at end of file
@@ -0,0 +1,179 @@
+#pragma once
+
+#define GLM_FORCE_SWIZZLE 
+#include <glm/glm.hpp>
+
+#include <cfloat>
+
+struct AABB
+{
+    glm::vec3 Min;
+    glm::vec3 Max;
+
+    constexpr AABB(const glm::vec3& a_min = glm::vec3(FLT_MAX), const glm::vec3& a_max = glm::vec3(-FLT_MAX)) :
+        Min(a_min),
+        Max(a_max)
+    {
+
+    }
+
+    constexpr bool Valid() const
+    {
+        return Min.x <= Max.x && Min.y <= Max.y && Min.z <= Max.z;
+    }
+
+    inline glm::vec3 Center() const
+    {
+        return (Min + Max) * 0.5f;
+    }
+    inline glm::vec3 Extents() const
+    {
+        return (Max - Min) * 0.5f;
+    }
+    inline float SurfaceArea() const
+    {
+        const glm::vec3 size = Max - Min;
+
+        return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+    }
+
+    inline AABB Expanded(float a_margin) const
+    {
+        return AABB(Min - a_margin, Max + a_margin);
+    }
+
+    inline bool Contains(const AABB& a_other) const
+    {
+        return a_other.Min.x >= Min.x && a_other.Min.y >= Min.y && a_other.Min.z >= Min.z &&
+               a_other.Max.x <= Max.x && a_other.Max.y <= Max.y && a_other.Max.z <= Max.z;
+    }
+    inline bool Overlaps(const AABB& a_other) const
+    {
+        return a_other.Min.x <= Max.x && a_other.Max.x >= Min.x &&
+               a_other.Min.y <= Max.y && a_other.Max.y >= Min.y &&
+               a_other.Min.z <= Max.z && a_other.Max.z >= Min.z;
+    }
+
+    inline void Encapsulate(const glm::vec3& a_point)
+    {
+        Min = glm::min(Min, a_point);
+        Max = glm::max(Max, a_point);
+    }
+
+    static inline AABB Union(const AABB& a_lhs, const AABB& a_rhs)
+    {
+        return AABB(glm::min(a_lhs.Min, a_rhs.Min), glm::max(a_lhs.Max, a_rhs.Max));
+    }
+
+    // Box around the box after it has been transformed, goes off the center and extents so there is no need to transform all 8 corners
+    AABB Transformed(const glm::mat4& a_transform) const
+    {
+        const glm::vec3 center = glm::vec3(a_transform * glm::vec4(Center(), 1.0f));
+        const glm::vec3 extents = Extents();
+
+        const glm::vec3 worldExtents = glm::abs(glm::vec3(a_transform[0])) * extents.x +
+                                       glm::abs(glm::vec3(a_transform[1])) * extents.y +
+                                       glm::abs(glm::vec3(a_transform[2])) * extents.z;
+
+        return AABB(center - worldExtents, center + worldExtents);
+    }
+};
+
+struct BoundingSphere
+{
+    glm::vec3 Center;
+    float     Radius;
+
+    inline bool Overlaps(const AABB& a_box) const
+    {
+        const glm::vec3 closest = glm::clamp(Center, a_box.Min, a_box.Max);
+        const glm::vec3 diff = closest - Center;
+
+        return glm::dot(diff, diff) <= Radius * Radius;
+    }
+};
+
+struct Ray
+{
+    glm::vec3 Origin;
+    glm::vec3 Direction;
+
+    // Slab test, gives back where it enters the box or 0 if it starts inside
+    bool Intersects(const AABB& a_box, float a_maxDistance, float* a_distance) const
+    {
+        const glm::vec3 invDir = 1.0f / Direction;
+
+        const glm::vec3 t0 = (a_box.Min - Origin) * invDir;
+        const glm::vec3 t1 = (a_box.Max - Origin) * invDir;
+
+        const glm::vec3 tMin = glm::min(t0, t1);
+        const glm::vec3 tMax = glm::max(t0, t1);
+
+        const float enter = glm::max(glm::max(tMin.x, tMin.y), glm::max(tMin.z, 0.0f));
+        const float exit = glm::min(glm::min(tMax.x, tMax.y), glm::min(tMax.z, a_maxDistance));
+
+        if (enter > exit)
+        {
+            return false;
+        }
+
+        if (a_distance != nullptr)
+        {
+            *a_distance = enter;
+        }
+
+        return true;
+    }
+};
+
+struct Frustum
+{
+    // xyz is the normal pointing in and w is the distance
+    glm::vec4 Planes[6];
+
+    // Pulls the planes out of a view projection matrix, expects 0 to 1 depth
+    static Frustum FromMatrix(const glm::mat4& a_viewProj)
+    {
+        const glm::vec4 row0 = glm::vec4(a_viewProj[0][0], a_viewProj[1][0], a_viewProj[2][0], a_viewProj[3][0]);
+        const glm::vec4 row1 = glm::vec4(a_viewProj[0][1], a_viewProj[1][1], a_viewProj[2][1], a_viewProj[3][1]);
+        const glm::vec4 row2 = glm::vec4(a_viewProj[0][2], a_viewProj[1][2], a_viewProj[2][2], a_viewProj[3][2]);
+        const glm::vec4 row3 = glm::vec4(a_viewProj[0][3], a_viewProj[1][3], a_viewProj[2][3], a_viewProj[3][3]);
+
+        Frustum frustum;
+        frustum.Planes[0] = row3 + row0;
+        frustum.Planes[1] = row3 - row0;
+        frustum.Planes[2] = row3 + row1;
+        frustum.Planes[3] = row3 - row1;
+        frustum.Planes[4] = row2;
+        frustum.Planes[5] = row3 - row2;
+
+        for (glm::vec4& plane : frustum.Planes)
+        {
+            plane /= glm::length(glm::vec3(plane));
+        }
+
+        return frustum;
+    }
+
+    // Can give back true for boxes just outside near the corners but never false for anything that is visible
+    inline bool Overlaps(const AABB& a_box) const
+    {
+        const glm::vec3 center = a_box.Center();
+        const glm::vec3 extents = a_box.Extents();
+
+        for (const glm::vec4& plane : Planes)
+        {
+            const glm::vec3 normal = glm::vec3(plane);
+
+            const float distance = glm::dot(normal, center) + plane.w;
+            const float radius = glm::dot(extents, glm::abs(normal));
+
+            if (distance + radius < 0.0f)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+};
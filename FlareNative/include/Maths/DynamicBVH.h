@@ -0,0 +1,183 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Flare/FlareAssert.h"
+#include "Maths/Bounds.h"
+
+// Tree of boxes that can have things added, removed and moved about without rebuilding
+// Leaves store a box a bit bigger than what was given so small movements do not need to touch the tree
+// Not thread safe, whatever owns it needs to lock around it
+class DynamicBVH
+{
+public:
+    static constexpr uint32_t Null = -1;
+
+private:
+    // Deep enough for any tree that stays balanced
+    static constexpr uint32_t StackSize = 256;
+
+    struct Node
+    {
+        AABB     Box;
+        // Next free node when on the free list
+        uint32_t Parent;
+        uint32_t Child1;
+        uint32_t Child2;
+        // 0 for leaves and -1 for free nodes
+        int32_t  Height;
+        uint32_t UserData;
+
+        constexpr bool IsLeaf() const
+        {
+            return Child1 == Null;
+        }
+    };
+
+    std::vector<Node> m_nodes;
+
+    uint32_t          m_root;
+    uint32_t          m_freeList;
+    uint32_t          m_proxyCount;
+
+    float             m_margin;
+
+    uint32_t AllocateNode();
+    void FreeNode(uint32_t a_node);
+
+    void InsertLeaf(uint32_t a_leaf);
+    void RemoveLeaf(uint32_t a_leaf);
+
+    uint32_t Balance(uint32_t a_node);
+
+    // Calls the function with the user data of every leaf the test passes for, returning false from the function stops early
+    template<typename TTest, typename TFunc>
+    void Traverse(const TTest& a_test, const TFunc& a_func) const
+    {
+        if (m_root == Null)
+        {
+            return;
+        }
+
+        uint32_t stack[StackSize];
+        uint32_t count = 0;
+
+        stack[count++] = m_root;
+
+        while (count > 0)
+        {
+            const Node& node = m_nodes[stack[--count]];
+            if (!a_test(node.Box))
+            {
+                continue;
+            }
+
+            if (node.IsLeaf())
+            {
+                if (!a_func(node.UserData))
+                {
+                    return;
+                }
+
+                continue;
+            }
+
+            FLARE_ASSERT_MSG(count + 2 <= StackSize, "DynamicBVH too deep");
+
+            stack[count++] = node.Child1;
+            stack[count++] = node.Child2;
+        }
+    }
+
+protected:
+
+public:
+    explicit DynamicBVH(float a_margin = 0.1f);
+    ~DynamicBVH();
+
+    uint32_t CreateProxy(const AABB& a_box, uint32_t a_userData);
+    void DestroyProxy(uint32_t a_proxy);
+    // Returns true if the proxy had to be put back in the tree because it left its fat box
+    bool MoveProxy(uint32_t a_proxy, const AABB& a_box);
+
+    inline const AABB& GetFatAABB(uint32_t a_proxy) const
+    {
+        return m_nodes[a_proxy].Box;
+    }
+    inline uint32_t GetUserData(uint32_t a_proxy) const
+    {
+        return m_nodes[a_proxy].UserData;
+    }
+
+    inline uint32_t GetProxyCount() const
+    {
+        return m_proxyCount;
+    }
+    inline uint32_t GetHeight() const
+    {
+        return m_root != Null ? (uint32_t)m_nodes[m_root].Height : 0;
+    }
+
+    // These go off the fat boxes so can give back things slightly outside of what was asked for
+    template<typename TFunc>
+    inline void Query(const AABB& a_box, const TFunc& a_func) const
+    {
+        Traverse([&](const AABB& a_nodeBox) { return a_nodeBox.Overlaps(a_box); }, a_func);
+    }
+    template<typename TFunc>
+    inline void Query(const BoundingSphere& a_sphere, const TFunc& a_func) const
+    {
+        Traverse([&](const AABB& a_nodeBox) { return a_sphere.Overlaps(a_nodeBox); }, a_func);
+    }
+    template<typename TFunc>
+    inline void Query(const Frustum& a_frustum, const TFunc& a_func) const
+    {
+        Traverse([&](const AABB& a_nodeBox) { return a_frustum.Overlaps(a_nodeBox); }, a_func);
+    }
+
+    // Function gets the user data and the distance to the leaf box and gives back how far the ray should keep going
+    // Returning the distance it was given makes it only look for closer hits and returning 0 stops it
+    template<typename TFunc>
+    void RayCast(const Ray& a_ray, float a_maxDistance, const TFunc& a_func) const
+    {
+        if (m_root == Null)
+        {
+            return;
+        }
+
+        float maxDistance = a_maxDistance;
+
+        uint32_t stack[StackSize];
+        uint32_t count = 0;
+
+        stack[count++] = m_root;
+
+        while (count > 0)
+        {
+            const Node& node = m_nodes[stack[--count]];
+
+            float distance;
+            if (!a_ray.Intersects(node.Box, maxDistance, &distance))
+            {
+                continue;
+            }
+
+            if (node.IsLeaf())
+            {
+                maxDistance = a_func(node.UserData, distance);
+                if (maxDistance <= 0.0f)
+                {
+                    return;
+                }
+
+                continue;
+            }
+
+            FLARE_ASSERT_MSG(count + 2 <= StackSize, "DynamicBVH too deep");
+
+            stack[count++] = node.Child1;
+            stack[count++] = node.Child2;
+        }
+    }
+};
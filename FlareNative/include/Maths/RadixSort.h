@@ -0,0 +1,8 @@
+#pragma once
+
+#include <cstdint>
+
+// Sorts 64 bit keys with a value carried along with each one, least significant byte first so it is stable
+// Any byte that is the same for every key gets skipped so keys that only use a few bits only pay for those
+// Temp buffers need to be at least count long, the result always ends up back in the keys and values
+void RadixSort(uint64_t* a_keys, uint32_t* a_values, uint64_t* a_tempKeys, uint32_t* a_tempValues, uint32_t a_count);
\ No newline at end of file
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+
+// Builds translation * rotation * scale matrices for a batch of transforms along with their inverses
+// Works on plain floats laid out the same as glm so it can be fed straight from glm arrays
+// Translations and scales are 3 floats each, rotations are quaternions stored xyzw and the matrices are column major 4x4
+// Inverse is worked out from the parts so it is only a few multiplies instead of a full glm::inverse
+// Picks SSE or AVX2 the first time it is used depending on what the CPU has and falls back to scalar on anything else
+class TransformKernel
+{
+private:
+    using ComposeFunc = void (*)(const float* a_translations, const float* a_rotations, const float* a_scales, uint32_t a_count, float* a_matrices, float* a_inverses);
+
+    static ComposeFunc SelectCompose();
+
+protected:
+
+public:
+    TransformKernel() = delete;
+
+    // Inverses can be null if they are not wanted
+    static void ComposeTRS(const float* a_translations, const float* a_rotations, const float* a_scales, uint32_t a_count, float* a_matrices, float* a_inverses);
+
+    // Skips the dispatch, mostly here so the paths can be compared against each other
+    static void ComposeTRSScalar(const float* a_translations, const float* a_rotations, const float* a_scales, uint32_t a_count, float* a_matrices, float* a_inverses);
+    static bool ComposeTRSSSE(const float* a_translations, const float* a_rotations, const float* a_scales, uint32_t a_count, float* a_matrices, float* a_inverses);
+    static bool ComposeTRSAVX2(const float* a_translations, const float* a_rotations, const float* a_scales, uint32_t a_count, float* a_matrices, float* a_inverses);
+
+    // Name of the path ComposeTRS ends up using
+    static const char* GetPathName();
+};
@@ -5,35 +5,15 @@
 
 #include <glm/gtc/quaternion.hpp>
 #include <glm/gtx/quaternion.hpp>
+#include <mutex>
 #include <queue>
 #include <vector>
 
 #include "DataTypes/TArray.h"
 
+class JobSystem;
 class RuntimeManager;
 
-struct TransformBuffer;
-
-class ObjectManager
-{
-private:
-    std::queue<uint32_t>    m_freeTransforms;
-    TArray<TransformBuffer> m_transformBuffer;
-
-protected:
-
-public:
-    ObjectManager(RuntimeManager* a_runtime);
-    ~ObjectManager();
-
-    uint32_t CreateTransformBuffer();
-    TransformBuffer GetTransformBuffer(uint32_t a_addr);
-    void SetTransformBuffer(uint32_t a_addr, const TransformBuffer& a_buffer);
-    void DestroyTransformBuffer(uint32_t a_addr);
-
-    glm::mat4 GetGlobalMatrix(uint32_t a_addr);
-};
-
 struct TransformBuffer
 {
     uint32_t  Parent;
@@ -63,16 +43,192 @@ struct TransformBuffer
 
         return translation * rotation * scale;
     }
+};
+
+// Needs to match Transform.cs
+static constexpr uint32_t TransformPageSize = 1024;
+static constexpr uint32_t TransformPageDirtyWords = TransformPageSize / 64;
 
-    glm::mat4 ToGlobalMat4(ObjectManager* a_objectManager) const
+// Transforms live in pages that never move so C# can hold onto a pointer and read or write without calling into native
+struct TransformPage
+{
+    TransformBuffer Buffers[TransformPageSize];
+    // C# sets the bit after writing through the pointer and it gets picked up on the next update
+    uint64_t        DirtyBits[TransformPageDirtyWords];
+};
+
+class ObjectManager
+{
+private:
+    // Hierarchy kept as links so marking a subtree dirty does not need to allocate or search
+    struct TransformNode
     {
-        if (Parent != -1)
+        glm::mat4 Local;
+        glm::mat4 InvLocal;
+        // Address C# holds for this slot, -1 when the slot is a hole
+        uint32_t  Handle;
+        // Links are slots not addresses
+        uint32_t  Parent;
+        uint32_t  FirstChild;
+        uint32_t  NextSibling;
+        uint32_t  PrevSibling;
+        // Where it sits in the level lists
+        uint32_t  Depth;
+        uint32_t  LevelIndex;
+        bool      LocalDirty;
+        // Anything dirty has everything under it dirty as well
+        bool      WorldDirty;
+        // In m_dirtyTransforms so it does not get added twice
+        bool      Queued;
+    };
+
+    // Everything transform related goes through the transform lock
+    // Except C# writing through the page pointers, that happens on the update thread which is the only one that picks the dirty bits up
+    std::mutex                 m_transformLock;
+
+    // Addresses are what C# and the renderer hold and never change, the pages are indexed by address
+    std::queue<uint32_t>       m_freeTransforms;
+    std::vector<TransformPage*> m_transformPages;
+    uint32_t                   m_transformCount;
+
+    // Everything worked out per frame lives in slots that are kept packed so iterating them does not go through dead memory
+    // Address to slot goes through m_transformSlots and destroying leaves a hole that compaction fills from the end a few at a time
+    TArray<uint32_t>           m_transformSlots;
+    std::vector<uint32_t>      m_freeSlots;
+    uint32_t                   m_liveCount;
+    uint32_t                   m_compactionMoves;
+
+    std::vector<TransformNode> m_transformNodes;
+    std::vector<uint32_t>      m_dirtyTransforms;
+    // Addresses whose world matrix changed in the last update
+    std::vector<uint32_t>      m_movedTransforms;
+
+    JobSystem*                 m_jobSystem;
+
+    // Every transform sorted by how deep it is, kept up to date as parents change so each level can be done in parallel after the one above it
+    std::vector<std::vector<uint32_t>> m_levels;
+    std::vector<std::vector<uint32_t>> m_dirtyLevels;
+
+    // Dirty transforms get packed into these so the local matrices can be built in batches
+    std::vector<uint32_t>      m_composeSlots;
+    std::vector<glm::vec3>     m_composeTranslations;
+    std::vector<glm::quat>     m_composeRotations;
+    std::vector<glm::vec3>     m_composeScales;
+    std::vector<glm::mat4>     m_composeMatrices;
+    std::vector<glm::mat4>     m_composeInverses;
+
+    TArray<glm::mat4>          m_worldMatrices;
+    TArray<glm::mat4>          m_worldInverses;
+
+    // Walks the address and everything under it parents first using the links instead of recursing
+    // Returning false from the function skips everything under that node
+    template<typename TFunc>
+    void UWalkSubtree(uint32_t a_addr, const TFunc& a_func)
+    {
+        const TransformNode* nodes = m_transformNodes.data();
+
+        uint32_t cur = a_addr;
+        while (true)
         {
-            const TransformBuffer buffer = a_objectManager->GetTransformBuffer(Parent);
+            if (a_func(cur) && nodes[cur].FirstChild != -1)
+            {
+                cur = nodes[cur].FirstChild;
 
-            return buffer.ToGlobalMat4(a_objectManager) * ToMat4();
+                continue;
+            }
+
+            while (cur != a_addr && nodes[cur].NextSibling == -1)
+            {
+                cur = nodes[cur].Parent;
+            }
+
+            if (cur == a_addr)
+            {
+                return;
+            }
+
+            cur = nodes[cur].NextSibling;
         }
+    }
 
-        return ToMat4();
+    inline TransformBuffer& UGetTransformBuffer(uint32_t a_addr)
+    {
+        return m_transformPages[a_addr / TransformPageSize]->Buffers[a_addr % TransformPageSize];
     }
-};
\ No newline at end of file
+
+    bool UTakeDirtyBit(uint32_t a_addr);
+    void UConsumeDirtyBits();
+
+    void UUnlinkTransform(uint32_t a_slot);
+    void ULinkTransform(uint32_t a_slot, uint32_t a_parent);
+    void UAddToLevel(uint32_t a_slot, uint32_t a_depth);
+    void URemoveFromLevel(uint32_t a_slot);
+    void USetSubtreeDepth(uint32_t a_slot, uint32_t a_depth);
+    void UMarkWorldDirty(uint32_t a_slot);
+    void UComposeLocalMatrices(uint32_t a_start, uint32_t a_end);
+    void UResolveLevelNode(uint32_t a_slot, glm::mat4* a_worldMatrices, glm::mat4* a_worldInverses);
+    const glm::mat4& UResolveWorldMatrix(uint32_t a_slot, TLockArray<glm::mat4>& a_worldMatrices, TLockArray<glm::mat4>& a_worldInverses);
+    void UResolveDirty(uint32_t a_dirtyCount);
+
+    void UMoveSlot(uint32_t a_from, uint32_t a_to);
+    void UTrimSlots();
+    void UCompact(uint32_t a_maxMoves);
+
+protected:
+
+public:
+    struct TransformStats
+    {
+        // Addresses handed out including ones waiting to be reused
+        uint32_t Addresses;
+        uint32_t Live;
+        // Slots in use including holes, Holes / Slots is how fragmented it is
+        uint32_t Slots;
+        uint32_t Holes;
+        // How many slots got moved by the last compaction
+        uint32_t CompactionMoves;
+    };
+
+    ObjectManager(RuntimeManager* a_runtime, JobSystem* a_jobSystem);
+    ~ObjectManager();
+
+    uint32_t CreateTransformBuffer();
+    TransformBuffer GetTransformBuffer(uint32_t a_addr);
+    void SetTransformBuffer(uint32_t a_addr, const TransformBuffer& a_buffer);
+    void DestroyTransformBuffer(uint32_t a_addr);
+
+    // Stays valid until the ObjectManager is gone, only meant for C# to write through
+    TransformPage* GetTransformPage(uint32_t a_page);
+
+    glm::mat4 GetGlobalMatrix(uint32_t a_addr);
+
+    // Brings every dirty world matrix up to date, each one only gets worked out once no matter how many children it has
+    // Goes a level at a time with each level split over the job system then fills some of the holes left by destroyed transforms
+    // Update thread calls this once a tick before the renderer takes its snapshot
+    void UpdateWorldMatrices();
+
+    TransformStats GetTransformStats();
+
+    // Update thread only, valid until the next UpdateWorldMatrices
+    inline const std::vector<uint32_t>& GetMovedTransforms() const
+    {
+        return m_movedTransforms;
+    }
+
+    // Render thread grabs one of these a frame so it is not fighting the update thread for the lock on every transform
+    // Matrices are by slot so the slots need to be from the same tick to look them up
+    inline TSnapshot<uint32_t> SnapshotTransformSlots()
+    {
+        return m_transformSlots.Snapshot();
+    }
+    inline TSnapshot<glm::mat4> SnapshotWorldMatrices()
+    {
+        return m_worldMatrices.Snapshot();
+    }
+    inline TSnapshot<glm::mat4> SnapshotWorldInverses()
+    {
+        return m_worldInverses.Snapshot();
+    }
+    static glm::mat4 GetGlobalMatrix(const TSnapshot<uint32_t>& a_transformSlots, const TSnapshot<glm::mat4>& a_worldMatrices, uint32_t a_addr);
+    static glm::mat4 GetGlobalInverse(const TSnapshot<uint32_t>& a_transformSlots, const TSnapshot<glm::mat4>& a_worldInverses, uint32_t a_addr);
+};
@@ -8,9 +8,7 @@
 #include <unordered_map>
 #include <vector>
 
-#if !defined(NDEBUG) && !defined(FLARENATIVE_ENABLE_PROFILER)
-#define FLARENATIVE_ENABLE_PROFILER
-#endif
+#include "DataTypes/HeapAllocation.h"
 
 class RuntimeManager;
 
@@ -23,6 +21,12 @@ struct ProfileFrame
     std::chrono::high_resolution_clock::time_point EndTime;
 };
 
+struct ProfileCounter
+{
+    std::string Name;
+    uint64_t Value;
+};
+
 class Profiler
 {
 public:
@@ -30,6 +34,7 @@ public:
     {
         std::string Name;
         std::vector<ProfileFrame> Frames;
+        std::vector<ProfileCounter> Counters;
     };
 
     typedef std::function<void(const PData&)> Callback;
@@ -57,6 +62,12 @@ public:
 
     static void StartFrame(const std::string_view& a_name);
     static void StopFrame();
+
+    static void SetCounter(const std::string_view& a_name, uint64_t a_value);
+
+    // Number of times operator new or HeapAllocation has been called on the calling thread
+    // Only gets counted when the profiler is enabled otherwise it is always 0
+    static uint64_t GetThreadAllocations();
 };
 
 struct StackProfilerFrame 
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "DataTypes/TSnapshot.h"
+#include "Flare/RenderProgram.h"
+#include "Rendering/CameraBuffer.h"
+#include "Rendering/Light.h"
+#include "Rendering/MaterialRenderStack.h"
+
+// Everything the renderer needs from an update tick, published by the update thread once the tick is done and never written to after
+// Snapshots only copy what changed since the last tick so anything untouched is just another reference
+struct FramePacket
+{
+    // Counts up from 1 with every publish, 0 is the empty packet from before the first one
+    uint64_t                            PublishNumber = 0;
+    TSnapshot<uint32_t>                 TransformSlots;
+    TSnapshot<glm::mat4>                WorldMatrices;
+    TSnapshot<glm::mat4>                WorldInverses;
+    TSnapshot<CameraBuffer>             Cameras;
+    TSnapshot<FlareBase::RenderProgram> Programs;
+    TSnapshot<MaterialRenderStack>      RenderStacks;
+    DirectionalLightArray::Snapshot_t   DirectionalLights;
+    PointLightArray::Snapshot_t         PointLights;
+    SpotLightArray::Snapshot_t          SpotLights;
+};
@@ -5,6 +5,8 @@
 
 #include <cstdint>
 
+#include "DataTypes/TSoAArray.h"
+
 enum e_LightType : uint16_t
 {
     LightType_Directional = 0,
@@ -68,4 +70,8 @@ struct SpotLightBuffer
     {
 
     }
-};
\ No newline at end of file
+};
+
+typedef TSoAArray<DirectionalLightBuffer, &DirectionalLightBuffer::TransformAddr, &DirectionalLightBuffer::RenderLayer, &DirectionalLightBuffer::Color, &DirectionalLightBuffer::Intensity> DirectionalLightArray;
+typedef TSoAArray<PointLightBuffer, &PointLightBuffer::TransformAddr, &PointLightBuffer::RenderLayer, &PointLightBuffer::Color, &PointLightBuffer::Intensity, &PointLightBuffer::Radius> PointLightArray;
+typedef TSoAArray<SpotLightBuffer, &SpotLightBuffer::TransformAddr, &SpotLightBuffer::RenderLayer, &SpotLightBuffer::Color, &SpotLightBuffer::Intensity, &SpotLightBuffer::CutoffAngle, &SpotLightBuffer::Radius> SpotLightArray;
\ No newline at end of file
@@ -3,12 +3,12 @@
 #include <cstdint>
 #include <vector>
 
-struct MeshRenderBuffer;
-
 struct ModelBuffer
 {
     uint32_t ModelAddr;
     std::vector<uint32_t> TransformAddr;
+    // Same order as the transforms, lets culling go from a mesh in the bounds tree to where it gets drawn
+    std::vector<uint32_t> MeshAddr;
 };
 
 class MaterialRenderStack
@@ -21,7 +21,7 @@ private:
 protected:
 
 public:
-    MaterialRenderStack(const MeshRenderBuffer& a_renderBuffer);
+    MaterialRenderStack(uint32_t a_materialAddr);
     ~MaterialRenderStack();
 
     inline bool Empty()
@@ -39,6 +39,11 @@ public:
         return m_modelBuffers;
     }
 
-    bool Add(const MeshRenderBuffer& a_renderBuffer);
-    bool Remove(const MeshRenderBuffer& a_renderBuffer);
+    // Does not look for an existing one RenderStackIndex keeps track of where they are
+    uint32_t AddModelBuffer(uint32_t a_modelAddr);
+    uint32_t AddTransform(uint32_t a_bufferIndex, uint32_t a_transformAddr, uint32_t a_meshAddr);
+
+    // Both swap remove and return the index of whatever got moved into the hole
+    uint32_t RemoveModelBuffer(uint32_t a_bufferIndex);
+    uint32_t RemoveTransform(uint32_t a_bufferIndex, uint32_t a_slot);
 };
\ No newline at end of file
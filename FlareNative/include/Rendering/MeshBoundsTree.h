@@ -0,0 +1,126 @@
+#pragma once
+
+#include <cstdint>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "DataTypes/TArray.h"
+#include "Maths/DynamicBVH.h"
+
+struct MeshRayHit
+{
+    uint32_t MeshAddr;
+    float    Distance;
+};
+
+// World space bounds for every mesh render buffer so things can be found without going through all of them
+// Update thread adds, removes and refits, queries can come from anywhere
+class MeshBoundsTree
+{
+private:
+    // Render thread can be a few publishes behind so meshes that changed since need checking against its own frame
+    static constexpr uint32_t ChangeHistory = 16;
+
+    struct MeshBounds
+    {
+        uint32_t Proxy;
+        uint32_t TransformAddr;
+        AABB     ModelBounds;
+        AABB     WorldBounds;
+        // Publish the last add, remove or move goes out with
+        uint64_t ChangedPublish;
+    };
+
+    mutable std::shared_mutex                               m_lock;
+
+    DynamicBVH                                              m_tree;
+
+    // Indexed by mesh render buffer address
+    std::vector<MeshBounds>                                 m_meshes;
+    std::unordered_map<uint32_t, std::vector<uint32_t>>     m_transformMeshes;
+
+    // Last publish the tree was refit for, changes since then go out with the next one
+    uint64_t                                                m_publishNumber;
+    // Meshes changed by each publish indexed by publish number, keeps the memory so it does not allocate once warmed up
+    std::vector<uint32_t>                                   m_changes[ChangeHistory];
+
+    void UMarkChanged(uint32_t a_meshAddr);
+
+protected:
+
+public:
+    MeshBoundsTree();
+    ~MeshBoundsTree();
+
+    void AddMesh(uint32_t a_meshAddr, uint32_t a_transformAddr, const AABB& a_modelBounds, const glm::mat4& a_world);
+    void RemoveMesh(uint32_t a_meshAddr);
+
+    // Only goes through meshes on the transforms that moved, returns how many had to be put back in the tree
+    // Publish number is the one the matrices are going out with
+    uint32_t Refit(const std::vector<uint32_t>& a_movedTransforms, const TSnapshot<uint32_t>& a_transformSlots, const TSnapshot<glm::mat4>& a_worldMatrices, uint64_t a_publishNumber);
+
+    // Frustum query for a frame from an older publish, whole subtrees outside the frustum get skipped
+    // Visible gets meshes that have not changed since that publish and are in the frustum
+    // Changed gets every mesh added, removed or moved since that publish as the tree no longer matches the frame for them, the frame needs to check those itself
+    // Returns false without calling anything if the publish is too old for the changes to still be around
+    template<typename TVisible, typename TChanged>
+    bool QueryFrame(const Frustum& a_frustum, uint64_t a_publishNumber, const TVisible& a_visible, const TChanged& a_changed) const
+    {
+        const std::shared_lock g = std::shared_lock(m_lock);
+
+        const uint64_t pending = m_publishNumber + 1;
+        if (a_publishNumber + ChangeHistory < pending)
+        {
+            return false;
+        }
+
+        m_tree.Query(a_frustum, [&](uint32_t a_meshAddr)
+        {
+            const MeshBounds& mesh = m_meshes[a_meshAddr];
+            if (mesh.ChangedPublish <= a_publishNumber && a_frustum.Overlaps(mesh.WorldBounds))
+            {
+                a_visible(a_meshAddr);
+            }
+
+            return true;
+        });
+
+        for (uint64_t i = a_publishNumber + 1; i <= pending; ++i)
+        {
+            for (const uint32_t meshAddr : m_changes[i % ChangeHistory])
+            {
+                a_changed(meshAddr);
+            }
+        }
+
+        return true;
+    }
+
+    // Works with anything that has Overlaps(AABB), checks against the actual bounds so nothing from the fat boxes gets through
+    template<typename TShape>
+    void Query(const TShape& a_shape, std::vector<uint32_t>* a_meshes) const
+    {
+        const std::shared_lock g = std::shared_lock(m_lock);
+
+        m_tree.Query(a_shape, [&](uint32_t a_meshAddr)
+        {
+            if (a_shape.Overlaps(m_meshes[a_meshAddr].WorldBounds))
+            {
+                a_meshes->emplace_back(a_meshAddr);
+            }
+
+            return true;
+        });
+    }
+
+    // Closest mesh the ray hits the bounds of
+    bool RayCast(const Ray& a_ray, float a_maxDistance, MeshRayHit* a_hit) const;
+
+    inline uint32_t GetMeshCount() const
+    {
+        const std::shared_lock g = std::shared_lock(m_lock);
+
+        return m_tree.GetProxyCount();
+    }
+};
@@ -11,6 +11,7 @@ enum e_RenderingEngine
 
 class AppWindow;
 class Config;
+class JobSystem;
 class ObjectManager;
 class RenderEngineBackend;
 class RuntimeManager;
@@ -31,6 +32,7 @@ private:
     Config*              m_config;
 
     ObjectManager*       m_objectManager;
+    JobSystem*           m_jobSystem;
 
     RenderEngineBackend* m_backend;
 
@@ -41,14 +43,21 @@ private:
 protected:
 
 public:
-    RenderEngine(RuntimeManager* a_runtime, ObjectManager* a_objectManager, AppWindow* a_window, Config* a_config);
+    RenderEngine(RuntimeManager* a_runtime, ObjectManager* a_objectManager, JobSystem* a_jobSystem, AppWindow* a_window, Config* a_config);
     ~RenderEngine();
 
     void Start();
     void Stop();
 
+    // Update thread only
+    void PublishFrame();
+
     inline ObjectManager* GetObjectManager() const
     {
         return m_objectManager;
     }
+    inline JobSystem* GetJobSystem() const
+    {
+        return m_jobSystem;
+    }
 };
\ No newline at end of file
@@ -24,4 +24,6 @@ public:
     }
 
     virtual void Update(double a_delta, double a_time) = 0;
+    // Called from the update thread once a tick is done to hand the state over to the renderer
+    virtual void PublishFrame() = 0;
 };
\ No newline at end of file
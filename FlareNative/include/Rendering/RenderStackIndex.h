@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "DataTypes/TArray.h"
+#include "Rendering/MaterialRenderStack.h"
+
+struct MeshRenderBuffer;
+
+// Keeps track of where every mesh is in the render stacks so adding and removing does not have to search them
+// Everything gets swap removed so the stacks stay packed for drawing and each mesh keeps a slot pointing back at its transform to fill the hole
+// Kept out of the stacks themselves as they get memcpy'd about by TArray and copied into every snapshot
+// Does not lock anything needs the render stack lock held
+class RenderStackIndex
+{
+private:
+    std::unordered_map<uint32_t, uint32_t> m_stacks;
+    // Model buffer index in the stack for each material and model
+    std::unordered_map<uint64_t, uint32_t> m_models;
+    std::vector<uint32_t>                  m_meshSlots;
+
+    static constexpr uint64_t GetModelKey(uint32_t a_materialAddr, uint32_t a_modelAddr)
+    {
+        return (uint64_t)a_materialAddr << 32 | a_modelAddr;
+    }
+
+protected:
+
+public:
+    RenderStackIndex();
+    ~RenderStackIndex();
+
+    void UAdd(TArray<MaterialRenderStack>* a_stacks, uint32_t a_meshAddr, const MeshRenderBuffer& a_buffer);
+    void URemove(TArray<MaterialRenderStack>* a_stacks, uint32_t a_meshAddr, const MeshRenderBuffer& a_buffer);
+};
\ No newline at end of file
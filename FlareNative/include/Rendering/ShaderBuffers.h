@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstdint>
+
 #define GLM_FORCE_SWIZZLE 
 #include <glm/glm.hpp>
 
@@ -21,6 +23,18 @@
 #define SHADER_UNIFORM_STR(S) #S
 #define GLSL_UNIFORM_STRING(set, location, name, structure) std::string("layout(binding=") + (set) + ",set=" + (location) + ") " SHADER_UNIFORM_STR(structure) " " + (name) + ";" 
 #define GLSL_PUSHBUFFER_STRING(name, structure) std::string("layout(push_constant) " SHADER_UNIFORM_STR(structure) " ") + (name) + ";"
+#define GLSL_INSTANCEBUFFER_STRING(set, location, name, type, structure) std::string(SHADER_UNIFORM_STR(structure) "; layout(std430,binding=") + (set) + ",set=" + (location) + ") readonly buffer " SHADER_UNIFORM_STR(type) "Instances { " SHADER_UNIFORM_STR(type) " " + (name) + "[]; };"
+
+#define GLSL_CLUSTERBUFFER_STRING(set, location, name, type, structure) std::string(SHADER_UNIFORM_STR(structure) "; layout(std430,binding=") + (set) + ",set=" + (location) + ") readonly buffer " SHADER_UNIFORM_STR(type) "Clusters { uvec4 ClusterSize; vec4 ClusterDepth; " SHADER_UNIFORM_STR(type) " Lights[" + std::to_string(LightClusterMaxLights) + "]; uint Indices[]; } " + (name) + ";"
+
+#define GLSL_STRUCT_DEFINITION(name) struct name
+
+// Froxel grid for the clustered light buffers, screen tiles by log spaced depth slices
+constexpr uint32_t LightClusterX = 16;
+constexpr uint32_t LightClusterY = 9;
+constexpr uint32_t LightClusterZ = 24;
+constexpr uint32_t LightClusterCount = LightClusterX * LightClusterY * LightClusterZ;
+constexpr uint32_t LightClusterMaxLights = 1024;
 
 #define CAMERA_SHADER_STRUCTURE(D, M4) \
 D(CameraShaderBuffer) \
@@ -49,6 +63,7 @@ V4(LightColor) \
 FL(Radius) \
 }
 #define GLSL_POINT_LIGHT_SHADER_STRUCTURE POINT_LIGHT_SHADER_STRUCTURE(GLSL_DEFINITION, GLSL_FLOAT, GLSL_VEC4)
+#define GLSL_CLUSTER_POINT_LIGHT_SHADER_STRUCTURE POINT_LIGHT_SHADER_STRUCTURE(GLSL_STRUCT_DEFINITION, GLSL_FLOAT, GLSL_VEC4)
 
 #define SPOT_LIGHT_SHADER_STRUCTURE(D, V3, V4) \
 D(SpotLightShaderBuffer) \
@@ -59,6 +74,7 @@ V4(LightColor) \
 V3(CutoffAngle) \
 }
 #define GLSL_SPOT_LIGHT_SHADER_STRUCTURE SPOT_LIGHT_SHADER_STRUCTURE(GLSL_DEFINITION, GLSL_VEC3, GLSL_VEC4)
+#define GLSL_CLUSTER_SPOT_LIGHT_SHADER_STRUCTURE SPOT_LIGHT_SHADER_STRUCTURE(GLSL_STRUCT_DEFINITION, GLSL_VEC3, GLSL_VEC4)
 
 #define MODEL_SHADER_STRUCTURE(D, M4) \
 D(ModelShaderBuffer) \
@@ -67,6 +83,7 @@ M4(Model) \
 M4(InvModel) \
 }
 #define GLSL_MODEL_SHADER_STRUCTURE MODEL_SHADER_STRUCTURE(GLSL_DEFINITION, GLSL_MAT4)
+#define GLSL_INSTANCE_MODEL_SHADER_STRUCTURE MODEL_SHADER_STRUCTURE(GLSL_STRUCT_DEFINITION, GLSL_MAT4)
 
 #define TIME_SHADER_BUFFER(D, V2) \
 D(TimeShaderBuffer) \
@@ -81,3 +98,11 @@ POINT_LIGHT_SHADER_STRUCTURE(F_DEFINITION, F_FLOAT, F_VEC4);
 SPOT_LIGHT_SHADER_STRUCTURE(F_DEFINITION, F_VEC3, F_VEC4);
 MODEL_SHADER_STRUCTURE(F_DEFINITION, F_MAT4);
 TIME_SHADER_BUFFER(F_DEFINITION, F_VEC2);
+
+// Start of a cluster buffer, the lights follow then the cluster ranges and light indices
+// Cluster depth is near, far then the scale and bias to go from log depth to a slice
+struct LightClusterHeader
+{
+    alignas(16) glm::uvec4 ClusterSize;
+    alignas(16) glm::vec4 ClusterDepth;
+};
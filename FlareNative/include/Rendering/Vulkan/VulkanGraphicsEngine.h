@@ -1,5 +1,7 @@
 #pragma once
 
+#include <atomic>
+#include <mutex>
 #include <unordered_map>
 #include <vector>
 
@@ -8,25 +10,37 @@
 class RuntimeFunction;
 class RuntimeManager;
 class VulkanGraphicsEngineBindings;
+class VulkanInstanceBuffer;
 class VulkanModel;
 class VulkanPipeline;
 class VulkanPixelShader;
 class VulkanRenderCommand;
 class VulkanRenderEngineBackend;
 class VulkanRenderTexture;
+class VulkanShaderData;
+class VulkanStorageBuffer;
 class VulkanSwapchain;
 class VulkanTexture;
-class VulkanUniformBuffer;
+class VulkanUniformRing;
 class VulkanVertexShader;
 
+struct PointLightShaderBuffer;
+struct SpotLightShaderBuffer;
+
+#include "DataTypes/FrameArena.h"
 #include "DataTypes/TArray.h"
+#include "DataTypes/TFrameMailbox.h"
+#include "DataTypes/TSlotMap.h"
 #include "DataTypes/TStatic.h"
 #include "Flare/RenderProgram.h"
 #include "Flare/TextureSampler.h"
 #include "Rendering/CameraBuffer.h"
+#include "Rendering/FramePacket.h"
 #include "Rendering/Light.h"
 #include "Rendering/MaterialRenderStack.h"
+#include "Rendering/MeshBoundsTree.h"
 #include "Rendering/MeshRenderBuffer.h"
+#include "Rendering/RenderStackIndex.h"
 
 class VulkanGraphicsEngine
 {
@@ -35,8 +49,23 @@ private:
 
     static constexpr uint32_t DrawingPassCount = 3;
 
+    // One per thread that records secondaries, only the owning thread touches it outside of the reset in Update
+    struct SecondaryCommandPool
+    {
+        vk::CommandPool                Pool[VulkanFlightPoolSize];
+        std::vector<vk::CommandBuffer> Buffers[VulkanFlightPoolSize];
+        uint32_t                       Used[VulkanFlightPoolSize];
+    };
+
+    struct RetiredShaderData
+    {
+        uint64_t          PublishNumber;
+        VulkanShaderData* Data;
+    };
+
     RuntimeManager*                               m_runtimeManager;
     VulkanGraphicsEngineBindings*                 m_runtimeBindings;
+    VulkanInstanceBuffer*                         m_instanceBuffer;
     VulkanSwapchain*                              m_swapchain;
 
     RuntimeFunction*                              m_preShadowFunc;
@@ -57,36 +86,89 @@ private:
 
     TArray<FlareBase::RenderProgram>              m_shaderPrograms;
      
-    TArray<VulkanVertexShader*>                   m_vertexShaders;
-    TArray<VulkanPixelShader*>                    m_pixelShaders;
+    TSlotMap<VulkanVertexShader*>                 m_vertexShaders;
+    TSlotMap<VulkanPixelShader*>                  m_pixelShaders;
      
     TArray<FlareBase::TextureSampler>             m_textureSampler;
 
-    TArray<VulkanModel*>                          m_models;
-    TArray<VulkanTexture*>                        m_textures;
-    TArray<VulkanRenderTexture*>                  m_renderTextures;
+    TSlotMap<VulkanModel*>                        m_models;
+    TSlotMap<VulkanTexture*>                      m_textures;
+    TSlotMap<VulkanRenderTexture*>                m_renderTextures;
 
     TArray<MeshRenderBuffer>                      m_renderBuffers;
+    // Guarded by the render buffer lock
+    std::vector<uint32_t>                         m_freeRenderBuffers;
     TArray<MaterialRenderStack>                   m_renderStacks;
+    // Guarded by the render stack lock
+    RenderStackIndex                              m_renderStackIndex;
+
+    MeshBoundsTree                                m_meshBounds;
 
-    TArray<DirectionalLightBuffer>                m_directionalLights;
-    TArray<PointLightBuffer>                      m_pointLights;
-    TArray<SpotLightBuffer>                       m_spotLights;
+    DirectionalLightArray                         m_directionalLights;
+    PointLightArray                               m_pointLights;
+    SpotLightArray                                m_spotLights;
 
-    std::vector<VulkanUniformBuffer*>             m_directionalLightUniforms;
-    std::vector<VulkanUniformBuffer*>             m_pointLightUniforms;
-    std::vector<VulkanUniformBuffer*>             m_spotLightUniforms;
+    // Lights and cameras all get a range of the ring each frame, light i is at the start plus i aligned sizes and cameras are the same per pass
+    VulkanUniformRing*                            m_uniformRing;
+    uint32_t                                      m_directionalLightOffset;
+    uint32_t                                      m_pointLightOffset;
+    uint32_t                                      m_spotLightOffset;
+    uint32_t                                      m_cameraOffset;
+
+    // One per camera being drawn, the clustered light shaders get all their lights from these
+    std::vector<VulkanStorageBuffer*>             m_pointLightClusters;
+    std::vector<VulkanStorageBuffer*>             m_spotLightClusters;
 
     TArray<CameraBuffer>                          m_cameraBuffers;
-    std::vector<VulkanUniformBuffer*>             m_cameraUniforms;
+
+    // Filled by the update thread at the end of each tick, the render thread picks up the latest without touching any locks
+    TFrameMailbox<FramePacket>                    m_framePackets;
+    // Packet being drawn, only valid on the render threads while recording
+    const FramePacket*                            m_frame;
+    // Goes up every Update, lets anything kept per frame index tell when the index has come around again
+    uint64_t                                      m_frameNumber;
+
+    // Packets hold the raw shader data pointers so it cannot be deleted until nothing published before it went can still be drawn from
+    // Update thread only
+    uint64_t                                      m_publishNumber;
+    std::vector<RetiredShaderData>                m_retiredShaderData;
+    // Render thread only, the packet each frame index was last drawn from and the GPU is not done with until the index comes around
+    uint64_t                                      m_framePacketNumbers[VulkanFlightPoolSize];
+    // Oldest packet the render thread or the GPU could still be using
+    std::atomic<uint64_t>                         m_oldestPacketInUse;
 
     std::vector<vk::CommandPool>                  m_commandPool[VulkanFlightPoolSize];
     std::vector<vk::CommandBuffer>                m_commandBuffers[VulkanFlightPoolSize];
+
+    std::mutex                                    m_secondaryPoolLock;
+    std::vector<SecondaryCommandPool*>            m_secondaryPools;
+    TStatic<SecondaryCommandPool*>                m_threadSecondaryPools;
+    // Draws per secondary, moves about each frame off how long draws are taking to record
+    std::atomic<uint32_t>                         m_drawChunkSize;
+
+    // Scratch memory for the frame, one per command buffer as each gets recorded on its own thread and one for Update itself
+    std::vector<FrameArena*>                      m_passArenas[VulkanFlightPoolSize];
+    FrameArena                                    m_updateArenas[VulkanFlightPoolSize];
+    std::atomic<uint64_t>                         m_frameAllocations;
+
+    // Added up by the draw passes and reported once they have all finished
+    std::atomic<uint32_t>                         m_materialBinds;
+    std::atomic<uint32_t>                         m_modelBinds;
+    std::atomic<uint32_t>                         m_unsortedMaterialBinds;
+    std::atomic<uint32_t>                         m_unsortedModelBinds;
     
+    glm::vec2 GetCameraRenderSize(const CameraBuffer& a_camBuffer);
+
     vk::CommandBuffer StartCommandBuffer(uint32_t a_bufferIndex, uint32_t a_index) const;
 
-    vk::CommandBuffer DrawPass(uint32_t a_camIndex, uint32_t a_bufferIndex, uint32_t a_index);
-    vk::CommandBuffer LightPass(uint32_t a_camIndex, uint32_t a_bufferIndex, uint32_t a_index);
+    // One flag per instance per camera in the order DrawPass walks the render stacks, each camera gets instance count flags
+    const uint8_t* CullInstances(const TArenaArray<uint32_t>& a_camIndices, FrameArena* a_arena, uint32_t* a_instanceCount, uint32_t* a_visibleCount);
+
+    vk::CommandBuffer DrawPass(uint32_t a_camIndex, uint32_t a_bufferIndex, uint32_t a_index, const uint8_t* a_visible, uint32_t a_instanceCount);
+    // Assigns point and spot lights to froxels for every camera, the cluster index for a camera is its place in the camera indices
+    void BuildLightClusters(const TArenaArray<uint32_t>& a_camIndices, FrameArena* a_arena, uint32_t a_index, const PointLightShaderBuffer* a_pointLights, const SpotLightShaderBuffer* a_spotLights);
+
+    vk::CommandBuffer LightPass(uint32_t a_camIndex, uint32_t a_bufferIndex, uint32_t a_index, uint32_t a_clusterIndex);
     vk::CommandBuffer PostPass(uint32_t a_camIndex, uint32_t a_bufferIndex, uint32_t a_index);
 
 protected:
@@ -100,7 +182,26 @@ public:
         m_swapchain = a_swapchaing;
     }
 
-    std::vector<vk::CommandBuffer> Update(uint32_t a_index);
+    // Needs setting before the render thread starts
+    inline void SetFrameLatency(uint32_t a_latency)
+    {
+        m_framePackets.SetLatency(a_latency);
+    }
+    // Update thread only
+    void PublishFrame();
+    // Update thread only, deletes the data once no packet that could point at it is left
+    void RetireShaderData(VulkanShaderData* a_data);
+
+    // Command buffers live in the frame arena so are only valid until this frame index comes around again
+    TArenaView<vk::CommandBuffer> Update(uint32_t a_index);
+
+    inline uint64_t GetFrameNumber() const
+    {
+        return m_frameNumber;
+    }
+
+    // Comes out of a pool owned by the calling thread, only valid until this frame index comes around again
+    vk::CommandBuffer StartSecondaryCommandBuffer(uint32_t a_index, const vk::CommandBufferInheritanceInfo& a_inheritance);
 
     VulkanVertexShader* GetVertexShader(uint32_t a_addr);
     VulkanPixelShader* GetPixelShader(uint32_t a_addr);
@@ -109,13 +210,23 @@ public:
     VulkanPipeline* GetPipeline(uint32_t a_renderTexture, uint32_t a_pipeline);
     
     CameraBuffer GetCameraBuffer(uint32_t a_addr);
-    inline VulkanUniformBuffer* GetCameraUniformBuffer(uint32_t a_addr) const
+    // Frame versions are only valid on the render threads while recording
+    const CameraBuffer& GetFrameCameraBuffer(uint32_t a_addr) const;
+    glm::mat4 GetFrameGlobalMatrix(uint32_t a_transformAddr) const;
+    inline VulkanUniformRing* GetUniformRing() const
     {
-        return m_cameraUniforms[a_addr];
+        return m_uniformRing;
     }
+    // Each pass gets its own camera range so passes for the same camera do not write over each other
+    uint32_t GetCameraUniformOffset(uint32_t a_bufferIndex) const;
 
     VulkanModel* GetModel(uint32_t a_addr);
 
+    inline const MeshBoundsTree& GetMeshBounds() const
+    {
+        return m_meshBounds;
+    }
+
     VulkanTexture* GetTexture(uint32_t a_addr);
     VulkanRenderTexture* GetRenderTexture(uint32_t a_addr);
 };
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string_view>
+#include <vector>
 
 class RuntimeManager;
 class VulkanGraphicsEngine;
@@ -53,6 +54,11 @@ public:
     void GenerateRenderStack(uint32_t a_meshAddr) const;
     void DestroyRenderStack(uint32_t a_meshAddr) const;
 
+    std::vector<uint32_t> QueryMeshesAABB(const glm::vec3& a_min, const glm::vec3& a_max) const;
+    std::vector<uint32_t> QueryMeshesSphere(const glm::vec3& a_center, float a_radius) const;
+    std::vector<uint32_t> QueryMeshesFrustum(uint32_t a_camAddr, const glm::vec2& a_screenSize) const;
+    uint32_t RayCastMeshes(const glm::vec3& a_origin, const glm::vec3& a_direction, float a_maxDistance, float* a_distance) const;
+
     uint32_t GenerateTexture(uint32_t a_width, uint32_t a_height, const void* a_data);
     void DestroyTexture(uint32_t a_addr) const;
 
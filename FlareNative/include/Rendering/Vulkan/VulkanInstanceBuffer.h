@@ -0,0 +1,45 @@
+#pragma once
+
+#include <atomic>
+
+#include "Rendering/ShaderBuffers.h"
+#include "Rendering/Vulkan/VulkanConstants.h"
+
+class VulkanRenderEngineBackend;
+
+// Per frame storage buffer of instance matrices that stays mapped, one buffer per frame index so it is never written while the GPU reads it
+// Passes grab ranges out of it from any thread then draw with the start of the range as the first instance
+class VulkanInstanceBuffer
+{
+private:
+    static constexpr uint32_t InitialCapacity = 4096;
+
+    VulkanRenderEngineBackend* m_engine;
+
+    vk::Buffer                 m_buffers[VulkanFlightPoolSize];
+    VmaAllocation              m_allocations[VulkanFlightPoolSize];
+    ModelShaderBuffer*         m_data[VulkanFlightPoolSize];
+    uint32_t                   m_capacity[VulkanFlightPoolSize];
+
+    std::atomic<uint32_t>      m_used[VulkanFlightPoolSize];
+
+    void Allocate(uint32_t a_index, uint32_t a_capacity);
+    void Free(uint32_t a_index);
+
+protected:
+
+public:
+    VulkanInstanceBuffer(VulkanRenderEngineBackend* a_engine);
+    ~VulkanInstanceBuffer();
+
+    // Only call while nothing is using this frame index, grows the buffer if it cannot fit the count
+    void Reset(uint32_t a_index, uint32_t a_count);
+
+    // Returns null if it does not fit, first is where the range starts in instances
+    ModelShaderBuffer* Push(uint32_t a_index, uint32_t a_count, uint32_t* a_first);
+
+    inline vk::Buffer GetBuffer(uint32_t a_index) const
+    {
+        return m_buffers[a_index];
+    }
+};
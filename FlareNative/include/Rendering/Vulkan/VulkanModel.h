@@ -1,5 +1,6 @@
 #pragma once
 
+#include "Maths/Bounds.h"
 #include "Rendering/Vulkan/VulkanConstants.h"
 
 #include <mutex>
@@ -21,6 +22,9 @@ private:
 
     uint32_t                   m_indexCount;
 
+    // Model space, worked out from the vertices when the model is made
+    AABB                       m_bounds;
+
 protected:
 
 public:
@@ -37,5 +41,10 @@ public:
         return m_indexCount;
     }
 
+    inline const AABB& GetBounds() const
+    {
+        return m_bounds;
+    }
+
     void Bind(const vk::CommandBuffer& a_cmdBuffer) const;
 };
\ No newline at end of file
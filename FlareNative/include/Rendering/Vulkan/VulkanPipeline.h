@@ -32,5 +32,5 @@ public:
 
     VulkanShaderData* GetShaderData() const;
 
-    void Bind(uint32_t a_index, vk::CommandBuffer a_commandBuffer) const;
+    void Bind(vk::CommandBuffer a_commandBuffer) const;
 };
\ No newline at end of file
@@ -19,6 +19,9 @@ private:
     constexpr static uint32_t FlushedBit = 0;
     constexpr static uint32_t ViewportBit = 1;
     constexpr static uint32_t CameraBit = 2;
+    constexpr static uint32_t StartedBit = 3;
+    constexpr static uint32_t SecondaryBit = 4;
+    constexpr static uint32_t TailBit = 5;
 
     VulkanRenderEngineBackend* m_engine;
     VulkanGraphicsEngine*      m_gEngine;
@@ -31,11 +34,24 @@ private:
     uint32_t                   m_renderTexAddr;
     uint32_t                   m_materialAddr;
 
+    // Primary the pass lives in, commands go to the current buffer which is only different while recording a tail
+    vk::CommandBuffer          m_primaryBuffer;
     vk::CommandBuffer          m_commandBuffer;
 
+    vk::RenderPass             m_renderPass;
+    vk::Framebuffer            m_framebuffer;
+
+    vk::Viewport               m_viewport;
+    vk::Rect2D                 m_scissor;
+
     void SetFlushedState(bool a_value);
     void SetViewportState(bool a_value);
     void SetCameraState(bool a_value);
+    void SetStartedState(bool a_value);
+    void SetSecondaryState(bool a_value);
+    void SetTailState(bool a_value);
+
+    void StartRenderPass(vk::SubpassContents a_contents);
 
 protected:
 
@@ -55,9 +71,37 @@ public:
     {
         return m_flags & 0b1 << CameraBit;
     }
+    // Binding a render texture only queues the pass, it gets started by whatever records into it first
+    inline bool IsStarted() const
+    {
+        return m_flags & 0b1 << StartedBit;
+    }
+    inline bool IsSecondary() const
+    {
+        return m_flags & 0b1 << SecondaryBit;
+    }
+    inline bool IsTailStarted() const
+    {
+        return m_flags & 0b1 << TailBit;
+    }
+
+    inline vk::Viewport GetViewport() const
+    {
+        return m_viewport;
+    }
+    inline vk::Rect2D GetScissor() const
+    {
+        return m_scissor;
+    }
 
     void Flush();
 
+    // Where inline commands for the pass need to go, starts the pass if nothing has yet
+    // If the pass was started for secondaries anything inline after goes into a tail buffer that gets executed on flush
+    vk::CommandBuffer GetInlineCommandBuffer();
+    // Starts the queued pass so it only takes secondary command buffers, fails if there is no queued pass or it already started
+    bool StartSecondaryPass(vk::CommandBufferInheritanceInfo* a_inheritance);
+
     inline uint32_t GetRenderTexutreAddr() const
     {
         return m_renderTexAddr;
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <atomic>
+
 #include "Rendering/Vulkan/VulkanConstants.h"
 
 #include "Rendering/RenderEngineBackend.h"
@@ -27,9 +29,14 @@ private:
     vk::Queue                                     m_presentQueue = nullptr;
     
     vk::PhysicalDevicePushDescriptorPropertiesKHR m_pushDescriptorProperties;
+    // Null if VK_KHR_push_descriptor is not there
+    PFN_vkCmdPushDescriptorSetKHR                 m_cmdPushDescriptorSet = nullptr;
+
+    // Handles can come straight back for something new once destroyed so this lets the descriptor caches know not to trust them
+    std::atomic<uint64_t>                         m_descriptorResourceGeneration = 0;
 
-    std::vector<vk::Semaphore>                    m_interSemaphore[VulkanMaxFlightFrames];
     vk::Semaphore                                 m_imageAvailable[VulkanMaxFlightFrames];
+    vk::Semaphore                                 m_renderFinished[VulkanMaxFlightFrames];
     vk::Fence                                     m_inFlight[VulkanMaxFlightFrames];
             
     vk::CommandPool                               m_commandPool;
@@ -48,6 +55,7 @@ public:
     virtual ~VulkanRenderEngineBackend();
 
     virtual void Update(double a_delta, double a_time);
+    virtual void PublishFrame();
 
     vk::CommandBuffer CreateCommandBuffer(vk::CommandBufferLevel a_level) const;
     void DestroyCommandBuffer(const vk::CommandBuffer& a_buffer) const;
@@ -91,6 +99,26 @@ public:
         return m_graphicsQueue;
     }
 
+    inline bool IsPushDescriptorSupported() const
+    {
+        return m_cmdPushDescriptorSet != nullptr;
+    }
+    // Only valid if push descriptors are supported
+    inline void PushDescriptorSet(vk::CommandBuffer a_commandBuffer, vk::PipelineLayout a_layout, uint32_t a_set, const vk::WriteDescriptorSet& a_write) const
+    {
+        m_cmdPushDescriptorSet((VkCommandBuffer)a_commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, (VkPipelineLayout)a_layout, a_set, 1, (const VkWriteDescriptorSet*)&a_write);
+    }
+
+    // Needs calling by anything that can end up in a descriptor set when it destroys its image views or buffers
+    inline void DescriptorResourceDestroyed()
+    {
+        m_descriptorResourceGeneration.fetch_add(1, std::memory_order_release);
+    }
+    inline uint64_t GetDescriptorResourceGeneration() const
+    {
+        return m_descriptorResourceGeneration.load(std::memory_order_acquire);
+    }
+
     inline uint32_t GetImageIndex() const
     {
         return m_imageIndex;
@@ -3,31 +3,67 @@
 #define GLM_FORCE_SWIZZLE 
 #include <glm/glm.hpp>
 
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
 #include "Rendering/Vulkan/VulkanConstants.h"
 
 #include "Flare/ShaderBufferInput.h"
 #include "Flare/TextureSampler.h"
 
-class ObjectManager;
 class VulkanGraphicsEngine;
 class VulkanRenderEngineBackend;
-class VulkanUniformBuffer;
 
 class VulkanShaderData
 {
 private:
-    // Emulating push descriptors cause of AMD
-    // Newer drivers have it but relying on new version
+    // Sets that change per draw, one can go straight into the command buffer if VK_KHR_push_descriptor is there
+    // Layouts only get one push set and older AMD drivers do not have it so the rest come out of the descriptor cache
     struct PushDescriptor
     {
         uint32_t Set;
         uint32_t Binding;
+        uint32_t Size;
+        vk::DescriptorType Type;
+        bool Pushed;
         vk::DescriptorSetLayout DescriptorLayout;
-        vk::DescriptorPool DescriptorPool;
     };
 
+    // Everything that goes into a cached set, uniforms are dynamic so the offset is not part of it
+    struct DescriptorKey
+    {
+        uint32_t Set;
+        uint64_t Resource;
+        uint64_t Sampler;
+
+        inline bool operator ==(const DescriptorKey& a_other) const
+        {
+            return Set == a_other.Set && Resource == a_other.Resource && Sampler == a_other.Sampler;
+        }
+    };
+    struct DescriptorKeyHash
+    {
+        inline size_t operator ()(const DescriptorKey& a_key) const
+        {
+            return std::hash<uint64_t>()(a_key.Resource) ^ std::hash<uint64_t>()(a_key.Sampler) * 31 ^ a_key.Set;
+        }
+    };
+
+    // One per frame index, gets emptied the first time it is used on a new frame as the GPU is done with the sets by then
+    // Sets are found by handle so they also get forgotten when any resource that can be in one is destroyed
+    struct DescriptorCache
+    {
+        std::mutex                                                              Lock;
+        uint64_t                                                                Frame;
+        uint64_t                                                                ResourceGeneration;
+        std::vector<vk::DescriptorPool>                                         Pools;
+        uint32_t                                                                PoolIndex;
+        uint32_t                                                                PoolSets;
+        std::unordered_map<DescriptorKey, vk::DescriptorSet, DescriptorKeyHash> Sets;
+    };
 
-    static constexpr uint32_t PushCount = 32;
+    static constexpr uint32_t CachePoolSize = 64;
     static constexpr uint32_t StaticIndex = 0;
 
     VulkanRenderEngineBackend*   m_engine;
@@ -37,7 +73,9 @@ private:
   
     vk::PipelineLayout           m_layout;
  
-    std::vector<PushDescriptor>  m_pushDescriptors[VulkanFlightPoolSize];
+    std::vector<PushDescriptor>         m_pushDescriptors;
+    std::vector<vk::DescriptorPoolSize> m_cachePoolSizes;
+    mutable DescriptorCache             m_descriptorCaches[VulkanFlightPoolSize];
  
     vk::DescriptorSetLayout      m_staticDesciptorLayout;
     vk::DescriptorPool           m_staticDescriptorPool;
@@ -45,9 +83,17 @@ private:
 
     FlareBase::ShaderBufferInput m_cameraBufferInput;
     FlareBase::ShaderBufferInput m_transformBufferInput;
+    FlareBase::ShaderBufferInput m_instanceBufferInput;
     FlareBase::ShaderBufferInput m_directionalLightBufferInput;
     FlareBase::ShaderBufferInput m_pointLightBufferInput;
     FlareBase::ShaderBufferInput m_spotLightBufferInput;
+    FlareBase::ShaderBufferInput m_pointLightClusterInput;
+    FlareBase::ShaderBufferInput m_spotLightClusterInput;
+
+    const PushDescriptor* GetPushDescriptor(uint32_t a_slot) const;
+    vk::DescriptorSet GetCachedSet(const DescriptorKey& a_key, vk::WriteDescriptorSet a_write, vk::DescriptorSetLayout a_layout, uint32_t a_index) const;
+    // Pushes the write if it is the push set otherwise binds a set from the cache with it in
+    void PushWrite(vk::CommandBuffer a_commandBuffer, const PushDescriptor& a_descriptor, const vk::WriteDescriptorSet& a_write, uint64_t a_resource, uint64_t a_sampler, const uint32_t* a_dynamicOffset, uint32_t a_index) const;
 
 protected:
 
@@ -64,6 +110,16 @@ public:
     {
         return m_cameraBufferInput;
     }
+    // Shaders that take an instance buffer get their transforms from there and get drawn in one go per model
+    // Everything else falls back to a push constant per object
+    inline bool IsInstanced() const
+    {
+        return m_instanceBufferInput.BufferType == FlareBase::ShaderBufferType_InstanceBuffer;
+    }
+    inline FlareBase::ShaderBufferInput GetInstanceInput() const
+    {
+        return m_instanceBufferInput;
+    }
     inline FlareBase::ShaderBufferInput GetDirectionalLightInput() const
     {
         return m_directionalLightBufferInput;
@@ -76,13 +132,27 @@ public:
     {
         return m_spotLightBufferInput;
     }
+    inline FlareBase::ShaderBufferInput GetPointLightClusterInput() const
+    {
+        return m_pointLightClusterInput;
+    }
+    inline FlareBase::ShaderBufferInput GetSpotLightClusterInput() const
+    {
+        return m_spotLightClusterInput;
+    }
 
     void SetTexture(uint32_t a_slot, const FlareBase::TextureSampler& a_sampler) const;
 
+    // Safe to push from any thread, the cache locks when it gets used
     void PushTexture(vk::CommandBuffer a_commandBuffer, uint32_t a_slot, const FlareBase::TextureSampler& a_sampler, uint32_t a_index) const;
-    void PushUniformBuffer(vk::CommandBuffer a_commandBuffer, uint32_t a_slot, VulkanUniformBuffer* a_buffer, uint32_t a_index) const;
+    // Uniforms come out of the uniform ring so get bound at an offset
+    void PushUniformBuffer(vk::CommandBuffer a_commandBuffer, uint32_t a_slot, vk::Buffer a_buffer, uint32_t a_offset, uint32_t a_index) const;
+    void PushStorageBuffer(vk::CommandBuffer a_commandBuffer, uint32_t a_slot, vk::Buffer a_buffer, uint32_t a_index) const;
+    void PushInstanceBuffer(vk::CommandBuffer a_commandBuffer, vk::Buffer a_buffer, uint32_t a_index) const;
 
-    void UpdateTransformBuffer(vk::CommandBuffer a_commandBuffer, uint32_t a_transformAddr, ObjectManager* a_objectManager) const;
+    void UpdateTransformBuffer(vk::CommandBuffer a_commandBuffer, const glm::mat4& a_transform) const;
+    // For when the inverse is already known so it does not need working out again
+    void UpdateTransformBuffer(vk::CommandBuffer a_commandBuffer, const glm::mat4& a_transform, const glm::mat4& a_invTransform) const;
 
-    void Bind(uint32_t a_index, vk::CommandBuffer a_commandBuffer) const;
+    void Bind(vk::CommandBuffer a_commandBuffer) const;
 };
\ No newline at end of file
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "Rendering/Vulkan/VulkanConstants.h"
+
+class VulkanRenderEngineBackend;
+
+// Mapped storage buffer with one copy per frame index that grows to fit whatever gets written to it
+// Only resize or write an index while nothing is using it
+class VulkanStorageBuffer
+{
+private:
+    VulkanRenderEngineBackend* m_engine;
+
+    vk::Buffer                 m_buffers[VulkanFlightPoolSize];
+    VmaAllocation              m_allocations[VulkanFlightPoolSize];
+    void*                      m_data[VulkanFlightPoolSize];
+    uint32_t                   m_size[VulkanFlightPoolSize];
+
+    void Allocate(uint32_t a_index, uint32_t a_size);
+    void Free(uint32_t a_index);
+
+protected:
+
+public:
+    VulkanStorageBuffer(VulkanRenderEngineBackend* a_engine, uint32_t a_size);
+    ~VulkanStorageBuffer();
+
+    // Throws away the old contents if it has to grow
+    void Reserve(uint32_t a_index, uint32_t a_size);
+
+    inline void* GetData(uint32_t a_index) const
+    {
+        return m_data[a_index];
+    }
+    inline vk::Buffer GetBuffer(uint32_t a_index) const
+    {
+        return m_buffers[a_index];
+    }
+};
\ No newline at end of file
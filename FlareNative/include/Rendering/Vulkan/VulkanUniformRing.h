@@ -0,0 +1,65 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+
+#include "Rendering/Vulkan/VulkanConstants.h"
+
+class VulkanRenderEngineBackend;
+
+// Per frame uniform memory that stays mapped, one buffer per frame index so it is never written while the GPU reads it
+// Everything gets handed out as aligned ranges of the one buffer and bound with dynamic offsets
+// Keeps a copy of what is in each buffer so writes that would not change anything get skipped
+class VulkanUniformRing
+{
+private:
+    static constexpr uint32_t InitialCapacity = 65536;
+
+    VulkanRenderEngineBackend* m_engine;
+
+    uint32_t                   m_alignment;
+
+    vk::Buffer                 m_buffers[VulkanFlightPoolSize];
+    VmaAllocation              m_allocations[VulkanFlightPoolSize];
+    unsigned char*             m_data[VulkanFlightPoolSize];
+    // Always matches what is in the buffer, reading back from mapped memory is slow so compare against this instead
+    std::vector<unsigned char> m_shadow[VulkanFlightPoolSize];
+    uint32_t                   m_capacity[VulkanFlightPoolSize];
+
+    std::atomic<uint32_t>      m_used[VulkanFlightPoolSize];
+    std::atomic<uint32_t>      m_writeCount;
+
+    void Allocate(uint32_t a_index, uint32_t a_capacity);
+    void Free(uint32_t a_index);
+
+protected:
+
+public:
+    VulkanUniformRing(VulkanRenderEngineBackend* a_engine);
+    ~VulkanUniformRing();
+
+    // Size a range of this many bytes actually takes up
+    inline uint32_t GetAlignedSize(uint32_t a_size) const
+    {
+        return (a_size + m_alignment - 1) & ~(m_alignment - 1);
+    }
+
+    // Only call while nothing is using this frame index, grows the buffer if it cannot fit the size
+    // Ranges come out in the order they are pushed so pushing the same things each frame lands them on the same data as last time
+    void Reset(uint32_t a_index, uint32_t a_size);
+
+    // Returns -1 if it does not fit, otherwise the offset to bind with
+    uint32_t Push(uint32_t a_index, uint32_t a_size);
+    // Returns false if the data was already there and nothing needed writing
+    bool Write(uint32_t a_index, uint32_t a_offset, const void* a_data, uint32_t a_size);
+
+    inline uint32_t GetWriteCount() const
+    {
+        return m_writeCount;
+    }
+
+    inline vk::Buffer GetBuffer(uint32_t a_index) const
+    {
+        return m_buffers[a_index];
+    }
+};
\ No newline at end of file
@@ -48,6 +48,8 @@ public:
     void Update(double a_delta, double a_time);
 
     void AttachThread();
+    // Threads that attached need to detach before they exit otherwise cleanup can hang waiting on them
+    void DetachThread();
 
     inline MonoDomain* GetDomain() const
     {
@@ -47,7 +47,9 @@ public:
 
     inline static bool KeyExists(const std::string_view& a_key)
     {
-        return Instance->m_strings.Exists(std::string(a_key));
+        FLARE_ASSERT(Instance != nullptr);
+
+        return Instance->m_strings.Exists(a_key);
     }
 
     inline static void SetFont(const std::string_view& a_key, uint32_t a_addr)
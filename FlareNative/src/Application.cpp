@@ -5,6 +5,7 @@
 #include "AssetLibrary.h"
 #include "Config.h"
 #include "InputManager.h"
+#include "JobSystem.h"
 #include "Logger.h"
 #include "ObjectManager.h"
 #include "Profiler.h"
@@ -116,9 +117,11 @@ Application::Application(Config* a_config)
 
     m_inputManager = new InputManager(m_runtime);
 
-    m_objectManager = new ObjectManager(m_runtime);
+    m_jobSystem = new JobSystem(m_runtime);
 
-    m_renderEngine = new RenderEngine(m_runtime, m_objectManager, m_appWindow, m_config);
+    m_objectManager = new ObjectManager(m_runtime, m_jobSystem);
+
+    m_renderEngine = new RenderEngine(m_runtime, m_objectManager, m_jobSystem, m_appWindow, m_config);
 
     APPLICATION_BINDING_FUNCTION_TABLE(APPLICATION_RUNTIME_ATTACH);
 
@@ -134,9 +137,12 @@ Application::~Application()
     // Gonna guess a side effect of having execution outside of the scope of what GCC can predict at compile time
     // Do not know why C++ does not have a standard way to disable reordering
     // TLDR: Do not inline otherwise crash
+    // Workers are attached to mono so have to be gone before the runtime cleans up
+    m_jobSystem->Shutdown();
     PlzNoReorder(m_runtime);
     delete m_renderEngine;
     delete m_objectManager;
+    delete m_jobSystem;
     delete m_inputManager;
     delete m_config;
 
@@ -168,6 +174,8 @@ void Application::Run(int32_t a_argc, char* a_argv[])
             }
 
             m_runtime->Update(m_appWindow->GetDelta(), m_appWindow->GetTime());
+
+            m_renderEngine->PublishFrame();
         }
 
         Profiler::Stop();
@@ -38,14 +38,11 @@ AssetLibrary::AssetLibrary()
 }
 AssetLibrary::~AssetLibrary()
 {
-    for (uint32_t i = 0; i < m_fonts.Size(); ++i)
+    for (const Font* font : m_fonts.ToVector())
     {
-        if (m_fonts[i] != nullptr)
-        {
-            Logger::Warning("Font not destroyed");
+        Logger::Warning("Font not destroyed");
 
-            delete m_fonts[i];
-        }
+        delete font;
     }
 }
 
@@ -55,38 +52,16 @@ uint32_t AssetLibrary::GenerateFont(const std::string_view& a_path)
 
     Font* font = new Font(a_path);
 
-    uint32_t size = 0;
-    {
-        TLockArray<Font*> a = Instance->m_fonts.ToLockArray();
-        
-        size = a.Size();
-        for (uint32_t i = 0; i < size; ++i)
-        {
-            if (a[i] == nullptr)
-            {
-                a[i] = font;
-
-                return i;
-            }
-        }
-    }
-
-    Instance->m_fonts.Push(font);
-
-    return size;
+    return Instance->m_fonts.Insert(font);
 }
 Font* AssetLibrary::GetFont(uint32_t a_addr)
 {
-    FLARE_ASSERT_MSG(a_addr < Instance->m_fonts.Size(), "GetFont out of bounds");
-
-    return Instance->m_fonts[a_addr];
+    return Instance->m_fonts.Get(a_addr);
 }
 void AssetLibrary::DestroyFont(uint32_t a_addr)
 {
-    FLARE_ASSERT_MSG(a_addr < Instance->m_fonts.Size(), "DestroyFont out of bounds");
-
-    Font* font = Instance->m_fonts[a_addr];
-    Instance->m_fonts[a_addr] = nullptr;
+    const Font* font = Instance->m_fonts.Erase(a_addr);
+    FLARE_ASSERT_MSG(font != nullptr, "DestroyFont invalid address or already destroyed");
 
     delete font;
 }
\ No newline at end of file
@@ -31,6 +31,14 @@ Config::Config(const std::string_view& a_path)
                     m_renderingEngine = RenderingEngine_Null;
                 }
             }
+            else if (name == "FrameLatency")
+            {
+                uint32_t latency;
+                if (element->QueryUnsignedText(&latency) == tinyxml2::XML_SUCCESS)
+                {
+                    m_frameLatency = latency < 1 ? 1 : (latency > 2 ? 2 : latency);
+                }
+            }
         }
     }
 }
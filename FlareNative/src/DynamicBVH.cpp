@@ -0,0 +1,336 @@
+#include "Maths/DynamicBVH.h"
+
+#include <algorithm>
+
+DynamicBVH::DynamicBVH(float a_margin)
+{
+    m_root = Null;
+    m_freeList = Null;
+    m_proxyCount = 0;
+
+    m_margin = a_margin;
+}
+DynamicBVH::~DynamicBVH()
+{
+
+}
+
+uint32_t DynamicBVH::AllocateNode()
+{
+    uint32_t index;
+    if (m_freeList != Null)
+    {
+        index = m_freeList;
+        m_freeList = m_nodes[index].Parent;
+    }
+    else
+    {
+        index = (uint32_t)m_nodes.size();
+        m_nodes.emplace_back();
+    }
+
+    Node& node = m_nodes[index];
+    node.Parent = Null;
+    node.Child1 = Null;
+    node.Child2 = Null;
+    node.Height = 0;
+    node.UserData = Null;
+
+    return index;
+}
+void DynamicBVH::FreeNode(uint32_t a_node)
+{
+    Node& node = m_nodes[a_node];
+    node.Parent = m_freeList;
+    node.Height = -1;
+
+    m_freeList = a_node;
+}
+
+void DynamicBVH::InsertLeaf(uint32_t a_leaf)
+{
+    if (m_root == Null)
+    {
+        m_root = a_leaf;
+        m_nodes[a_leaf].Parent = Null;
+
+        return;
+    }
+
+    const AABB leafBox = m_nodes[a_leaf].Box;
+
+    // Walks down picking whichever side costs the least surface area to put the leaf under
+    uint32_t index = m_root;
+    while (!m_nodes[index].IsLeaf())
+    {
+        const Node& node = m_nodes[index];
+
+        const float area = node.Box.SurfaceArea();
+        const float combinedArea = AABB::Union(node.Box, leafBox).SurfaceArea();
+
+        // Cost of making a new parent for this node and the leaf
+        const float cost = 2.0f * combinedArea;
+        // Anything lower down pays for this node growing
+        const float inheritanceCost = 2.0f * (combinedArea - area);
+
+        float childCost[2];
+        const uint32_t children[2] = { node.Child1, node.Child2 };
+        for (uint32_t i = 0; i < 2; ++i)
+        {
+            const Node& child = m_nodes[children[i]];
+
+            const float unionArea = AABB::Union(child.Box, leafBox).SurfaceArea();
+            if (child.IsLeaf())
+            {
+                childCost[i] = unionArea + inheritanceCost;
+            }
+            else
+            {
+                childCost[i] = unionArea - child.Box.SurfaceArea() + inheritanceCost;
+            }
+        }
+
+        if (cost < childCost[0] && cost < childCost[1])
+        {
+            break;
+        }
+
+        index = childCost[0] < childCost[1] ? children[0] : children[1];
+    }
+
+    const uint32_t sibling = index;
+
+    const uint32_t oldParent = m_nodes[sibling].Parent;
+    const uint32_t newParent = AllocateNode();
+
+    Node& parentNode = m_nodes[newParent];
+    parentNode.Parent = oldParent;
+    parentNode.Box = AABB::Union(leafBox, m_nodes[sibling].Box);
+    parentNode.Height = m_nodes[sibling].Height + 1;
+    parentNode.Child1 = sibling;
+    parentNode.Child2 = a_leaf;
+
+    if (oldParent != Null)
+    {
+        if (m_nodes[oldParent].Child1 == sibling)
+        {
+            m_nodes[oldParent].Child1 = newParent;
+        }
+        else
+        {
+            m_nodes[oldParent].Child2 = newParent;
+        }
+    }
+    else
+    {
+        m_root = newParent;
+    }
+
+    m_nodes[sibling].Parent = newParent;
+    m_nodes[a_leaf].Parent = newParent;
+
+    // Fix up the boxes and heights on the way back up
+    index = newParent;
+    while (index != Null)
+    {
+        index = Balance(index);
+
+        Node& node = m_nodes[index];
+        const Node& child1 = m_nodes[node.Child1];
+        const Node& child2 = m_nodes[node.Child2];
+
+        node.Height = 1 + std::max(child1.Height, child2.Height);
+        node.Box = AABB::Union(child1.Box, child2.Box);
+
+        index = node.Parent;
+    }
+}
+void DynamicBVH::RemoveLeaf(uint32_t a_leaf)
+{
+    if (a_leaf == m_root)
+    {
+        m_root = Null;
+
+        return;
+    }
+
+    const uint32_t parent = m_nodes[a_leaf].Parent;
+    const uint32_t grandParent = m_nodes[parent].Parent;
+    const uint32_t sibling = m_nodes[parent].Child1 == a_leaf ? m_nodes[parent].Child2 : m_nodes[parent].Child1;
+
+    FreeNode(parent);
+
+    if (grandParent == Null)
+    {
+        m_root = sibling;
+        m_nodes[sibling].Parent = Null;
+
+        return;
+    }
+
+    // Sibling takes the place of the parent
+    if (m_nodes[grandParent].Child1 == parent)
+    {
+        m_nodes[grandParent].Child1 = sibling;
+    }
+    else
+    {
+        m_nodes[grandParent].Child2 = sibling;
+    }
+    m_nodes[sibling].Parent = grandParent;
+
+    uint32_t index = grandParent;
+    while (index != Null)
+    {
+        index = Balance(index);
+
+        Node& node = m_nodes[index];
+        const Node& child1 = m_nodes[node.Child1];
+        const Node& child2 = m_nodes[node.Child2];
+
+        node.Box = AABB::Union(child1.Box, child2.Box);
+        node.Height = 1 + std::max(child1.Height, child2.Height);
+
+        index = node.Parent;
+    }
+}
+
+// Rotates whichever child is taller up if the two sides are more than one apart
+// Returns the node that is now where a_node was
+uint32_t DynamicBVH::Balance(uint32_t a_node)
+{
+    Node& a = m_nodes[a_node];
+    if (a.IsLeaf() || a.Height < 2)
+    {
+        return a_node;
+    }
+
+    const uint32_t iB = a.Child1;
+    const uint32_t iC = a.Child2;
+    Node& b = m_nodes[iB];
+    Node& c = m_nodes[iC];
+
+    const int32_t balance = c.Height - b.Height;
+
+    // Same thing both ways round so just swap which side is which
+    uint32_t iUp;
+    uint32_t iOther;
+    if (balance > 1)
+    {
+        iUp = iC;
+        iOther = iB;
+    }
+    else if (balance < -1)
+    {
+        iUp = iB;
+        iOther = iC;
+    }
+    else
+    {
+        return a_node;
+    }
+
+    Node& up = m_nodes[iUp];
+    const uint32_t iF = up.Child1;
+    const uint32_t iG = up.Child2;
+    Node& f = m_nodes[iF];
+    Node& g = m_nodes[iG];
+    Node& other = m_nodes[iOther];
+
+    // Up takes the place of a
+    up.Child1 = a_node;
+    up.Parent = a.Parent;
+    a.Parent = iUp;
+
+    if (up.Parent != Null)
+    {
+        Node& parent = m_nodes[up.Parent];
+        if (parent.Child1 == a_node)
+        {
+            parent.Child1 = iUp;
+        }
+        else
+        {
+            parent.Child2 = iUp;
+        }
+    }
+    else
+    {
+        m_root = iUp;
+    }
+
+    // Taller grandchild stays with up and the shorter one goes to a
+    uint32_t iKeep = iF;
+    uint32_t iGive = iG;
+    if (f.Height <= g.Height)
+    {
+        iKeep = iG;
+        iGive = iF;
+    }
+
+    Node& give = m_nodes[iGive];
+    const Node& keep = m_nodes[iKeep];
+
+    up.Child2 = iKeep;
+    if (iUp == iC)
+    {
+        a.Child2 = iGive;
+    }
+    else
+    {
+        a.Child1 = iGive;
+    }
+    give.Parent = a_node;
+
+    a.Box = AABB::Union(other.Box, give.Box);
+    a.Height = 1 + std::max(other.Height, give.Height);
+
+    up.Box = AABB::Union(a.Box, keep.Box);
+    up.Height = 1 + std::max(a.Height, keep.Height);
+
+    return iUp;
+}
+
+uint32_t DynamicBVH::CreateProxy(const AABB& a_box, uint32_t a_userData)
+{
+    const uint32_t proxy = AllocateNode();
+
+    Node& node = m_nodes[proxy];
+    node.Box = a_box.Expanded(m_margin);
+    node.UserData = a_userData;
+    node.Height = 0;
+
+    InsertLeaf(proxy);
+
+    ++m_proxyCount;
+
+    return proxy;
+}
+void DynamicBVH::DestroyProxy(uint32_t a_proxy)
+{
+    FLARE_ASSERT_MSG(a_proxy < m_nodes.size() && m_nodes[a_proxy].IsLeaf(), "DestroyProxy invalid proxy");
+
+    RemoveLeaf(a_proxy);
+    FreeNode(a_proxy);
+
+    --m_proxyCount;
+}
+bool DynamicBVH::MoveProxy(uint32_t a_proxy, const AABB& a_box)
+{
+    FLARE_ASSERT_MSG(a_proxy < m_nodes.size() && m_nodes[a_proxy].IsLeaf(), "MoveProxy invalid proxy");
+
+    // Still fits and has not shrunk so much that the fat box is mostly empty
+    const AABB& fatBox = m_nodes[a_proxy].Box;
+    if (fatBox.Contains(a_box) && a_box.Expanded(4.0f * m_margin).Contains(fatBox))
+    {
+        return false;
+    }
+
+    RemoveLeaf(a_proxy);
+
+    m_nodes[a_proxy].Box = a_box.Expanded(m_margin);
+
+    InsertLeaf(a_proxy);
+
+    return true;
+}
@@ -78,6 +78,39 @@ void HeadlessAppWindow::ProfilerCallback(const Profiler::PData& a_profilerData)
     }
 
     m_queuedMessages.Push(msg);
+
+    if (!m_sendProfileCounters)
+    {
+        return;
+    }
+
+    constexpr uint32_t CounterSize = sizeof(ProfileTCounter);
+
+    for (const ProfileCounter& pCounter : a_profilerData.Counters)
+    {
+        FlareBase::PipeMessage counterMsg;
+        counterMsg.Type = FlareBase::PipeMessageType_ProfileCounter;
+        counterMsg.Length = CounterSize;
+        counterMsg.Data = new char[CounterSize];
+
+        ProfileTCounter* counter = (ProfileTCounter*)counterMsg.Data;
+
+        for (int i = 0; i < nameSize; ++i)
+        {
+            counter->Scope[i] = a_profilerData.Name[i];
+        }
+        counter->Scope[nameSize] = 0;
+
+        const int counterNameSize = glm::min((int)pCounter.Name.size(), NameMax - 1);
+        for (int i = 0; i < counterNameSize; ++i)
+        {
+            counter->Name[i] = pCounter.Name[i];
+        }
+        counter->Name[counterNameSize] = 0;
+        counter->Value = pCounter.Value;
+
+        m_queuedMessages.Push(counterMsg);
+    }
 }
 
 HeadlessAppWindow::HeadlessAppWindow(Application* a_app) : AppWindow(a_app)
@@ -88,10 +121,14 @@ HeadlessAppWindow::HeadlessAppWindow(Application* a_app) : AppWindow(a_app)
 
     m_frameData = nullptr;
     m_unlockWindow = false;
+    m_sendProfileCounters = false;
     
     m_delta = 0.0;
     m_time = 0.0;
 
+    // Gets cleared every frame but keeps the memory so should not need to allocate after the first few frames
+    m_queuedMessages.Reserve(64);
+
     TRACE("Initialising IPC");
 
     const std::string addrStr = GetAddr(PipeName);
@@ -367,6 +404,17 @@ bool HeadlessAppWindow::PollMessage()
 
         break;
     }
+    case FlareBase::PipeMessageType_Capabilities:
+    {
+        if (msg.Length >= sizeof(uint32_t))
+        {
+            const uint32_t capabilities = *(uint32_t*)msg.Data;
+
+            m_sendProfileCounters = capabilities & 0b1 << FlareBase::PipeCapability_ProfileCounter;
+        }
+
+        break;
+    }
     case FlareBase::PipeMessageType_Null:
     {
         Logger::Warning("Engine: Null Message");
@@ -0,0 +1,318 @@
+#include "JobSystem.h"
+
+#include "Runtime/RuntimeManager.h"
+
+static constexpr uint32_t InitialQueueSize = 64;
+
+struct LocalQueue
+{
+    const JobSystem* System;
+    uint32_t         Index;
+};
+
+static thread_local LocalQueue ThreadQueue = { nullptr, 0 };
+
+JobSystem::JobSystem(RuntimeManager* a_runtime, uint32_t a_threadCount)
+{
+    m_runtime = a_runtime;
+
+    m_pending = 0;
+    m_shutdown = false;
+
+    uint32_t threadCount = a_threadCount;
+    if (threadCount <= 0)
+    {
+        const uint32_t cores = std::thread::hardware_concurrency();
+
+        threadCount = cores > 1 ? cores - 1 : 0;
+    }
+
+    m_queueCount = threadCount + 1;
+    m_queues = new JobQueue[m_queueCount];
+    for (uint32_t i = 0; i < m_queueCount; ++i)
+    {
+        JobQueue& queue = m_queues[i];
+
+        queue.Jobs.resize(InitialQueueSize);
+        queue.Head = 0;
+        queue.Count = 0;
+    }
+
+    m_threads.reserve(threadCount);
+    for (uint32_t i = 0; i < threadCount; ++i)
+    {
+        m_threads.emplace_back(&JobSystem::WorkerLoop, this, i);
+    }
+}
+JobSystem::~JobSystem()
+{
+    Shutdown();
+
+    delete[] m_queues;
+}
+
+void JobSystem::Shutdown()
+{
+    {
+        const std::unique_lock g = std::unique_lock(m_mutex);
+
+        m_shutdown = true;
+    }
+
+    m_signal.notify_all();
+
+    for (std::thread& thread : m_threads)
+    {
+        thread.join();
+    }
+
+    m_threads.clear();
+}
+
+uint32_t JobSystem::GetQueueIndex() const
+{
+    if (ThreadQueue.System == this)
+    {
+        return ThreadQueue.Index;
+    }
+
+    return m_queueCount - 1;
+}
+
+void JobSystem::Push(uint32_t a_queue, const Job* a_jobs, uint32_t a_count)
+{
+    JobQueue& queue = m_queues[a_queue];
+
+    const std::unique_lock g = std::unique_lock(queue.Lock);
+
+    uint32_t size = (uint32_t)queue.Jobs.size();
+    if (queue.Count + a_count > size)
+    {
+        while (queue.Count + a_count > size)
+        {
+            size *= 2;
+        }
+
+        // Unwraps the ring while moving it over
+        std::vector<Job> jobs = std::vector<Job>(size);
+        const uint32_t mask = (uint32_t)queue.Jobs.size() - 1;
+        for (uint32_t i = 0; i < queue.Count; ++i)
+        {
+            jobs[i] = queue.Jobs[(queue.Head + i) & mask];
+        }
+
+        queue.Jobs.swap(jobs);
+        queue.Head = 0;
+    }
+
+    const uint32_t mask = size - 1;
+    for (uint32_t i = 0; i < a_count; ++i)
+    {
+        queue.Jobs[(queue.Head + queue.Count++) & mask] = a_jobs[i];
+    }
+}
+bool JobSystem::Pop(uint32_t a_queue, Job* a_job)
+{
+    JobQueue& queue = m_queues[a_queue];
+
+    const std::unique_lock g = std::unique_lock(queue.Lock);
+    if (queue.Count <= 0)
+    {
+        return false;
+    }
+
+    const uint32_t mask = (uint32_t)queue.Jobs.size() - 1;
+    *a_job = queue.Jobs[(queue.Head + --queue.Count) & mask];
+
+    return true;
+}
+bool JobSystem::Steal(uint32_t a_queue, Job* a_job)
+{
+    JobQueue& queue = m_queues[a_queue];
+
+    const std::unique_lock g = std::unique_lock(queue.Lock);
+    if (queue.Count <= 0)
+    {
+        return false;
+    }
+
+    const uint32_t mask = (uint32_t)queue.Jobs.size() - 1;
+    *a_job = queue.Jobs[queue.Head];
+    queue.Head = (queue.Head + 1) & mask;
+    --queue.Count;
+
+    return true;
+}
+
+bool JobSystem::Take(uint32_t a_queue, const JobCounter* a_counter, Job* a_job)
+{
+    JobQueue& queue = m_queues[a_queue];
+
+    const std::unique_lock g = std::unique_lock(queue.Lock);
+
+    const uint32_t mask = (uint32_t)queue.Jobs.size() - 1;
+    for (uint32_t i = queue.Count; i > 0; --i)
+    {
+        Job& job = queue.Jobs[(queue.Head + i - 1) & mask];
+        if (job.Counter == a_counter)
+        {
+            *a_job = job;
+
+            // Last job fills the gap, does not matter much if the order gets shuffled a bit
+            job = queue.Jobs[(queue.Head + queue.Count - 1) & mask];
+            --queue.Count;
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void JobSystem::Execute(const Job& a_job)
+{
+    m_pending.fetch_sub(1, std::memory_order_relaxed);
+
+    a_job.Func(a_job.Data, a_job.Start, a_job.End);
+
+    if (a_job.Counter->m_count.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        // Goes through the lock so anyone about to sleep on the counter is either already waiting or sees it done
+        {
+            const std::unique_lock g = std::unique_lock(m_mutex);
+        }
+
+        m_signal.notify_all();
+    }
+}
+
+bool JobSystem::RunJob(uint32_t a_queue)
+{
+    Job job;
+    if (Pop(a_queue, &job))
+    {
+        Execute(job);
+
+        return true;
+    }
+
+    for (uint32_t i = 1; i < m_queueCount; ++i)
+    {
+        if (Steal((a_queue + i) % m_queueCount, &job))
+        {
+            Execute(job);
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void JobSystem::WorkerLoop(uint32_t a_index)
+{
+    // Jobs can end up calling into mono so attach once up front instead of every job having to
+    m_runtime->AttachThread();
+
+    ThreadQueue = { this, a_index };
+
+    while (true)
+    {
+        if (RunJob(a_index))
+        {
+            continue;
+        }
+
+        std::unique_lock g = std::unique_lock(m_mutex);
+        m_signal.wait(g, [&] { return m_shutdown || m_pending.load(std::memory_order_relaxed) > 0; });
+
+        if (m_shutdown)
+        {
+            g.unlock();
+
+            m_runtime->DetachThread();
+
+            return;
+        }
+    }
+}
+
+void JobSystem::Dispatch(JobCounter* a_counter, uint32_t a_count, uint32_t a_grainSize, TaskFunc a_task, void* a_data)
+{
+    if (a_count <= 0)
+    {
+        return;
+    }
+
+    constexpr uint32_t BatchSize = 64;
+
+    const uint32_t grain = a_grainSize > 0 ? a_grainSize : 1;
+    const uint32_t jobCount = (a_count + grain - 1) / grain;
+
+    // Counted before anything is visible so the counter cannot hit 0 while still handing out jobs
+    a_counter->m_count.fetch_add(jobCount, std::memory_order_acq_rel);
+    m_pending.fetch_add((int32_t)jobCount, std::memory_order_relaxed);
+
+    const uint32_t queue = GetQueueIndex();
+
+    Job jobs[BatchSize];
+    uint32_t start = 0;
+    while (start < a_count)
+    {
+        uint32_t batchCount = 0;
+        while (batchCount < BatchSize && start < a_count)
+        {
+            const uint32_t end = start + grain < a_count ? start + grain : a_count;
+
+            jobs[batchCount++] = { a_task, a_data, start, end, a_counter };
+
+            start = end;
+        }
+
+        Push(queue, jobs, batchCount);
+    }
+
+    {
+        const std::unique_lock g = std::unique_lock(m_mutex);
+    }
+
+    if (jobCount > 1)
+    {
+        m_signal.notify_all();
+    }
+    else
+    {
+        m_signal.notify_one();
+    }
+}
+
+void JobSystem::Wait(JobCounter* a_counter)
+{
+    const uint32_t queue = GetQueueIndex();
+
+    while (!a_counter->Done())
+    {
+        Job job;
+        bool found = false;
+        for (uint32_t i = 0; i < m_queueCount; ++i)
+        {
+            if (Take((queue + i) % m_queueCount, a_counter, &job))
+            {
+                found = true;
+
+                break;
+            }
+        }
+
+        if (found)
+        {
+            Execute(job);
+
+            continue;
+        }
+
+        // Whatever is left is already running somewhere else
+        std::unique_lock g = std::unique_lock(m_mutex);
+        m_signal.wait(g, [&] { return a_counter->Done(); });
+    }
+}
\ No newline at end of file
@@ -1,76 +1,62 @@
 #include "Rendering/MaterialRenderStack.h"
 
-#include "Rendering/MeshRenderBuffer.h"
+#include "Flare/FlareAssert.h"
 
-MaterialRenderStack::MaterialRenderStack(const MeshRenderBuffer& a_renderBuffer)
+MaterialRenderStack::MaterialRenderStack(uint32_t a_materialAddr)
 {
-    m_materialAddr = a_renderBuffer.MaterialAddr;
+    m_materialAddr = a_materialAddr;
+}
+MaterialRenderStack::~MaterialRenderStack()
+{
+
+}
 
+uint32_t MaterialRenderStack::AddModelBuffer(uint32_t a_modelAddr)
+{
     ModelBuffer buffer;
-    buffer.ModelAddr = a_renderBuffer.ModelAddr;
-    buffer.TransformAddr.emplace_back(a_renderBuffer.TransformAddr);
+    buffer.ModelAddr = a_modelAddr;
 
     m_modelBuffers.emplace_back(buffer);
+
+    return (uint32_t)m_modelBuffers.size() - 1;
 }
-MaterialRenderStack::~MaterialRenderStack()
+uint32_t MaterialRenderStack::AddTransform(uint32_t a_bufferIndex, uint32_t a_transformAddr, uint32_t a_meshAddr)
 {
+    FLARE_ASSERT_MSG(a_bufferIndex < m_modelBuffers.size(), "AddTransform out of bounds");
 
+    ModelBuffer& buffer = m_modelBuffers[a_bufferIndex];
+    buffer.TransformAddr.emplace_back(a_transformAddr);
+    buffer.MeshAddr.emplace_back(a_meshAddr);
+
+    return (uint32_t)buffer.TransformAddr.size() - 1;
 }
 
-bool MaterialRenderStack::Add(const MeshRenderBuffer& a_renderBuffer)
+uint32_t MaterialRenderStack::RemoveModelBuffer(uint32_t a_bufferIndex)
 {
-    if (m_materialAddr != a_renderBuffer.MaterialAddr)
-    {
-        return false;
-    }
+    FLARE_ASSERT_MSG(a_bufferIndex < m_modelBuffers.size(), "RemoveModelBuffer out of bounds");
 
-    const uint32_t bufferSize = (uint32_t)m_modelBuffers.size();
-    for (uint32_t i = 0; i < bufferSize; ++i)
+    const uint32_t last = (uint32_t)m_modelBuffers.size() - 1;
+    if (a_bufferIndex != last)
     {
-        if (m_modelBuffers[i].ModelAddr == a_renderBuffer.ModelAddr)
-        {
-            m_modelBuffers[i].TransformAddr.emplace_back(a_renderBuffer.TransformAddr);
-
-            return true;
-        }
+        m_modelBuffers[a_bufferIndex] = std::move(m_modelBuffers[last]);
     }
 
-    ModelBuffer buffer;
-    buffer.ModelAddr = a_renderBuffer.ModelAddr;
-    buffer.TransformAddr.emplace_back(a_renderBuffer.TransformAddr);
-
-    m_modelBuffers.emplace_back(buffer);
+    m_modelBuffers.pop_back();
 
-    return true;
+    return last;
 }
-bool MaterialRenderStack::Remove(const MeshRenderBuffer& a_renderBuffer)
+uint32_t MaterialRenderStack::RemoveTransform(uint32_t a_bufferIndex, uint32_t a_slot)
 {
-    if (m_materialAddr != a_renderBuffer.MaterialAddr)
-    {
-        return false;
-    }
+    FLARE_ASSERT_MSG(a_bufferIndex < m_modelBuffers.size(), "RemoveTransform out of bounds");
 
-    for (auto iter = m_modelBuffers.begin(); iter != m_modelBuffers.end(); ++iter)
-    {
-        if (iter->ModelAddr == a_renderBuffer.ModelAddr)
-        {
-            for (auto iIter = iter->TransformAddr.begin(); iIter != iter->TransformAddr.end(); ++iIter)
-            {
-                if (*iIter == a_renderBuffer.TransformAddr)
-                {
-                    iter->TransformAddr.erase(iIter);
-                    if (iter->TransformAddr.empty())
-                    {
-                        m_modelBuffers.erase(iter);
-                    }
+    ModelBuffer& buffer = m_modelBuffers[a_bufferIndex];
+    FLARE_ASSERT_MSG(a_slot < buffer.TransformAddr.size(), "RemoveTransform slot out of bounds");
 
-                    return true;
-                }
-            }
-
-            return false;
-        }
-    }
+    const uint32_t last = (uint32_t)buffer.TransformAddr.size() - 1;
+    buffer.TransformAddr[a_slot] = buffer.TransformAddr[last];
+    buffer.TransformAddr.pop_back();
+    buffer.MeshAddr[a_slot] = buffer.MeshAddr[last];
+    buffer.MeshAddr.pop_back();
 
-    return false;
+    return last;
 }
\ No newline at end of file
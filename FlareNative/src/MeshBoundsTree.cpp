@@ -0,0 +1,156 @@
+#include "Rendering/MeshBoundsTree.h"
+
+#include "ObjectManager.h"
+
+MeshBoundsTree::MeshBoundsTree()
+{
+    m_publishNumber = 0;
+}
+MeshBoundsTree::~MeshBoundsTree()
+{
+
+}
+
+void MeshBoundsTree::UMarkChanged(uint32_t a_meshAddr)
+{
+    const uint64_t pending = m_publishNumber + 1;
+
+    m_meshes[a_meshAddr].ChangedPublish = pending;
+    m_changes[pending % ChangeHistory].emplace_back(a_meshAddr);
+}
+
+void MeshBoundsTree::AddMesh(uint32_t a_meshAddr, uint32_t a_transformAddr, const AABB& a_modelBounds, const glm::mat4& a_world)
+{
+    const std::unique_lock g = std::unique_lock(m_lock);
+
+    if (a_meshAddr >= m_meshes.size())
+    {
+        m_meshes.resize(a_meshAddr + 1, { DynamicBVH::Null, (uint32_t)-1, AABB(), AABB(), 0 });
+    }
+
+    MeshBounds& mesh = m_meshes[a_meshAddr];
+    FLARE_ASSERT_MSG(mesh.Proxy == DynamicBVH::Null, "MeshBoundsTree mesh already added");
+
+    // Models without any vertices still need to be somewhere
+    mesh.ModelBounds = a_modelBounds.Valid() ? a_modelBounds : AABB(glm::vec3(0.0f), glm::vec3(0.0f));
+    mesh.TransformAddr = a_transformAddr;
+    mesh.WorldBounds = mesh.ModelBounds.Transformed(a_world);
+    mesh.Proxy = m_tree.CreateProxy(mesh.WorldBounds, a_meshAddr);
+
+    m_transformMeshes[a_transformAddr].emplace_back(a_meshAddr);
+
+    UMarkChanged(a_meshAddr);
+}
+void MeshBoundsTree::RemoveMesh(uint32_t a_meshAddr)
+{
+    const std::unique_lock g = std::unique_lock(m_lock);
+
+    if (a_meshAddr >= m_meshes.size() || m_meshes[a_meshAddr].Proxy == DynamicBVH::Null)
+    {
+        return;
+    }
+
+    MeshBounds& mesh = m_meshes[a_meshAddr];
+
+    m_tree.DestroyProxy(mesh.Proxy);
+    mesh.Proxy = DynamicBVH::Null;
+
+    UMarkChanged(a_meshAddr);
+
+    const auto iter = m_transformMeshes.find(mesh.TransformAddr);
+    if (iter != m_transformMeshes.end())
+    {
+        std::vector<uint32_t>& meshes = iter->second;
+        for (uint32_t& addr : meshes)
+        {
+            if (addr == a_meshAddr)
+            {
+                addr = meshes.back();
+                meshes.pop_back();
+
+                break;
+            }
+        }
+
+        if (meshes.empty())
+        {
+            m_transformMeshes.erase(iter);
+        }
+    }
+
+    mesh.TransformAddr = -1;
+}
+
+uint32_t MeshBoundsTree::Refit(const std::vector<uint32_t>& a_movedTransforms, const TSnapshot<uint32_t>& a_transformSlots, const TSnapshot<glm::mat4>& a_worldMatrices, uint64_t a_publishNumber)
+{
+    const std::unique_lock g = std::unique_lock(m_lock);
+
+    FLARE_ASSERT_MSG(a_publishNumber == m_publishNumber + 1, "MeshBoundsTree refit out of order");
+
+    uint32_t reinserted = 0;
+    for (const uint32_t transformAddr : a_movedTransforms)
+    {
+        if (m_transformMeshes.empty())
+        {
+            break;
+        }
+
+        const auto iter = m_transformMeshes.find(transformAddr);
+        if (iter == m_transformMeshes.end())
+        {
+            continue;
+        }
+
+        const glm::mat4 world = ObjectManager::GetGlobalMatrix(a_transformSlots, a_worldMatrices, transformAddr);
+        for (const uint32_t meshAddr : iter->second)
+        {
+            MeshBounds& mesh = m_meshes[meshAddr];
+
+            mesh.WorldBounds = mesh.ModelBounds.Transformed(world);
+            if (m_tree.MoveProxy(mesh.Proxy, mesh.WorldBounds))
+            {
+                ++reinserted;
+            }
+
+            UMarkChanged(meshAddr);
+        }
+    }
+
+    // Whatever was in the next slot is too old to be asked for now
+    m_publishNumber = a_publishNumber;
+    m_changes[(m_publishNumber + 1) % ChangeHistory].clear();
+
+    return reinserted;
+}
+
+bool MeshBoundsTree::RayCast(const Ray& a_ray, float a_maxDistance, MeshRayHit* a_hit) const
+{
+    const std::shared_lock g = std::shared_lock(m_lock);
+
+    MeshRayHit closest = { (uint32_t)-1, a_maxDistance };
+
+    m_tree.RayCast(a_ray, a_maxDistance, [&](uint32_t a_meshAddr, float a_distance) -> float
+    {
+        // Fat box got hit but that does not mean the actual bounds did
+        float distance;
+        if (a_ray.Intersects(m_meshes[a_meshAddr].WorldBounds, closest.Distance, &distance) && distance < closest.Distance)
+        {
+            closest.MeshAddr = a_meshAddr;
+            closest.Distance = distance;
+        }
+
+        return closest.Distance;
+    });
+
+    if (closest.MeshAddr == -1)
+    {
+        return false;
+    }
+
+    if (a_hit != nullptr)
+    {
+        *a_hit = closest;
+    }
+
+    return true;
+}
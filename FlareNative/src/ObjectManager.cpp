@@ -1,9 +1,42 @@
 #include "ObjectManager.h"
 
+#include <cstddef>
+#include <mutex>
+
 #include "Flare/FlareAssert.h"
+#include "JobSystem.h"
+#include "Maths/TransformKernel.h"
 #include "Runtime/RuntimeManager.h"
 #include "Trace.h"
 
+// Enough work per chunk that handing it to another thread is worth it
+static constexpr uint32_t ComposeGrainSize = 256;
+static constexpr uint32_t ResolveGrainSize = 1024;
+
+// Moving a slot is a handful of link fixups so this keeps compaction from ever showing up in a tick
+static constexpr uint32_t CompactionBudget = 256;
+
+// Kernel takes plain floats so the glm types need to line up with what it expects
+static_assert(sizeof(glm::vec3) == sizeof(float) * 3, "TransformKernel vec3 layout");
+static_assert(sizeof(glm::quat) == sizeof(float) * 4 && offsetof(glm::quat, w) == sizeof(float) * 3, "TransformKernel needs GLM_FORCE_QUAT_DATA_XYZW");
+static_assert(sizeof(glm::mat4) == sizeof(float) * 16, "TransformKernel mat4 layout");
+
+// C# works out where things are in the page itself
+static_assert(sizeof(TransformBuffer) == 44, "TransformBuffer needs to match Transform.cs");
+static_assert(offsetof(TransformPage, DirtyBits) == sizeof(TransformBuffer) * TransformPageSize, "TransformPage needs to match Transform.cs");
+
+static inline uint32_t CountTrailingZeros(uint64_t a_value)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanForward64(&index, a_value);
+
+    return (uint32_t)index;
+#else
+    return (uint32_t)__builtin_ctzll(a_value);
+#endif
+}
+
 static ObjectManager* OManager = nullptr;
 
 #define OBJECTMANAGER_RUNTIME_ATTACH(ret, namespace, klass, name, code, ...) a_runtime->BindFunction(RUNTIME_FUNCTION_STRING(namespace, klass, name), (void*)RUNTIME_FUNCTION_NAME(klass, name));
@@ -12,65 +45,692 @@ static ObjectManager* OManager = nullptr;
     F(uint32_t, FlareEngine, Transform, GenerateTransformBuffer, { return OManager->CreateTransformBuffer(); }) \
     F(TransformBuffer, FlareEngine, Transform, GetTransformBuffer, { return OManager->GetTransformBuffer(a_addr); }, uint32_t a_addr) \
     F(void, FlareEngine, Transform, SetTransformBuffer, { OManager->SetTransformBuffer(a_addr, a_buffer); }, uint32_t a_addr, TransformBuffer a_buffer) \
-    F(void, FlareEngine, Transform, DestroyTransformBuffer, { OManager->DestroyTransformBuffer(a_addr); }, uint32_t a_addr)
+    F(void, FlareEngine, Transform, DestroyTransformBuffer, { OManager->DestroyTransformBuffer(a_addr); }, uint32_t a_addr) \
+    F(void*, FlareEngine, Transform, GetTransformPage, { return OManager->GetTransformPage(a_page); }, uint32_t a_page)
 
 OBJECTMANAGER_BINDING_FUNCTION_TABLE(RUNTIME_FUNCTION_DEFINITION);
 
-ObjectManager::ObjectManager(RuntimeManager* a_runtime)
+ObjectManager::ObjectManager(RuntimeManager* a_runtime, JobSystem* a_jobSystem)
 {
     OManager = this;
 
+    m_jobSystem = a_jobSystem;
+
+    m_transformCount = 0;
+    m_liveCount = 0;
+    m_compactionMoves = 0;
+
     TRACE("Binding Object functions to C#");
     OBJECTMANAGER_BINDING_FUNCTION_TABLE(OBJECTMANAGER_RUNTIME_ATTACH);
 }
 ObjectManager::~ObjectManager()
 {
+    for (const TransformPage* page : m_transformPages)
+    {
+        delete page;
+    }
+}
+
+bool ObjectManager::UTakeDirtyBit(uint32_t a_addr)
+{
+    uint64_t& word = m_transformPages[a_addr / TransformPageSize]->DirtyBits[(a_addr % TransformPageSize) / 64];
+    const uint64_t bit = 0b1ULL << (a_addr % 64);
+
+    if (!(word & bit))
+    {
+        return false;
+    }
+
+    word &= ~bit;
+
+    return true;
+}
+void ObjectManager::UConsumeDirtyBits()
+{
+    const uint32_t* slots = m_transformSlots.Data();
+
+    // Few enough words that going through all of them is cheaper than C# keeping a list
+    const uint32_t pageCount = (uint32_t)m_transformPages.size();
+    for (uint32_t i = 0; i < pageCount; ++i)
+    {
+        uint64_t* dirtyBits = m_transformPages[i]->DirtyBits;
+        for (uint32_t j = 0; j < TransformPageDirtyWords; ++j)
+        {
+            uint64_t bits = dirtyBits[j];
+            if (bits == 0)
+            {
+                continue;
+            }
+
+            dirtyBits[j] = 0;
+
+            while (bits != 0)
+            {
+                const uint32_t addr = i * TransformPageSize + j * 64 + CountTrailingZeros(bits);
+                bits &= bits - 1;
+
+                const uint32_t slot = slots[addr];
+                if (slot == -1)
+                {
+                    continue;
+                }
+
+                m_transformNodes[slot].LocalDirty = true;
+                UMarkWorldDirty(slot);
+            }
+        }
+    }
+}
+
+void ObjectManager::UUnlinkTransform(uint32_t a_slot)
+{
+    TransformNode& node = m_transformNodes[a_slot];
+    if (node.Parent == -1)
+    {
+        return;
+    }
+
+    if (node.PrevSibling != -1)
+    {
+        m_transformNodes[node.PrevSibling].NextSibling = node.NextSibling;
+    }
+    else
+    {
+        m_transformNodes[node.Parent].FirstChild = node.NextSibling;
+    }
+
+    if (node.NextSibling != -1)
+    {
+        m_transformNodes[node.NextSibling].PrevSibling = node.PrevSibling;
+    }
+
+    node.Parent = -1;
+    node.NextSibling = -1;
+    node.PrevSibling = -1;
+}
+void ObjectManager::ULinkTransform(uint32_t a_slot, uint32_t a_parent)
+{
+    if (a_parent == -1)
+    {
+        return;
+    }
+
+    FLARE_ASSERT_MSG(a_parent < m_transformNodes.size(), "Transform parent out of bounds");
+    FLARE_ASSERT_MSG(a_parent != a_slot, "Transform parented to itself");
+
+    TransformNode& node = m_transformNodes[a_slot];
+    TransformNode& parent = m_transformNodes[a_parent];
+
+    node.Parent = a_parent;
+    node.PrevSibling = -1;
+    node.NextSibling = parent.FirstChild;
+
+    if (parent.FirstChild != -1)
+    {
+        m_transformNodes[parent.FirstChild].PrevSibling = a_slot;
+    }
+
+    parent.FirstChild = a_slot;
+}
+void ObjectManager::UAddToLevel(uint32_t a_slot, uint32_t a_depth)
+{
+    if (a_depth >= m_levels.size())
+    {
+        m_levels.resize(a_depth + 1);
+        m_dirtyLevels.resize(a_depth + 1);
+    }
+
+    TransformNode& node = m_transformNodes[a_slot];
+    node.Depth = a_depth;
+    node.LevelIndex = (uint32_t)m_levels[a_depth].size();
+
+    m_levels[a_depth].emplace_back(a_slot);
+}
+void ObjectManager::URemoveFromLevel(uint32_t a_slot)
+{
+    const TransformNode& node = m_transformNodes[a_slot];
+
+    // Order within a level does not matter so the last one can fill the gap
+    std::vector<uint32_t>& level = m_levels[node.Depth];
+    const uint32_t last = level.back();
+
+    level[node.LevelIndex] = last;
+    m_transformNodes[last].LevelIndex = node.LevelIndex;
+
+    level.pop_back();
+}
+void ObjectManager::USetSubtreeDepth(uint32_t a_slot, uint32_t a_depth)
+{
+    TransformNode* nodes = m_transformNodes.data();
+
+    UWalkSubtree(a_slot, [&](uint32_t a_cur) -> bool
+    {
+        const uint32_t depth = a_cur == a_slot ? a_depth : nodes[nodes[a_cur].Parent].Depth + 1;
+
+        // Same depth means everything under it is already right as well
+        if (nodes[a_cur].Depth == depth)
+        {
+            return false;
+        }
+
+        URemoveFromLevel(a_cur);
+        UAddToLevel(a_cur, depth);
+
+        return true;
+    });
+}
+void ObjectManager::UMarkWorldDirty(uint32_t a_slot)
+{
+    TransformNode* nodes = m_transformNodes.data();
+
+    // Anything already dirty is skipped as everything under it is already dirty
+    UWalkSubtree(a_slot, [&](uint32_t a_cur) -> bool
+    {
+        TransformNode& node = nodes[a_cur];
+        if (node.WorldDirty)
+        {
+            return false;
+        }
+
+        node.WorldDirty = true;
+        if (!node.Queued)
+        {
+            node.Queued = true;
+            m_dirtyTransforms.emplace_back(a_cur);
+        }
+
+        return true;
+    });
+}
+void ObjectManager::UComposeLocalMatrices(uint32_t a_start, uint32_t a_end)
+{
+    // Each range packs into its own slice of the compose arrays so ranges can run side by side
+    uint32_t count = 0;
+
+    for (uint32_t i = a_start; i < a_end; ++i)
+    {
+        const uint32_t slot = m_dirtyTransforms[i];
+
+        TransformNode& node = m_transformNodes[slot];
+        node.Queued = false;
+
+        // Destroyed after it was queued
+        if (!node.LocalDirty || node.Handle == -1)
+        {
+            continue;
+        }
+
+        const TransformBuffer& buffer = UGetTransformBuffer(node.Handle);
+
+        const uint32_t index = a_start + count++;
+        m_composeSlots[index] = slot;
+        m_composeTranslations[index] = buffer.Translation;
+        m_composeRotations[index] = buffer.Rotation;
+        m_composeScales[index] = buffer.Scale;
+
+        node.LocalDirty = false;
+    }
+
+    if (count <= 0)
+    {
+        return;
+    }
+
+    TransformKernel::ComposeTRS((const float*)(m_composeTranslations.data() + a_start), (const float*)(m_composeRotations.data() + a_start), (const float*)(m_composeScales.data() + a_start), count, (float*)(m_composeMatrices.data() + a_start), (float*)(m_composeInverses.data() + a_start));
+
+    for (uint32_t i = a_start; i < a_start + count; ++i)
+    {
+        TransformNode& node = m_transformNodes[m_composeSlots[i]];
+
+        node.Local = m_composeMatrices[i];
+        node.InvLocal = m_composeInverses[i];
+    }
+}
+void ObjectManager::UResolveLevelNode(uint32_t a_slot, glm::mat4* a_worldMatrices, glm::mat4* a_worldInverses)
+{
+    TransformNode& node = m_transformNodes[a_slot];
+    if (!node.WorldDirty)
+    {
+        return;
+    }
+
+    // Parent is a level up so it is already done
+    if (node.Parent != -1)
+    {
+        a_worldMatrices[a_slot] = a_worldMatrices[node.Parent] * node.Local;
+        a_worldInverses[a_slot] = node.InvLocal * a_worldInverses[node.Parent];
+    }
+    else
+    {
+        a_worldMatrices[a_slot] = node.Local;
+        a_worldInverses[a_slot] = node.InvLocal;
+    }
+
+    node.WorldDirty = false;
+}
+const glm::mat4& ObjectManager::UResolveWorldMatrix(uint32_t a_slot, TLockArray<glm::mat4>& a_worldMatrices, TLockArray<glm::mat4>& a_worldInverses)
+{
+    TransformNode& node = m_transformNodes[a_slot];
+    if (node.WorldDirty)
+    {
+        // Only hit when something asks for a single matrix in the middle of a tick
+        if (node.LocalDirty)
+        {
+            const TransformBuffer& buffer = UGetTransformBuffer(node.Handle);
+
+            TransformKernel::ComposeTRS((const float*)&buffer.Translation, (const float*)&buffer.Rotation, (const float*)&buffer.Scale, 1, (float*)&node.Local, (float*)&node.InvLocal);
+            node.LocalDirty = false;
+        }
+
+        // Parents get resolved first so a clean node never sits under a dirty one
+        // Inverse of parent * local is inverse local * inverse parent so there is never a full inverse
+        if (node.Parent != -1)
+        {
+            a_worldMatrices[a_slot] = UResolveWorldMatrix(node.Parent, a_worldMatrices, a_worldInverses) * node.Local;
+            a_worldInverses[a_slot] = node.InvLocal * a_worldInverses[node.Parent];
+        }
+        else
+        {
+            a_worldMatrices[a_slot] = node.Local;
+            a_worldInverses[a_slot] = node.InvLocal;
+        }
+
+        node.WorldDirty = false;
+    }
+
+    return a_worldMatrices[a_slot];
+}
+
+void ObjectManager::UResolveDirty(uint32_t a_dirtyCount)
+{
+    // Local matrices do not depend on each other so they can all go at once
+    m_composeSlots.resize(a_dirtyCount);
+    m_composeTranslations.resize(a_dirtyCount);
+    m_composeRotations.resize(a_dirtyCount);
+    m_composeScales.resize(a_dirtyCount);
+    m_composeMatrices.resize(a_dirtyCount);
+    m_composeInverses.resize(a_dirtyCount);
+
+    m_jobSystem->ParallelFor(a_dirtyCount, ComposeGrainSize, [&](uint32_t a_start, uint32_t a_end)
+    {
+        UComposeLocalMatrices(a_start, a_end);
+    });
+
+    // Only the dirty slots get written so only their pages get copied into the next snapshot
+    TLockArray<glm::mat4> worldMatrices = m_worldMatrices.ToUntrackedLockArray();
+    TLockArray<glm::mat4> worldInverses = m_worldInverses.ToUntrackedLockArray();
+
+    glm::mat4* worldMatrixData = &worldMatrices[0];
+    glm::mat4* worldInverseData = &worldInverses[0];
+
+    // When most of the scene has moved it is cheaper to go through the full levels than sort the dirty ones into levels
+    const bool fullLevels = a_dirtyCount * 4 >= (uint32_t)m_transformNodes.size();
+    if (!fullLevels)
+    {
+        for (const uint32_t slot : m_dirtyTransforms)
+        {
+            const TransformNode& node = m_transformNodes[slot];
+            if (node.WorldDirty)
+            {
+                m_dirtyLevels[node.Depth].emplace_back(slot);
+            }
+        }
+    }
+
+    const uint32_t levelCount = (uint32_t)m_levels.size();
+    for (uint32_t i = 0; i < levelCount; ++i)
+    {
+        std::vector<uint32_t>& level = fullLevels ? m_levels[i] : m_dirtyLevels[i];
+
+        m_jobSystem->ParallelFor((uint32_t)level.size(), ResolveGrainSize, [&](uint32_t a_start, uint32_t a_end)
+        {
+            for (uint32_t j = a_start; j < a_end; ++j)
+            {
+                UResolveLevelNode(level[j], worldMatrixData, worldInverseData);
+            }
+        });
+
+        if (!fullLevels)
+        {
+            level.clear();
+        }
+    }
+
+    // Anything that has been destroyed since it got queued is a hole now so only live ones get passed on
+    for (const uint32_t slot : m_dirtyTransforms)
+    {
+        m_worldMatrices.UMarkWritten(slot);
+        m_worldInverses.UMarkWritten(slot);
+
+        const uint32_t handle = m_transformNodes[slot].Handle;
+        if (handle != -1)
+        {
+            m_movedTransforms.emplace_back(handle);
+        }
+    }
+
+    m_dirtyTransforms.clear();
+}
+
+void ObjectManager::UMoveSlot(uint32_t a_from, uint32_t a_to)
+{
+    TransformNode* nodes = m_transformNodes.data();
 
+    TransformNode& node = nodes[a_to];
+    node = nodes[a_from];
+    nodes[a_from].Handle = -1;
+
+    // Everything that points at the old slot needs to point at the new one
+    if (node.PrevSibling != -1)
+    {
+        nodes[node.PrevSibling].NextSibling = a_to;
+    }
+    else if (node.Parent != -1)
+    {
+        nodes[node.Parent].FirstChild = a_to;
+    }
+
+    if (node.NextSibling != -1)
+    {
+        nodes[node.NextSibling].PrevSibling = a_to;
+    }
+
+    for (uint32_t child = node.FirstChild; child != -1; child = nodes[child].NextSibling)
+    {
+        nodes[child].Parent = a_to;
+    }
+
+    m_levels[node.Depth][node.LevelIndex] = a_to;
+
+    m_transformSlots.USet(node.Handle, a_to);
+    m_worldMatrices.USet(a_to, m_worldMatrices.Data()[a_from]);
+    m_worldInverses.USet(a_to, m_worldInverses.Data()[a_from]);
+}
+void ObjectManager::UTrimSlots()
+{
+    while (!m_transformNodes.empty() && m_transformNodes.back().Handle == -1)
+    {
+        m_transformNodes.pop_back();
+        m_worldMatrices.UPop();
+        m_worldInverses.UPop();
+    }
+}
+void ObjectManager::UCompact(uint32_t a_maxMoves)
+{
+    // Only called with nothing queued so the dirty list does not need fixing up
+    const std::unique_lock slotLock = std::unique_lock(m_transformSlots.Lock());
+    const std::unique_lock worldLock = std::unique_lock(m_worldMatrices.Lock());
+    const std::unique_lock inverseLock = std::unique_lock(m_worldInverses.Lock());
+
+    m_compactionMoves = 0;
+
+    UTrimSlots();
+
+    // Moves whatever is at the end into a hole until it runs out of holes or budget
+    while (m_compactionMoves < a_maxMoves && !m_freeSlots.empty())
+    {
+        const uint32_t hole = m_freeSlots.back();
+        m_freeSlots.pop_back();
+
+        // Already gone from trimming the end
+        if (hole >= m_transformNodes.size())
+        {
+            continue;
+        }
+
+        UMoveSlot((uint32_t)m_transformNodes.size() - 1, hole);
+        ++m_compactionMoves;
+
+        UTrimSlots();
+    }
 }
 
 uint32_t ObjectManager::CreateTransformBuffer()
 {
     constexpr TransformBuffer Buffer;
+    constexpr TransformNode Node = { glm::identity<glm::mat4>(), glm::identity<glm::mat4>(), (uint32_t)-1, (uint32_t)-1, (uint32_t)-1, (uint32_t)-1, (uint32_t)-1, 0, 0, false, false, false };
+
+    const std::unique_lock g = std::unique_lock(m_transformLock);
+
+    uint32_t addr;
 
     TRACE("Creating Transform Buffer");
     if (!m_freeTransforms.empty())
     {
-        const uint32_t add = m_freeTransforms.front();
+        addr = m_freeTransforms.front();
         m_freeTransforms.pop();
+    }
+    else
+    {
+        addr = m_transformCount++;
+        if (addr / TransformPageSize >= m_transformPages.size())
+        {
+            TRACE("Allocating Transform Page");
+
+            m_transformPages.emplace_back(new TransformPage());
+        }
+
+        m_transformSlots.Push(-1);
+    }
 
-        m_transformBuffer.LockSet(add, Buffer);
+    UGetTransformBuffer(addr) = Buffer;
+    UTakeDirtyBit(addr);
 
-        return add;
+    // Holes past the end have already been trimmed off
+    while (!m_freeSlots.empty() && m_freeSlots.back() >= m_transformNodes.size())
+    {
+        m_freeSlots.pop_back();
     }
 
-    TRACE("Allocating Transform Buffer");
+    uint32_t slot;
+    if (!m_freeSlots.empty())
+    {
+        slot = m_freeSlots.back();
+        m_freeSlots.pop_back();
 
-    m_transformBuffer.Push(Buffer);
+        // Could still be sitting in the dirty list from before it was destroyed
+        const bool queued = m_transformNodes[slot].Queued;
+        m_transformNodes[slot] = Node;
+        m_transformNodes[slot].Queued = queued;
+    }
+    else
+    {
+        TRACE("Allocating Transform Slot");
 
-    return m_transformBuffer.Size() - 1;
+        slot = (uint32_t)m_transformNodes.size();
+
+        m_transformNodes.emplace_back(Node);
+        m_worldMatrices.Push(glm::identity<glm::mat4>());
+        m_worldInverses.Push(glm::identity<glm::mat4>());
+    }
+
+    m_transformNodes[slot].Handle = addr;
+    m_transformSlots.LockSet(addr, slot);
+    ++m_liveCount;
+
+    UAddToLevel(slot, 0);
+
+    m_transformNodes[slot].LocalDirty = true;
+    UMarkWorldDirty(slot);
+
+    return addr;
 }
 TransformBuffer ObjectManager::GetTransformBuffer(uint32_t a_addr)
 {
-    FLARE_ASSERT_MSG(a_addr < m_transformBuffer.Size(), "GetTransformBuffer out of bounds");
+    const std::unique_lock g = std::unique_lock(m_transformLock);
+
+    FLARE_ASSERT_MSG(a_addr < m_transformCount, "GetTransformBuffer out of bounds");
 
-    return m_transformBuffer[a_addr];
+    return UGetTransformBuffer(a_addr);
 }
 void ObjectManager::SetTransformBuffer(uint32_t a_addr, const TransformBuffer& a_buffer)
 {
-    FLARE_ASSERT_MSG(a_addr < m_transformBuffer.Size(), "SetTransformBuffer out of bounds");
+    const std::unique_lock g = std::unique_lock(m_transformLock);
 
-    m_transformBuffer.LockSet(a_addr, a_buffer);
+    FLARE_ASSERT_MSG(a_addr < m_transformCount, "SetTransformBuffer out of bounds");
+
+    const uint32_t* slots = m_transformSlots.Data();
+
+    const uint32_t slot = slots[a_addr];
+    FLARE_ASSERT_MSG(slot != -1, "SetTransformBuffer destroyed transform");
+
+    UGetTransformBuffer(a_addr) = a_buffer;
+    UTakeDirtyBit(a_addr);
+
+    // C# only knows about addresses, everything internal goes by slot
+    const uint32_t parent = a_buffer.Parent != -1 ? slots[a_buffer.Parent] : -1;
+
+    TransformNode& node = m_transformNodes[slot];
+    if (node.Parent != parent)
+    {
+        UUnlinkTransform(slot);
+        ULinkTransform(slot, parent);
+
+        USetSubtreeDepth(slot, node.Parent != -1 ? m_transformNodes[node.Parent].Depth + 1 : 0);
+    }
+
+    node.LocalDirty = true;
+    UMarkWorldDirty(slot);
 }
 void ObjectManager::DestroyTransformBuffer(uint32_t a_addr)
 {
     TRACE("Destroying Transform Buffer");
 
+    const std::unique_lock g = std::unique_lock(m_transformLock);
+
+    FLARE_ASSERT_MSG(a_addr < m_transformCount, "DestroyTransformBuffer out of bounds");
+
+    const uint32_t slot = m_transformSlots.Data()[a_addr];
+    FLARE_ASSERT_MSG(slot != -1, "DestroyTransformBuffer destroyed transform");
+
+    UUnlinkTransform(slot);
+    URemoveFromLevel(slot);
+    UTakeDirtyBit(a_addr);
+
+    // Anything still attached gets treated as a root until it is set again so nothing follows a dead or reused address
+    uint32_t child = m_transformNodes[slot].FirstChild;
+    while (child != -1)
+    {
+        TransformNode& childNode = m_transformNodes[child];
+        const uint32_t next = childNode.NextSibling;
+
+        childNode.Parent = -1;
+        childNode.NextSibling = -1;
+        childNode.PrevSibling = -1;
+
+        USetSubtreeDepth(child, 0);
+        UMarkWorldDirty(child);
+
+        child = next;
+    }
+
+    // Left as a hole until compaction moves something into it or a new transform takes it
+    TransformNode& node = m_transformNodes[slot];
+    node.FirstChild = -1;
+    node.Handle = -1;
+    node.LocalDirty = false;
+    node.WorldDirty = false;
+
+    m_transformSlots.LockSet(a_addr, -1);
+    --m_liveCount;
+
+    m_freeSlots.emplace_back(slot);
     m_freeTransforms.emplace(a_addr);
 }
 
+TransformPage* ObjectManager::GetTransformPage(uint32_t a_page)
+{
+    const std::unique_lock g = std::unique_lock(m_transformLock);
+
+    FLARE_ASSERT_MSG(a_page < m_transformPages.size(), "GetTransformPage out of bounds");
+
+    return m_transformPages[a_page];
+}
+
 glm::mat4 ObjectManager::GetGlobalMatrix(uint32_t a_addr)
 {
-    FLARE_ASSERT_MSG(a_addr < m_transformBuffer.Size(), "GetGlobalMatrix out of bounds");
+    const std::unique_lock g = std::unique_lock(m_transformLock);
+
+    FLARE_ASSERT_MSG(a_addr < m_transformCount, "GetGlobalMatrix out of bounds");
+
+    const uint32_t slot = m_transformSlots.Data()[a_addr];
+    FLARE_ASSERT_MSG(slot != -1, "GetGlobalMatrix destroyed transform");
+
+    // Only the chain above matters so there is no need to go through every page for writes from C#
+    for (uint32_t cur = slot; cur != -1; cur = m_transformNodes[cur].Parent)
+    {
+        if (UTakeDirtyBit(m_transformNodes[cur].Handle))
+        {
+            m_transformNodes[cur].LocalDirty = true;
+            UMarkWorldDirty(cur);
+        }
+    }
 
-    return m_transformBuffer[a_addr].ToGlobalMat4(this);
-}
\ No newline at end of file
+    if (!m_transformNodes[slot].WorldDirty)
+    {
+        return m_worldMatrices[slot];
+    }
+
+    // Anything resolved here is still in the dirty list so gets marked as written when the tick resolves the rest
+    TLockArray<glm::mat4> worldMatrices = m_worldMatrices.ToUntrackedLockArray();
+    TLockArray<glm::mat4> worldInverses = m_worldInverses.ToUntrackedLockArray();
+
+    return UResolveWorldMatrix(slot, worldMatrices, worldInverses);
+}
+void ObjectManager::UpdateWorldMatrices()
+{
+    const std::unique_lock g = std::unique_lock(m_transformLock);
+
+    m_movedTransforms.clear();
+
+    UConsumeDirtyBits();
+
+    const uint32_t dirtyCount = (uint32_t)m_dirtyTransforms.size();
+    if (dirtyCount > 0)
+    {
+        UResolveDirty(dirtyCount);
+    }
+
+    // Nothing is queued at this point so it is safe to move things about
+    UCompact(CompactionBudget);
+}
+ObjectManager::TransformStats ObjectManager::GetTransformStats()
+{
+    const std::unique_lock g = std::unique_lock(m_transformLock);
+
+    TransformStats stats;
+    stats.Addresses = m_transformCount;
+    stats.Live = m_liveCount;
+    stats.Slots = (uint32_t)m_transformNodes.size();
+    stats.Holes = stats.Slots - stats.Live;
+    stats.CompactionMoves = m_compactionMoves;
+
+    return stats;
+}
+
+glm::mat4 ObjectManager::GetGlobalMatrix(const TSnapshot<uint32_t>& a_transformSlots, const TSnapshot<glm::mat4>& a_worldMatrices, uint32_t a_addr)
+{
+    FLARE_ASSERT_MSG(a_addr < a_transformSlots.Size(), "GetGlobalMatrix out of bounds");
+
+    // Can be destroyed in the same tick something still pointing at it was snapshot
+    const uint32_t slot = a_transformSlots[a_addr];
+    if (slot >= a_worldMatrices.Size())
+    {
+        return glm::identity<glm::mat4>();
+    }
+
+    return a_worldMatrices[slot];
+}
+glm::mat4 ObjectManager::GetGlobalInverse(const TSnapshot<uint32_t>& a_transformSlots, const TSnapshot<glm::mat4>& a_worldInverses, uint32_t a_addr)
+{
+    FLARE_ASSERT_MSG(a_addr < a_transformSlots.Size(), "GetGlobalInverse out of bounds");
+
+    // Can be destroyed in the same tick something still pointing at it was snapshot
+    const uint32_t slot = a_transformSlots[a_addr];
+    if (slot >= a_worldInverses.Size())
+    {
+        return glm::identity<glm::mat4>();
+    }
+
+    return a_worldInverses[slot];
+}
@@ -1,7 +1,9 @@
 #include "Profiler.h"
 
 #include <cassert>
+#include <cstdlib>
 #include <mutex>
+#include <new>
 
 #include "Logger.h"
 #include "Runtime/RuntimeManager.h"
@@ -10,6 +12,41 @@
 Profiler* Profiler::Instance = nullptr;
 Profiler::Callback* Profiler::CallbackFunc = nullptr;
 
+#ifdef FLARENATIVE_ENABLE_PROFILER
+void* operator new(std::size_t a_size)
+{
+    HeapAllocation::Count();
+
+    void* ptr = malloc(a_size > 0 ? a_size : 1);
+    if (ptr == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+
+    return ptr;
+}
+void* operator new[](std::size_t a_size)
+{
+    return operator new(a_size);
+}
+void operator delete(void* a_ptr) noexcept
+{
+    free(a_ptr);
+}
+void operator delete[](void* a_ptr) noexcept
+{
+    free(a_ptr);
+}
+void operator delete(void* a_ptr, std::size_t) noexcept
+{
+    free(a_ptr);
+}
+void operator delete[](void* a_ptr, std::size_t) noexcept
+{
+    free(a_ptr);
+}
+#endif
+
 FLARE_MONO_EXPORT(void, Profiler_StartFrame, MonoString* a_frameName)
 {
     char* str = mono_string_to_utf8(a_frameName);
@@ -66,6 +103,7 @@ void Profiler::Start(const std::string_view& a_name)
     if (iter != Instance->m_data.end())
     {
         iter->second->Frames.clear();
+        iter->second->Counters.clear();
     }
     else
     {
@@ -174,4 +212,42 @@ void Profiler::StopFrame()
 
     Logger::Error("FlareEngine: Profile Start End Frame mismatch");
 #endif
+}
+
+void Profiler::SetCounter(const std::string_view& a_name, uint64_t a_value)
+{
+#ifdef FLARENATIVE_ENABLE_PROFILER
+    const std::shared_lock lock = std::shared_lock(Instance->m_mutex);
+
+    const std::thread::id tID = std::this_thread::get_id();
+
+    const auto iter = Instance->m_data.find(tID);
+    if (iter == Instance->m_data.end())
+    {
+        Logger::Error("FlareEngine: Profiler not started on thread");
+
+        assert(0);
+    }
+
+    for (ProfileCounter& counter : iter->second->Counters)
+    {
+        if (counter.Name == a_name)
+        {
+            counter.Value = a_value;
+
+            return;
+        }
+    }
+
+    iter->second->Counters.emplace_back(ProfileCounter{ std::string(a_name), a_value });
+#endif
+}
+
+uint64_t Profiler::GetThreadAllocations()
+{
+#ifdef FLARENATIVE_ENABLE_PROFILER
+    return HeapAllocation::GetThreadAllocations();
+#else
+    return 0;
+#endif
 }
\ No newline at end of file
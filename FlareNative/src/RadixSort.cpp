@@ -0,0 +1,74 @@
+#include "Maths/RadixSort.h"
+
+#include <cstring>
+
+static constexpr uint32_t RadixBits = 8;
+static constexpr uint32_t RadixSize = 1 << RadixBits;
+static constexpr uint32_t RadixPasses = 64 / RadixBits;
+
+void RadixSort(uint64_t* a_keys, uint32_t* a_values, uint64_t* a_tempKeys, uint32_t* a_tempValues, uint32_t a_count)
+{
+    if (a_count <= 1)
+    {
+        return;
+    }
+
+    // Every pass gets counted in one go so the keys only get read once for all of them
+    uint32_t counts[RadixPasses][RadixSize];
+    memset(counts, 0, sizeof(counts));
+    for (uint32_t i = 0; i < a_count; ++i)
+    {
+        const uint64_t key = a_keys[i];
+        for (uint32_t j = 0; j < RadixPasses; ++j)
+        {
+            ++counts[j][(key >> (j * RadixBits)) & (RadixSize - 1)];
+        }
+    }
+
+    uint64_t* srcKeys = a_keys;
+    uint32_t* srcValues = a_values;
+    uint64_t* dstKeys = a_tempKeys;
+    uint32_t* dstValues = a_tempValues;
+
+    for (uint32_t i = 0; i < RadixPasses; ++i)
+    {
+        const uint32_t shift = i * RadixBits;
+        uint32_t* count = counts[i];
+
+        if (count[(srcKeys[0] >> shift) & (RadixSize - 1)] == a_count)
+        {
+            continue;
+        }
+
+        uint32_t offset = 0;
+        for (uint32_t j = 0; j < RadixSize; ++j)
+        {
+            const uint32_t c = count[j];
+            count[j] = offset;
+            offset += c;
+        }
+
+        for (uint32_t j = 0; j < a_count; ++j)
+        {
+            const uint64_t key = srcKeys[j];
+            const uint32_t index = count[(key >> shift) & (RadixSize - 1)]++;
+
+            dstKeys[index] = key;
+            dstValues[index] = srcValues[j];
+        }
+
+        uint64_t* tKeys = srcKeys;
+        srcKeys = dstKeys;
+        dstKeys = tKeys;
+
+        uint32_t* tValues = srcValues;
+        srcValues = dstValues;
+        dstValues = tValues;
+    }
+
+    if (srcKeys != a_keys)
+    {
+        memcpy(a_keys, srcKeys, a_count * sizeof(uint64_t));
+        memcpy(a_values, srcValues, a_count * sizeof(uint32_t));
+    }
+}
\ No newline at end of file
@@ -9,12 +9,13 @@
 #include "Rendering/Vulkan/VulkanRenderEngineBackend.h"
 #include "Trace.h"
 
-RenderEngine::RenderEngine(RuntimeManager* a_runtime, ObjectManager* a_objectManager, AppWindow* a_window, Config* a_config)
+RenderEngine::RenderEngine(RuntimeManager* a_runtime, ObjectManager* a_objectManager, JobSystem* a_jobSystem, AppWindow* a_window, Config* a_config)
 {
     TRACE("Initializing Rendering");
     m_config = a_config;
 
     m_objectManager = a_objectManager;
+    m_jobSystem = a_jobSystem;
 
     m_window = a_window;
 
@@ -98,6 +99,10 @@ void RenderEngine::Run()
     m_join = true;
     TRACE("Render Thread joining");
 }
+void RenderEngine::PublishFrame()
+{
+    m_backend->PublishFrame();
+}
 void RenderEngine::Update(double a_delta, double a_time)
 {
     m_backend->Update(a_delta, a_time);
@@ -0,0 +1,101 @@
+#include "Rendering/RenderStackIndex.h"
+
+#include "Flare/FlareAssert.h"
+#include "Rendering/MeshRenderBuffer.h"
+#include "Trace.h"
+
+RenderStackIndex::RenderStackIndex()
+{
+
+}
+RenderStackIndex::~RenderStackIndex()
+{
+
+}
+
+void RenderStackIndex::UAdd(TArray<MaterialRenderStack>* a_stacks, uint32_t a_meshAddr, const MeshRenderBuffer& a_buffer)
+{
+    if (a_meshAddr >= m_meshSlots.size())
+    {
+        m_meshSlots.resize(a_meshAddr + 1, -1);
+    }
+
+    FLARE_ASSERT_MSG(m_meshSlots[a_meshAddr] == -1, "RenderStack mesh already added");
+
+    uint32_t stackIndex;
+    const auto stackIter = m_stacks.find(a_buffer.MaterialAddr);
+    if (stackIter != m_stacks.end())
+    {
+        stackIndex = stackIter->second;
+    }
+    else
+    {
+        TRACE("Allocating RenderStack");
+        stackIndex = a_stacks->UPush(MaterialRenderStack(a_buffer.MaterialAddr));
+        m_stacks.emplace(a_buffer.MaterialAddr, stackIndex);
+    }
+
+    MaterialRenderStack& stack = a_stacks->UGet(stackIndex);
+
+    const auto [modelIter, inserted] = m_models.try_emplace(GetModelKey(a_buffer.MaterialAddr, a_buffer.ModelAddr));
+    if (inserted)
+    {
+        modelIter->second = stack.AddModelBuffer(a_buffer.ModelAddr);
+    }
+
+    m_meshSlots[a_meshAddr] = stack.AddTransform(modelIter->second, a_buffer.TransformAddr, a_meshAddr);
+}
+void RenderStackIndex::URemove(TArray<MaterialRenderStack>* a_stacks, uint32_t a_meshAddr, const MeshRenderBuffer& a_buffer)
+{
+    if (a_meshAddr >= m_meshSlots.size() || m_meshSlots[a_meshAddr] == -1)
+    {
+        return;
+    }
+
+    const uint32_t slot = m_meshSlots[a_meshAddr];
+    m_meshSlots[a_meshAddr] = -1;
+
+    const auto stackIter = m_stacks.find(a_buffer.MaterialAddr);
+    FLARE_ASSERT_MSG(stackIter != m_stacks.end(), "RenderStack missing material");
+    const auto modelIter = m_models.find(GetModelKey(a_buffer.MaterialAddr, a_buffer.ModelAddr));
+    FLARE_ASSERT_MSG(modelIter != m_models.end(), "RenderStack missing model");
+
+    const uint32_t stackIndex = stackIter->second;
+    const uint32_t bufferIndex = modelIter->second;
+
+    MaterialRenderStack& stack = a_stacks->UGet(stackIndex);
+
+    // Whatever was on the end gets moved into the hole so point it at where it is now
+    const uint32_t lastSlot = stack.RemoveTransform(bufferIndex, slot);
+    const ModelBuffer& modelBuffer = stack.GetModelBuffers()[bufferIndex];
+    if (slot != lastSlot)
+    {
+        m_meshSlots[modelBuffer.MeshAddr[slot]] = slot;
+    }
+
+    if (!modelBuffer.TransformAddr.empty())
+    {
+        return;
+    }
+
+    const uint32_t lastBuffer = stack.RemoveModelBuffer(bufferIndex);
+    m_models.erase(modelIter);
+    if (bufferIndex != lastBuffer)
+    {
+        const uint32_t movedModel = stack.GetModelBuffers()[bufferIndex].ModelAddr;
+        m_models.find(GetModelKey(a_buffer.MaterialAddr, movedModel))->second = bufferIndex;
+    }
+
+    if (!stack.Empty())
+    {
+        return;
+    }
+
+    TRACE("Destroying RenderStack");
+    const uint32_t lastStack = a_stacks->USwapErase(stackIndex);
+    m_stacks.erase(stackIter);
+    if (stackIndex != lastStack)
+    {
+        m_stacks.find(a_stacks->Data()[stackIndex].GetMaterialAddr())->second = stackIndex;
+    }
+}
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include <assert.h>
 #include <mono/metadata/debug-helpers.h>
 #include <mono/metadata/mono-config.h>
+#include <mono/metadata/threads.h>
 
 #include "Profiler.h"
 #include "Rendering/RenderEngine.h"
@@ -71,6 +72,14 @@ void RuntimeManager::AttachThread()
 {
     mono_jit_thread_attach(m_domain);
 }
+void RuntimeManager::DetachThread()
+{
+    MonoThread* thread = mono_thread_current();
+    if (thread != nullptr)
+    {
+        mono_thread_detach(thread);
+    }
+}
 
 MonoClass* RuntimeManager::GetClass(const std::string_view& a_namespace, const std::string_view& a_name) const
 {
@@ -156,11 +156,10 @@ uint32_t Scribe::GetFont(const std::string_view& a_key)
 {
     FLARE_ASSERT(Instance != nullptr);
 
-    const std::string key = std::string(a_key);
-
-    if (Instance->m_fonts.Exists(key))
+    uint32_t addr;
+    if (Instance->m_fonts.TryGet(a_key, &addr))
     {
-        return Instance->m_fonts[key];
+        return addr;
     }
 
     return -1;
@@ -169,15 +168,14 @@ uint32_t Scribe::GetFont(const std::string_view& a_key)
 std::u32string Scribe::GetString(const std::string_view& a_key)
 {
     FLARE_ASSERT(Instance != nullptr);
-        
-    const std::string key = std::string(a_key);
 
-    if (Instance->m_strings.Exists(key))
+    std::u32string str;
+    if (Instance->m_strings.TryGet(a_key, &str))
     {
-        return Instance->m_strings[key];
+        return str;
     }
 
-    return converter.from_bytes(key);
+    return converter.from_bytes(a_key.data(), a_key.data() + a_key.size());
 }
 std::u32string Scribe::GetStringFormated(const std::string_view& a_key, char32_t* const* a_args, uint32_t a_count)
 {
@@ -92,6 +92,29 @@ std::string GLSL_fromFShader(const std::string_view& a_str)
 				rStr = GLSL_PUSHBUFFER_STRING(args[1], GLSL_MODEL_SHADER_STRUCTURE);
 			}
 		}
+		else if (defName == "instancebuffer")
+		{
+			FLARE_ASSERT_MSG_R(args.size() == 4, "Flare Shader instance buffer requires 4 arguments");
+
+			// Indexed with gl_InstanceIndex
+			if (args[0] == "ModelBuffer")
+			{
+				rStr = GLSL_INSTANCEBUFFER_STRING(args[1], args[2], args[3], ModelShaderBuffer, GLSL_INSTANCE_MODEL_SHADER_STRUCTURE);
+			}
+		}
+		else if (defName == "clusterbuffer")
+		{
+			FLARE_ASSERT_MSG_R(args.size() == 4, "Flare Shader cluster buffer requires 4 arguments");
+
+			if (args[0] == "PointLightBuffer")
+			{
+				rStr = GLSL_CLUSTERBUFFER_STRING(args[1], args[2], args[3], PointLightShaderBuffer, GLSL_CLUSTER_POINT_LIGHT_SHADER_STRUCTURE);
+			}
+			else if (args[0] == "SpotLightBuffer")
+			{
+				rStr = GLSL_CLUSTERBUFFER_STRING(args[1], args[2], args[3], SpotLightShaderBuffer, GLSL_CLUSTER_SPOT_LIGHT_SHADER_STRUCTURE);
+			}
+		}
 
 		std::size_t next = 1;
 		if (!rStr.empty())
@@ -0,0 +1,362 @@
+#include "Maths/TransformKernel.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define FLARENATIVE_TRANSFORMKERNEL_X64
+
+#include <immintrin.h>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+
+// MSVC lets intrinsics through without needing the whole file built for it
+#define FLARENATIVE_TARGET_AVX2
+#else
+#define FLARENATIVE_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#endif
+#endif
+
+static void ComposeScalar(const float* a_translations, const float* a_rotations, const float* a_scales, uint32_t a_count, float* a_matrices, float* a_inverses)
+{
+    for (uint32_t i = 0; i < a_count; ++i)
+    {
+        const float* t = a_translations + i * 3;
+        const float* q = a_rotations + i * 4;
+        const float* s = a_scales + i * 3;
+        float* m = a_matrices + i * 16;
+
+        const float xx = q[0] * q[0];
+        const float yy = q[1] * q[1];
+        const float zz = q[2] * q[2];
+        const float xy = q[0] * q[1];
+        const float xz = q[0] * q[2];
+        const float yz = q[1] * q[2];
+        const float wx = q[3] * q[0];
+        const float wy = q[3] * q[1];
+        const float wz = q[3] * q[2];
+
+        // Same as glm::toMat4, rXY is column X row Y
+        const float r00 = 1.0f - 2.0f * (yy + zz);
+        const float r01 = 2.0f * (xy + wz);
+        const float r02 = 2.0f * (xz - wy);
+        const float r10 = 2.0f * (xy - wz);
+        const float r11 = 1.0f - 2.0f * (xx + zz);
+        const float r12 = 2.0f * (yz + wx);
+        const float r20 = 2.0f * (xz + wy);
+        const float r21 = 2.0f * (yz - wx);
+        const float r22 = 1.0f - 2.0f * (xx + yy);
+
+        m[0] = r00 * s[0];  m[1] = r01 * s[0];  m[2] = r02 * s[0];  m[3] = 0.0f;
+        m[4] = r10 * s[1];  m[5] = r11 * s[1];  m[6] = r12 * s[1];  m[7] = 0.0f;
+        m[8] = r20 * s[2];  m[9] = r21 * s[2];  m[10] = r22 * s[2]; m[11] = 0.0f;
+        m[12] = t[0];       m[13] = t[1];       m[14] = t[2];       m[15] = 1.0f;
+
+        if (a_inverses != nullptr)
+        {
+            float* inv = a_inverses + i * 16;
+
+            // Inverse is scale^-1 * rotation^T * translation^-1 so the rows are just the rotation columns over the scale
+            const float is0 = 1.0f / s[0];
+            const float is1 = 1.0f / s[1];
+            const float is2 = 1.0f / s[2];
+
+            inv[0] = r00 * is0;  inv[1] = r10 * is1;  inv[2] = r20 * is2;  inv[3] = 0.0f;
+            inv[4] = r01 * is0;  inv[5] = r11 * is1;  inv[6] = r21 * is2;  inv[7] = 0.0f;
+            inv[8] = r02 * is0;  inv[9] = r12 * is1;  inv[10] = r22 * is2; inv[11] = 0.0f;
+
+            inv[12] = -(r00 * t[0] + r01 * t[1] + r02 * t[2]) * is0;
+            inv[13] = -(r10 * t[0] + r11 * t[1] + r12 * t[2]) * is1;
+            inv[14] = -(r20 * t[0] + r21 * t[1] + r22 * t[2]) * is2;
+            inv[15] = 1.0f;
+        }
+    }
+}
+
+#ifdef FLARENATIVE_TRANSFORMKERNEL_X64
+// Takes one matrix column for 4 transforms with a row in each register and writes it out to each of the matrices
+static inline void StoreColumnSSE(float* a_matrices, uint32_t a_column, __m128 a_row0, __m128 a_row1, __m128 a_row2, __m128 a_row3)
+{
+    _MM_TRANSPOSE4_PS(a_row0, a_row1, a_row2, a_row3);
+
+    _mm_storeu_ps(a_matrices + 0 * 16 + a_column * 4, a_row0);
+    _mm_storeu_ps(a_matrices + 1 * 16 + a_column * 4, a_row1);
+    _mm_storeu_ps(a_matrices + 2 * 16 + a_column * 4, a_row2);
+    _mm_storeu_ps(a_matrices + 3 * 16 + a_column * 4, a_row3);
+}
+// Splits 4 packed vec3s into x, y and z registers
+static inline void LoadVec3SSE(const float* a_data, __m128* a_x, __m128* a_y, __m128* a_z)
+{
+    const __m128 a = _mm_loadu_ps(a_data + 0);
+    const __m128 b = _mm_loadu_ps(a_data + 4);
+    const __m128 c = _mm_loadu_ps(a_data + 8);
+
+    const __m128 t0 = _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 1, 3, 2));
+    const __m128 t1 = _mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 0, 2, 1));
+
+    *a_x = _mm_shuffle_ps(a, t0, _MM_SHUFFLE(2, 0, 3, 0));
+    *a_y = _mm_shuffle_ps(t1, t0, _MM_SHUFFLE(3, 1, 2, 0));
+    *a_z = _mm_shuffle_ps(t1, c, _MM_SHUFFLE(3, 0, 3, 1));
+}
+
+// SSE2 is always there on x64 so this does not need checking
+static uint32_t ComposeSSEBatch(const float* a_translations, const float* a_rotations, const float* a_scales, uint32_t a_count, float* a_matrices, float* a_inverses)
+{
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 two = _mm_set1_ps(2.0f);
+
+    uint32_t i = 0;
+    for (; i + 4 <= a_count; i += 4)
+    {
+        __m128 tx, ty, tz;
+        __m128 sx, sy, sz;
+        LoadVec3SSE(a_translations + i * 3, &tx, &ty, &tz);
+        LoadVec3SSE(a_scales + i * 3, &sx, &sy, &sz);
+
+        __m128 qx = _mm_loadu_ps(a_rotations + i * 4 + 0);
+        __m128 qy = _mm_loadu_ps(a_rotations + i * 4 + 4);
+        __m128 qz = _mm_loadu_ps(a_rotations + i * 4 + 8);
+        __m128 qw = _mm_loadu_ps(a_rotations + i * 4 + 12);
+        _MM_TRANSPOSE4_PS(qx, qy, qz, qw);
+
+        const __m128 xx = _mm_mul_ps(qx, qx);
+        const __m128 yy = _mm_mul_ps(qy, qy);
+        const __m128 zz = _mm_mul_ps(qz, qz);
+        const __m128 xy = _mm_mul_ps(qx, qy);
+        const __m128 xz = _mm_mul_ps(qx, qz);
+        const __m128 yz = _mm_mul_ps(qy, qz);
+        const __m128 wx = _mm_mul_ps(qw, qx);
+        const __m128 wy = _mm_mul_ps(qw, qy);
+        const __m128 wz = _mm_mul_ps(qw, qz);
+
+        const __m128 r00 = _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz)));
+        const __m128 r01 = _mm_mul_ps(two, _mm_add_ps(xy, wz));
+        const __m128 r02 = _mm_mul_ps(two, _mm_sub_ps(xz, wy));
+        const __m128 r10 = _mm_mul_ps(two, _mm_sub_ps(xy, wz));
+        const __m128 r11 = _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz)));
+        const __m128 r12 = _mm_mul_ps(two, _mm_add_ps(yz, wx));
+        const __m128 r20 = _mm_mul_ps(two, _mm_add_ps(xz, wy));
+        const __m128 r21 = _mm_mul_ps(two, _mm_sub_ps(yz, wx));
+        const __m128 r22 = _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy)));
+
+        float* m = a_matrices + i * 16;
+        StoreColumnSSE(m, 0, _mm_mul_ps(r00, sx), _mm_mul_ps(r01, sx), _mm_mul_ps(r02, sx), zero);
+        StoreColumnSSE(m, 1, _mm_mul_ps(r10, sy), _mm_mul_ps(r11, sy), _mm_mul_ps(r12, sy), zero);
+        StoreColumnSSE(m, 2, _mm_mul_ps(r20, sz), _mm_mul_ps(r21, sz), _mm_mul_ps(r22, sz), zero);
+        StoreColumnSSE(m, 3, tx, ty, tz, one);
+
+        if (a_inverses != nullptr)
+        {
+            const __m128 is0 = _mm_div_ps(one, sx);
+            const __m128 is1 = _mm_div_ps(one, sy);
+            const __m128 is2 = _mm_div_ps(one, sz);
+
+            const __m128 d0 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(r00, tx), _mm_mul_ps(r01, ty)), _mm_mul_ps(r02, tz));
+            const __m128 d1 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(r10, tx), _mm_mul_ps(r11, ty)), _mm_mul_ps(r12, tz));
+            const __m128 d2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(r20, tx), _mm_mul_ps(r21, ty)), _mm_mul_ps(r22, tz));
+
+            float* inv = a_inverses + i * 16;
+            StoreColumnSSE(inv, 0, _mm_mul_ps(r00, is0), _mm_mul_ps(r10, is1), _mm_mul_ps(r20, is2), zero);
+            StoreColumnSSE(inv, 1, _mm_mul_ps(r01, is0), _mm_mul_ps(r11, is1), _mm_mul_ps(r21, is2), zero);
+            StoreColumnSSE(inv, 2, _mm_mul_ps(r02, is0), _mm_mul_ps(r12, is1), _mm_mul_ps(r22, is2), zero);
+            StoreColumnSSE(inv, 3, _mm_sub_ps(zero, _mm_mul_ps(d0, is0)), _mm_sub_ps(zero, _mm_mul_ps(d1, is1)), _mm_sub_ps(zero, _mm_mul_ps(d2, is2)), one);
+        }
+    }
+
+    return i;
+}
+static void ComposeSSE(const float* a_translations, const float* a_rotations, const float* a_scales, uint32_t a_count, float* a_matrices, float* a_inverses)
+{
+    const uint32_t done = ComposeSSEBatch(a_translations, a_rotations, a_scales, a_count, a_matrices, a_inverses);
+
+    ComposeScalar(a_translations + done * 3, a_rotations + done * 4, a_scales + done * 3, a_count - done, a_matrices + done * 16, a_inverses != nullptr ? a_inverses + done * 16 : nullptr);
+}
+
+// Same as the SSE one but each 128 bit half ends up with a different set of 4 transforms
+FLARENATIVE_TARGET_AVX2 static inline void StoreColumnAVX2(float* a_matrices, uint32_t a_column, __m256 a_row0, __m256 a_row1, __m256 a_row2, __m256 a_row3)
+{
+    const __m256 t0 = _mm256_unpacklo_ps(a_row0, a_row1);
+    const __m256 t1 = _mm256_unpacklo_ps(a_row2, a_row3);
+    const __m256 t2 = _mm256_unpackhi_ps(a_row0, a_row1);
+    const __m256 t3 = _mm256_unpackhi_ps(a_row2, a_row3);
+
+    const __m256 c0 = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(1, 0, 1, 0));
+    const __m256 c1 = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(3, 2, 3, 2));
+    const __m256 c2 = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(1, 0, 1, 0));
+    const __m256 c3 = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(3, 2, 3, 2));
+
+    float* m = a_matrices + a_column * 4;
+    _mm_storeu_ps(m + 0 * 16, _mm256_castps256_ps128(c0));
+    _mm_storeu_ps(m + 1 * 16, _mm256_castps256_ps128(c1));
+    _mm_storeu_ps(m + 2 * 16, _mm256_castps256_ps128(c2));
+    _mm_storeu_ps(m + 3 * 16, _mm256_castps256_ps128(c3));
+    _mm_storeu_ps(m + 4 * 16, _mm256_extractf128_ps(c0, 1));
+    _mm_storeu_ps(m + 5 * 16, _mm256_extractf128_ps(c1, 1));
+    _mm_storeu_ps(m + 6 * 16, _mm256_extractf128_ps(c2, 1));
+    _mm_storeu_ps(m + 7 * 16, _mm256_extractf128_ps(c3, 1));
+}
+
+FLARENATIVE_TARGET_AVX2 static void ComposeAVX2(const float* a_translations, const float* a_rotations, const float* a_scales, uint32_t a_count, float* a_matrices, float* a_inverses)
+{
+    const __m256i vec3Index = _mm256_setr_epi32(0, 3, 6, 9, 12, 15, 18, 21);
+    const __m256i quatIndex = _mm256_setr_epi32(0, 4, 8, 12, 16, 20, 24, 28);
+
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 two = _mm256_set1_ps(2.0f);
+
+    uint32_t i = 0;
+    for (; i + 8 <= a_count; i += 8)
+    {
+        const float* t = a_translations + i * 3;
+        const float* q = a_rotations + i * 4;
+        const float* s = a_scales + i * 3;
+
+        const __m256 tx = _mm256_i32gather_ps(t + 0, vec3Index, 4);
+        const __m256 ty = _mm256_i32gather_ps(t + 1, vec3Index, 4);
+        const __m256 tz = _mm256_i32gather_ps(t + 2, vec3Index, 4);
+        const __m256 sx = _mm256_i32gather_ps(s + 0, vec3Index, 4);
+        const __m256 sy = _mm256_i32gather_ps(s + 1, vec3Index, 4);
+        const __m256 sz = _mm256_i32gather_ps(s + 2, vec3Index, 4);
+        const __m256 qx = _mm256_i32gather_ps(q + 0, quatIndex, 4);
+        const __m256 qy = _mm256_i32gather_ps(q + 1, quatIndex, 4);
+        const __m256 qz = _mm256_i32gather_ps(q + 2, quatIndex, 4);
+        const __m256 qw = _mm256_i32gather_ps(q + 3, quatIndex, 4);
+
+        const __m256 xx = _mm256_mul_ps(qx, qx);
+        const __m256 yy = _mm256_mul_ps(qy, qy);
+        const __m256 zz = _mm256_mul_ps(qz, qz);
+        const __m256 xy = _mm256_mul_ps(qx, qy);
+        const __m256 xz = _mm256_mul_ps(qx, qz);
+        const __m256 yz = _mm256_mul_ps(qy, qz);
+        const __m256 wx = _mm256_mul_ps(qw, qx);
+        const __m256 wy = _mm256_mul_ps(qw, qy);
+        const __m256 wz = _mm256_mul_ps(qw, qz);
+
+        const __m256 r00 = _mm256_fnmadd_ps(two, _mm256_add_ps(yy, zz), one);
+        const __m256 r01 = _mm256_mul_ps(two, _mm256_add_ps(xy, wz));
+        const __m256 r02 = _mm256_mul_ps(two, _mm256_sub_ps(xz, wy));
+        const __m256 r10 = _mm256_mul_ps(two, _mm256_sub_ps(xy, wz));
+        const __m256 r11 = _mm256_fnmadd_ps(two, _mm256_add_ps(xx, zz), one);
+        const __m256 r12 = _mm256_mul_ps(two, _mm256_add_ps(yz, wx));
+        const __m256 r20 = _mm256_mul_ps(two, _mm256_add_ps(xz, wy));
+        const __m256 r21 = _mm256_mul_ps(two, _mm256_sub_ps(yz, wx));
+        const __m256 r22 = _mm256_fnmadd_ps(two, _mm256_add_ps(xx, yy), one);
+
+        float* m = a_matrices + i * 16;
+        StoreColumnAVX2(m, 0, _mm256_mul_ps(r00, sx), _mm256_mul_ps(r01, sx), _mm256_mul_ps(r02, sx), zero);
+        StoreColumnAVX2(m, 1, _mm256_mul_ps(r10, sy), _mm256_mul_ps(r11, sy), _mm256_mul_ps(r12, sy), zero);
+        StoreColumnAVX2(m, 2, _mm256_mul_ps(r20, sz), _mm256_mul_ps(r21, sz), _mm256_mul_ps(r22, sz), zero);
+        StoreColumnAVX2(m, 3, tx, ty, tz, one);
+
+        if (a_inverses != nullptr)
+        {
+            const __m256 is0 = _mm256_div_ps(one, sx);
+            const __m256 is1 = _mm256_div_ps(one, sy);
+            const __m256 is2 = _mm256_div_ps(one, sz);
+
+            const __m256 d0 = _mm256_fmadd_ps(r02, tz, _mm256_fmadd_ps(r01, ty, _mm256_mul_ps(r00, tx)));
+            const __m256 d1 = _mm256_fmadd_ps(r12, tz, _mm256_fmadd_ps(r11, ty, _mm256_mul_ps(r10, tx)));
+            const __m256 d2 = _mm256_fmadd_ps(r22, tz, _mm256_fmadd_ps(r21, ty, _mm256_mul_ps(r20, tx)));
+
+            float* inv = a_inverses + i * 16;
+            StoreColumnAVX2(inv, 0, _mm256_mul_ps(r00, is0), _mm256_mul_ps(r10, is1), _mm256_mul_ps(r20, is2), zero);
+            StoreColumnAVX2(inv, 1, _mm256_mul_ps(r01, is0), _mm256_mul_ps(r11, is1), _mm256_mul_ps(r21, is2), zero);
+            StoreColumnAVX2(inv, 2, _mm256_mul_ps(r02, is0), _mm256_mul_ps(r12, is1), _mm256_mul_ps(r22, is2), zero);
+            StoreColumnAVX2(inv, 3, _mm256_sub_ps(zero, _mm256_mul_ps(d0, is0)), _mm256_sub_ps(zero, _mm256_mul_ps(d1, is1)), _mm256_sub_ps(zero, _mm256_mul_ps(d2, is2)), one);
+        }
+    }
+
+    ComposeSSE(a_translations + i * 3, a_rotations + i * 4, a_scales + i * 3, a_count - i, a_matrices + i * 16, a_inverses != nullptr ? a_inverses + i * 16 : nullptr);
+}
+
+static bool CPUHasAVX2()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7)
+    {
+        return false;
+    }
+
+    // Needs the OS to be saving the ymm registers as well as the CPU having it
+    __cpuid(info, 1);
+    const bool fma = (info[2] & (0b1 << 12)) != 0;
+    const bool osxsave = (info[2] & (0b1 << 27)) != 0;
+    const bool avx = (info[2] & (0b1 << 28)) != 0;
+    if (!fma || !osxsave || !avx || (_xgetbv(0) & 0b110) != 0b110)
+    {
+        return false;
+    }
+
+    __cpuidex(info, 7, 0);
+
+    return (info[1] & (0b1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif
+}
+#endif
+
+TransformKernel::ComposeFunc TransformKernel::SelectCompose()
+{
+#ifdef FLARENATIVE_TRANSFORMKERNEL_X64
+    if (CPUHasAVX2())
+    {
+        return ComposeAVX2;
+    }
+
+    return ComposeSSE;
+#else
+    return ComposeScalar;
+#endif
+}
+
+void TransformKernel::ComposeTRS(const float* a_translations, const float* a_rotations, const float* a_scales, uint32_t a_count, float* a_matrices, float* a_inverses)
+{
+    static const ComposeFunc Compose = SelectCompose();
+
+    Compose(a_translations, a_rotations, a_scales, a_count, a_matrices, a_inverses);
+}
+
+void TransformKernel::ComposeTRSScalar(const float* a_translations, const float* a_rotations, const float* a_scales, uint32_t a_count, float* a_matrices, float* a_inverses)
+{
+    ComposeScalar(a_translations, a_rotations, a_scales, a_count, a_matrices, a_inverses);
+}
+bool TransformKernel::ComposeTRSSSE(const float* a_translations, const float* a_rotations, const float* a_scales, uint32_t a_count, float* a_matrices, float* a_inverses)
+{
+#ifdef FLARENATIVE_TRANSFORMKERNEL_X64
+    ComposeSSE(a_translations, a_rotations, a_scales, a_count, a_matrices, a_inverses);
+
+    return true;
+#else
+    return false;
+#endif
+}
+bool TransformKernel::ComposeTRSAVX2(const float* a_translations, const float* a_rotations, const float* a_scales, uint32_t a_count, float* a_matrices, float* a_inverses)
+{
+#ifdef FLARENATIVE_TRANSFORMKERNEL_X64
+    static const bool Supported = CPUHasAVX2();
+    if (Supported)
+    {
+        ComposeAVX2(a_translations, a_rotations, a_scales, a_count, a_matrices, a_inverses);
+
+        return true;
+    }
+#endif
+
+    return false;
+}
+
+const char* TransformKernel::GetPathName()
+{
+#ifdef FLARENATIVE_TRANSFORMKERNEL_X64
+    static const char* Name = CPUHasAVX2() ? "AVX2" : "SSE";
+
+    return Name;
+#else
+    return "Scalar";
+#endif
+}
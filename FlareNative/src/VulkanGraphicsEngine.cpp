@@ -1,16 +1,19 @@
 #include "Rendering/Vulkan/VulkanGraphicsEngine.h"
 
-#include <future>
+#include <chrono>
 #include <mutex>
 
 #include "Flare/FlareAssert.h"
+#include "JobSystem.h"
 #include "Logger.h"
+#include "Maths/RadixSort.h"
 #include "ObjectManager.h"
 #include "Profiler.h"
 #include "Rendering/Light.h"
 #include "Rendering/RenderEngine.h"
 #include "Rendering/ShaderBuffers.h"
 #include "Rendering/Vulkan/VulkanGraphicsEngineBindings.h"
+#include "Rendering/Vulkan/VulkanInstanceBuffer.h"
 #include "Rendering/Vulkan/VulkanModel.h"
 #include "Rendering/Vulkan/VulkanPipeline.h"
 #include "Rendering/Vulkan/VulkanPixelShader.h"
@@ -18,14 +21,50 @@
 #include "Rendering/Vulkan/VulkanRenderEngineBackend.h"
 #include "Rendering/Vulkan/VulkanRenderTexture.h"
 #include "Rendering/Vulkan/VulkanShaderData.h"
+#include "Rendering/Vulkan/VulkanStorageBuffer.h"
 #include "Rendering/Vulkan/VulkanSwapchain.h"
 #include "Rendering/Vulkan/VulkanTextureSampler.h"
-#include "Rendering/Vulkan/VulkanUniformBuffer.h"
+#include "Rendering/Vulkan/VulkanUniformRing.h"
 #include "Rendering/Vulkan/VulkanVertexShader.h"
 #include "Runtime/RuntimeFunction.h"
 #include "Runtime/RuntimeManager.h"
 #include "Trace.h"
 
+static constexpr uint32_t LightClusterGrainSize = 64;
+
+static constexpr uint32_t InitialDrawChunkSize = 256;
+static constexpr uint32_t MinDrawChunkSize = 64;
+static constexpr uint32_t MaxDrawChunkSize = 4096;
+// Roughly how long a chunk should take to record in nanoseconds
+static constexpr uint64_t DrawChunkTargetTime = 100000;
+
+struct CullInstance
+{
+    AABB     Bounds;
+    uint32_t TransformAddr;
+    uint32_t RenderLayer;
+};
+
+static bool CullInstanceVisible(const CullInstance& a_instance, const Frustum& a_frustum, const TSnapshot<uint32_t>& a_transformSlots, const TSnapshot<glm::mat4>& a_worldMatrices)
+{
+    if (!a_instance.Bounds.Valid())
+    {
+        return true;
+    }
+
+    return a_frustum.Overlaps(a_instance.Bounds.Transformed(ObjectManager::GetGlobalMatrix(a_transformSlots, a_worldMatrices, a_instance.TransformAddr)));
+}
+
+// Bottom 16 bits of the draw keys
+static constexpr float DepthBucketMax = 65535.0f;
+
+struct DrawItem
+{
+    uint32_t MaterialAddr;
+    uint32_t ModelAddr;
+    uint32_t TransformAddr;
+};
+
 VulkanGraphicsEngine::VulkanGraphicsEngine(RuntimeManager* a_runtime, VulkanRenderEngineBackend* a_vulkanEngine)
 {
     m_vulkanEngine = a_vulkanEngine;
@@ -33,6 +72,26 @@ VulkanGraphicsEngine::VulkanGraphicsEngine(RuntimeManager* a_runtime, VulkanRend
 
     m_runtimeBindings = new VulkanGraphicsEngineBindings(m_runtimeManager, this);
 
+    m_instanceBuffer = new VulkanInstanceBuffer(m_vulkanEngine);
+
+    m_uniformRing = new VulkanUniformRing(m_vulkanEngine);
+    m_directionalLightOffset = 0;
+    m_pointLightOffset = 0;
+    m_spotLightOffset = 0;
+    m_cameraOffset = 0;
+
+    m_frame = nullptr;
+    m_frameNumber = 0;
+
+    m_publishNumber = 0;
+    for (uint32_t i = 0; i < VulkanFlightPoolSize; ++i)
+    {
+        m_framePacketNumbers[i] = 0;
+    }
+    m_oldestPacketInUse = 0;
+
+    m_drawChunkSize = InitialDrawChunkSize;
+
     m_preShadowFunc = m_runtimeManager->GetFunction("FlareEngine.Rendering", "RenderPipeline", ":PreShadowS(uint)");
     m_postShadowFunc = m_runtimeManager->GetFunction("FlareEngine.Rendering", "RenderPipeline", ":PostShadowS(uint)");
     m_preRenderFunc = m_runtimeManager->GetFunction("FlareEngine.Rendering", "RenderPipeline", ":PreRenderS(uint)");
@@ -46,6 +105,8 @@ VulkanGraphicsEngine::~VulkanGraphicsEngine()
 {
     delete m_runtimeBindings;
 
+    delete m_instanceBuffer;
+
     delete m_preShadowFunc;
     delete m_postShadowFunc;
     delete m_preRenderFunc;
@@ -67,38 +128,35 @@ VulkanGraphicsEngine::~VulkanGraphicsEngine()
         }
     }
 
-    TRACE("Deleting camera ubos");
-    for (const VulkanUniformBuffer* uniform : m_cameraUniforms)
+    for (const SecondaryCommandPool* pool : m_secondaryPools)
     {
-        if (uniform != nullptr)
+        for (uint32_t i = 0; i < VulkanFlightPoolSize; ++i)
         {
-            delete uniform;
+            device.destroyCommandPool(pool->Pool[i]);
         }
+
+        delete pool;
     }
 
-    TRACE("Deleting directional light ubos");
-    for (const VulkanUniformBuffer* uniform : m_directionalLightUniforms)
+    for (uint32_t i = 0; i < VulkanFlightPoolSize; ++i)
     {
-        if (uniform != nullptr)
+        for (const FrameArena* arena : m_passArenas[i])
         {
-            delete uniform;
+            delete arena;
         }
     }
-    TRACE("Deleting point light ubos");
-    for (const VulkanUniformBuffer* uniform : m_pointLightUniforms)
+
+    TRACE("Deleting uniform ring");
+    delete m_uniformRing;
+
+    TRACE("Deleting light cluster buffers");
+    for (const VulkanStorageBuffer* buffer : m_pointLightClusters)
     {
-        if (uniform != nullptr)
-        {
-            delete uniform;
-        }
+        delete buffer;
     }
-    TRACE("Deleting spot light ubos");
-    for (const VulkanUniformBuffer* uniform : m_spotLightUniforms)
+    for (const VulkanStorageBuffer* buffer : m_spotLightClusters)
     {
-        if (uniform != nullptr)
-        {
-            delete uniform;
-        }
+        delete buffer;
     }
 
     TRACE("Deleting Pipelines");
@@ -108,244 +166,969 @@ VulkanGraphicsEngine::~VulkanGraphicsEngine()
     }
 
     TRACE("Checking if shaders where deleted");
-    for (uint32_t i = 0; i < m_vertexShaders.Size(); ++i)
+    for (const VulkanVertexShader* shader : m_vertexShaders.ToVector())
+    {
+        Logger::Warning("Vertex Shader was not destroyed");
+
+        delete shader;
+    }
+
+    for (const VulkanPixelShader* shader : m_pixelShaders.ToVector())
     {
-        if (m_vertexShaders[i] != nullptr)
+        Logger::Warning("Pixel Shader was not destroyed");
+
+        delete shader;
+    }
+
+    TRACE("Checking if models where deleted");
+    for (const VulkanModel* model : m_models.ToVector())
+    {
+        Logger::Warning("Model was not destroyed");
+
+        delete model;
+    }
+
+    TRACE("Checking camera buffer health");
+    for (uint32_t i = 0; i < m_cameraBuffers.Size(); ++i)
+    {
+        if (m_cameraBuffers[i].TransformAddr != -1)
         {
-            Logger::Warning("Vertex Shader was not destroyed");
+            Logger::Warning("Camera was not destroyed");
+        }
+    }
+
+    TRACE("Deleting retired shader data");
+    for (const RetiredShaderData& retired : m_retiredShaderData)
+    {
+        delete retired.Data;
+    }
 
-            delete m_vertexShaders[i];
+    TRACE("Checking shader program buffer health");
+    for (uint32_t i = 0; i < m_shaderPrograms.Size(); ++i)
+    {
+        if (!(m_shaderPrograms[i].Flags & 0b1 << FlareBase::RenderProgram::FreeFlag))
+        {
+            Logger::Warning("Shader buffer was not destroyed");
+        }
+
+        if (m_shaderPrograms[i].Data != nullptr)
+        {
+            Logger::Warning("Shader data was not destroyed");
+
+            delete (VulkanShaderData*)m_shaderPrograms[i].Data;
+            m_shaderPrograms[i].Data = nullptr;
         }
     }
 
-    for (uint32_t i = 0; i < m_pixelShaders.Size(); ++i)
+    TRACE("Checking if render textures where deleted");
+    for (const VulkanRenderTexture* texture : m_renderTextures.ToVector())
     {
-        if (m_pixelShaders[i] != nullptr)
+        Logger::Warning("Render Texture was not destroyed");
+
+        delete texture;
+    }
+
+    TRACE("Checking if textures where deleted");
+    for (const VulkanTexture* texture : m_textures.ToVector())
+    {
+        Logger::Warning("Texture was not destroyed");
+        
+        delete texture;
+    }
+    TRACE("Checking if texture samplers where deleted");
+    for (uint32_t i = 0; i < m_textureSampler.Size(); ++i)
+    {
+        if (m_textureSampler[i].TextureMode != FlareBase::TextureMode_Null)
         {
-            Logger::Warning("Pixel Shader was not destroyed");
+            Logger::Warning("Texture sampler was not destroyed");
+        }
 
-            delete m_pixelShaders[i];
+        if (m_textureSampler[i].Data != nullptr)
+        {
+            Logger::Warning("Texture sampler data was not destroyed");
+
+            delete (VulkanTextureSampler*)m_textureSampler[i].Data;
+            m_textureSampler[i].Data = nullptr;
         }
     }
+}
 
-    TRACE("Checking if models where deleted");
-    for (uint32_t i = 0; i < m_models.Size(); ++i)
+FlareBase::RenderProgram VulkanGraphicsEngine::GetRenderProgram(uint32_t a_addr)
+{
+    FLARE_ASSERT_MSG(a_addr < m_shaderPrograms.Size(), "GetRenderProgram out of bounds");
+
+    return m_shaderPrograms[a_addr];
+}
+VulkanPipeline* VulkanGraphicsEngine::GetPipeline(uint32_t a_renderTexture, uint32_t a_pipeline)
+{
+    FLARE_ASSERT_MSG(a_pipeline < m_shaderPrograms.Size(), "GetPipeline pipeline out of bounds");
+
+    const uint64_t addr = (uint64_t)a_renderTexture | (uint64_t)a_pipeline << 32;
+
+    {
+        const std::shared_lock g = std::shared_lock(m_pipeLock);
+        auto iter = m_pipelines.find(addr);
+        if (iter != m_pipelines.end())
+        {
+            return iter->second;
+        }
+    }
+
+    TRACE("Allocating Vulkan Pipeline");
+    const VulkanRenderTexture* tex = GetRenderTexture(a_renderTexture);
+
+    vk::RenderPass pass = m_swapchain->GetRenderPass();
+    bool hasDepth = false;
+    uint32_t textureCount = 1;
+
+    if (tex != nullptr)
+    {
+        pass = tex->GetRenderPass();
+        hasDepth = tex->HasDepthTexture();
+        textureCount = tex->GetTextureCount();
+    }
+
+    VulkanPipeline* pipeline = new VulkanPipeline(m_vulkanEngine, this, pass, hasDepth, textureCount, a_pipeline);
+    {
+        const std::unique_lock g = std::unique_lock(m_pipeLock);
+        m_pipelines.emplace(addr, pipeline);
+    }
+
+    return pipeline;
+}
+
+// Adds whatever the thread allocated between construction and destruction onto the total for the frame
+struct FrameAllocationCounter
+{
+    std::atomic<uint64_t>& Total;
+    uint64_t               Start;
+
+    FrameAllocationCounter(std::atomic<uint64_t>& a_total) :
+        Total(a_total),
+        Start(Profiler::GetThreadAllocations()) { }
+    ~FrameAllocationCounter()
+    {
+        Total += Profiler::GetThreadAllocations() - Start;
+    }
+};
+
+// Same size SetCameraData ends up using for the projection
+glm::vec2 VulkanGraphicsEngine::GetCameraRenderSize(const CameraBuffer& a_camBuffer)
+{
+    const VulkanRenderTexture* renderTexture = GetRenderTexture(a_camBuffer.RenderTextureAddr);
+    if (renderTexture != nullptr)
+    {
+        return glm::vec2(renderTexture->GetWidth(), renderTexture->GetHeight());
+    }
+
+    return (glm::vec2)m_swapchain->GetSize();
+}
+
+vk::CommandBuffer VulkanGraphicsEngine::StartCommandBuffer(uint32_t a_bufferIndex, uint32_t a_index) const
+{
+    const vk::CommandBuffer commandBuffer = m_commandBuffers[a_index][a_bufferIndex];
+
+    constexpr vk::CommandBufferBeginInfo BeginInfo;
+    commandBuffer.begin(BeginInfo);
+
+    return commandBuffer;
+}
+
+vk::CommandBuffer VulkanGraphicsEngine::StartSecondaryCommandBuffer(uint32_t a_index, const vk::CommandBufferInheritanceInfo& a_inheritance)
+{
+    const vk::Device device = m_vulkanEngine->GetLogicalDevice();
+
+    SecondaryCommandPool* pool = nullptr;
+    SecondaryCommandPool** threadPool = m_threadSecondaryPools.Get();
+    if (threadPool != nullptr)
+    {
+        pool = *threadPool;
+    }
+    else
+    {
+        TRACE("Allocating secondary command pools");
+        const vk::CommandPoolCreateInfo poolInfo = vk::CommandPoolCreateInfo
+        (
+            vk::CommandPoolCreateFlagBits::eTransient,
+            m_vulkanEngine->GetGraphicsQueueIndex()
+        );
+
+        pool = new SecondaryCommandPool();
+        for (uint32_t i = 0; i < VulkanFlightPoolSize; ++i)
+        {
+            FLARE_ASSERT_MSG_R(device.createCommandPool(&poolInfo, nullptr, &pool->Pool[i]) == vk::Result::eSuccess, "Failed to create secondary command pool");
+            pool->Used[i] = 0;
+        }
+
+        {
+            const std::unique_lock g = std::unique_lock(m_secondaryPoolLock);
+
+            m_secondaryPools.emplace_back(pool);
+        }
+
+        m_threadSecondaryPools.Push(pool);
+    }
+
+    if (pool->Used[a_index] >= pool->Buffers[a_index].size())
+    {
+        const vk::CommandBufferAllocateInfo commandBufferInfo = vk::CommandBufferAllocateInfo
+        (
+            pool->Pool[a_index],
+            vk::CommandBufferLevel::eSecondary,
+            1
+        );
+
+        vk::CommandBuffer buffer;
+        FLARE_ASSERT_MSG_R(device.allocateCommandBuffers(&commandBufferInfo, &buffer) == vk::Result::eSuccess, "Failed to allocate secondary command buffer");
+
+        pool->Buffers[a_index].emplace_back(buffer);
+    }
+
+    const vk::CommandBuffer commandBuffer = pool->Buffers[a_index][pool->Used[a_index]++];
+
+    const vk::CommandBufferBeginInfo beginInfo = vk::CommandBufferBeginInfo
+    (
+        vk::CommandBufferUsageFlagBits::eRenderPassContinue | vk::CommandBufferUsageFlagBits::eOneTimeSubmit,
+        &a_inheritance
+    );
+    commandBuffer.begin(beginInfo);
+
+    return commandBuffer;
+}
+
+const uint8_t* VulkanGraphicsEngine::CullInstances(const TArenaArray<uint32_t>& a_camIndices, FrameArena* a_arena, uint32_t* a_instanceCount, uint32_t* a_visibleCount)
+{
+    PROFILESTACK("Culling");
+
+    const uint32_t camCount = a_camIndices.Size();
+
+    uint32_t instanceCount = 0;
+    for (const MaterialRenderStack& renderStack : m_frame->RenderStacks)
+    {
+        for (const ModelBuffer& modelBuff : renderStack.GetModelBuffers())
+        {
+            instanceCount += (uint32_t)modelBuff.TransformAddr.size();
+        }
+    }
+
+    *a_instanceCount = instanceCount;
+    *a_visibleCount = 0;
+
+    uint8_t* visible = a_arena->Allocate<uint8_t>(camCount * instanceCount);
+    if (instanceCount == 0 || camCount == 0)
+    {
+        Profiler::SetCounter("Instances Visible", 0);
+        Profiler::SetCounter("Instances Culled", 0);
+
+        return visible;
+    }
+
+    // Flattened in the same order DrawPass goes through them so it can index straight in
+    CullInstance* instances = a_arena->Allocate<CullInstance>(instanceCount);
+    uint32_t meshCount = 0;
+    for (const MaterialRenderStack& renderStack : m_frame->RenderStacks)
+    {
+        for (const ModelBuffer& modelBuff : renderStack.GetModelBuffers())
+        {
+            for (const uint32_t meshAddr : modelBuff.MeshAddr)
+            {
+                meshCount = glm::max(meshCount, meshAddr + 1);
+            }
+        }
+    }
+
+    // Lets the bounds tree results get back to the instance for this frame, meshes not in the frame stay at -1
+    uint32_t* meshInstances = a_arena->Allocate<uint32_t>(meshCount);
+    for (uint32_t i = 0; i < meshCount; ++i)
+    {
+        meshInstances[i] = -1;
+    }
+
+    uint32_t instance = 0;
+    for (const MaterialRenderStack& renderStack : m_frame->RenderStacks)
+    {
+        const uint32_t renderLayer = m_frame->Programs[renderStack.GetMaterialAddr()].RenderLayer;
+        for (const ModelBuffer& modelBuff : renderStack.GetModelBuffers())
+        {
+            // Anything without a model is not going to be drawn anyway so an empty box is fine
+            AABB bounds;
+            const VulkanModel* model = GetModel(modelBuff.ModelAddr);
+            if (model != nullptr)
+            {
+                bounds = model->GetBounds();
+            }
+
+            const uint32_t transformCount = (uint32_t)modelBuff.TransformAddr.size();
+            for (uint32_t i = 0; i < transformCount; ++i)
+            {
+                meshInstances[modelBuff.MeshAddr[i]] = instance;
+
+                instances[instance++] = { bounds, modelBuff.TransformAddr[i], renderLayer };
+            }
+        }
+    }
+
+    Frustum* frustums = a_arena->Allocate<Frustum>(camCount);
+    uint32_t* camLayers = a_arena->Allocate<uint32_t>(camCount);
+    for (uint32_t i = 0; i < camCount; ++i)
+    {
+        const CameraBuffer& camBuffer = m_frame->Cameras[a_camIndices[i]];
+
+        const glm::vec2 size = GetCameraRenderSize(camBuffer);
+
+        const glm::mat4 view = glm::inverse(ObjectManager::GetGlobalMatrix(m_frame->TransformSlots, m_frame->WorldMatrices, camBuffer.TransformAddr));
+
+        frustums[i] = Frustum::FromMatrix(camBuffer.ToProjection(size) * view);
+        camLayers[i] = camBuffer.RenderLayer;
+    }
+
+    std::atomic<uint32_t> visibleTotal = 0;
+    std::atomic<uint32_t> culledTotal = 0;
+
+    // Each camera walks the bounds tree so whole groups off screen get skipped instead of testing every instance
+    JobSystem* jobSystem = m_vulkanEngine->GetRenderEngine()->GetJobSystem();
+    jobSystem->ParallelFor(camCount, 1, [&](uint32_t a_start, uint32_t a_end)
     {
-        if (m_models[i] != nullptr)
+        for (uint32_t j = a_start; j < a_end; ++j)
         {
-            Logger::Warning("Model was not destroyed");
+            const Frustum& frustum = frustums[j];
+            const uint32_t camLayer = camLayers[j];
+            uint8_t* flags = visible + j * instanceCount;
+
+            // The tree does not know about empty boxes so they just get drawn like before
+            uint32_t layerCount = 0;
+            for (uint32_t i = 0; i < instanceCount; ++i)
+            {
+                const bool inLayer = (camLayer & instances[i].RenderLayer) != 0;
+
+                flags[i] = (uint8_t)(inLayer && !instances[i].Bounds.Valid());
+                layerCount += (uint32_t)inLayer;
+            }
+
+            // Tree bounds are only good for meshes that have not changed since this frame was published
+            // Anything that has gets tested against the frame the same as before
+            const bool queried = m_meshBounds.QueryFrame(frustum, m_frame->PublishNumber, [&](uint32_t a_meshAddr)
+            {
+                if (a_meshAddr >= meshCount || meshInstances[a_meshAddr] == -1)
+                {
+                    return;
+                }
+
+                const uint32_t index = meshInstances[a_meshAddr];
+                if (camLayer & instances[index].RenderLayer)
+                {
+                    flags[index] = 1;
+                }
+            },
+            [&](uint32_t a_meshAddr)
+            {
+                if (a_meshAddr >= meshCount || meshInstances[a_meshAddr] == -1)
+                {
+                    return;
+                }
+
+                const uint32_t index = meshInstances[a_meshAddr];
+                const CullInstance& cullInstance = instances[index];
+                if (camLayer & cullInstance.RenderLayer)
+                {
+                    flags[index] = (uint8_t)CullInstanceVisible(cullInstance, frustum, m_frame->TransformSlots, m_frame->WorldMatrices);
+                }
+            });
+
+            // Frame is too far behind for the tree to be any use
+            if (!queried)
+            {
+                for (uint32_t i = 0; i < instanceCount; ++i)
+                {
+                    const CullInstance& cullInstance = instances[i];
+
+                    flags[i] = (uint8_t)((camLayer & cullInstance.RenderLayer) && CullInstanceVisible(cullInstance, frustum, m_frame->TransformSlots, m_frame->WorldMatrices));
+                }
+            }
+
+            uint32_t visibleCount = 0;
+            for (uint32_t i = 0; i < instanceCount; ++i)
+            {
+                visibleCount += flags[i];
+            }
 
-            delete m_models[i];
-            m_models[i] = nullptr;
+            visibleTotal += visibleCount;
+            culledTotal += layerCount - visibleCount;
         }
+    });
+
+    *a_visibleCount = visibleTotal;
+
+    Profiler::SetCounter("Instances Visible", visibleTotal);
+    Profiler::SetCounter("Instances Culled", culledTotal);
+
+    return visible;
+}
+
+vk::CommandBuffer VulkanGraphicsEngine::DrawPass(uint32_t a_camIndex, uint32_t a_bufferIndex, uint32_t a_index, const uint8_t* a_visible, uint32_t a_instanceCount)
+{
+    const FrameAllocationCounter allocCounter = FrameAllocationCounter(m_frameAllocations);
+
+    const CameraBuffer& camBuffer = m_frame->Cameras[a_camIndex];
+    
+    const vk::CommandBuffer commandBuffer = StartCommandBuffer(a_bufferIndex, a_index);
+
+    VulkanRenderCommand& renderCommand = m_renderCommands.Emplace(m_vulkanEngine, this, m_swapchain, commandBuffer, a_bufferIndex);
+
+    renderCommand.SetCameraData(a_camIndex);
+
+    void* camArgs[] = 
+    { 
+        &a_camIndex 
+    };
+
+    m_preRenderFunc->Exec(camArgs);
+
+    FrameArena* arena = m_passArenas[a_index][a_bufferIndex];
+
+    uint64_t* keys = arena->Allocate<uint64_t>(a_instanceCount);
+    uint32_t* order = arena->Allocate<uint32_t>(a_instanceCount);
+    DrawItem* draws = arena->Allocate<DrawItem>(a_instanceCount);
+
+    const glm::vec3 camPos = ObjectManager::GetGlobalMatrix(m_frame->TransformSlots, m_frame->WorldMatrices, camBuffer.TransformAddr)[3].xyz();
+    const float depthScale = DepthBucketMax / glm::max(camBuffer.Far, 0.0001f);
+
+    // Binds it would have taken going through in stack order to compare against
+    uint32_t unsortedMaterialBinds = 0;
+    uint32_t unsortedModelBinds = 0;
+
+    uint32_t drawCount = 0;
+    uint32_t instance = 0;
+    for (const MaterialRenderStack& renderStack : m_frame->RenderStacks)
+    {
+        const uint32_t matAddr = renderStack.GetMaterialAddr();
+        const FlareBase::RenderProgram& program = m_frame->Programs[matAddr];
+        const std::vector<ModelBuffer>& modelBuffers = renderStack.GetModelBuffers();
+
+        if (!(camBuffer.RenderLayer & program.RenderLayer))
+        {
+            for (const ModelBuffer& modelBuff : modelBuffers)
+            {
+                instance += (uint32_t)modelBuff.TransformAddr.size();
+            }
+
+            continue;
+        }
+
+        // Only ever one render texture per pass and pipelines are per material so shaders then material is as close as it gets to pipeline order
+        // Anything past the bits it gets just loses some ordering the draws still get matched on the full address
+        const uint64_t materialKey = (uint64_t)(program.VertexShader & 0xFF) << 56 | (uint64_t)(program.PixelShader & 0xFF) << 48 | (uint64_t)(matAddr & 0xFFFF) << 32;
+
+        const uint32_t matDrawStart = drawCount;
+        for (const ModelBuffer& modelBuff : modelBuffers)
+        {
+            const uint32_t start = instance;
+            const uint32_t count = (uint32_t)modelBuff.TransformAddr.size();
+            instance += count;
+
+            if (modelBuff.ModelAddr == -1)
+            {
+                continue;
+            }
+
+            const uint64_t modelKey = materialKey | (uint64_t)(modelBuff.ModelAddr & 0xFFFF) << 16;
+
+            const uint32_t modelDrawStart = drawCount;
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                if (!a_visible[start + i])
+                {
+                    continue;
+                }
+
+                const uint32_t tAddr = modelBuff.TransformAddr[i];
+
+                // Front to back within the same state so early depth gets a chance
+                const glm::vec3 pos = ObjectManager::GetGlobalMatrix(m_frame->TransformSlots, m_frame->WorldMatrices, tAddr)[3].xyz();
+                const uint64_t depth = (uint64_t)glm::clamp(glm::distance(pos, camPos) * depthScale, 0.0f, DepthBucketMax);
+
+                keys[drawCount] = modelKey | depth;
+                order[drawCount] = drawCount;
+                draws[drawCount] = { matAddr, modelBuff.ModelAddr, tAddr };
+                ++drawCount;
+            }
+
+            unsortedModelBinds += (uint32_t)(drawCount != modelDrawStart);
+        }
+
+        unsortedMaterialBinds += (uint32_t)(drawCount != matDrawStart);
+    }
+
+    {
+        uint64_t* tempKeys = arena->Allocate<uint64_t>(drawCount);
+        uint32_t* tempOrder = arena->Allocate<uint32_t>(drawCount);
+
+        RadixSort(keys, order, tempKeys, tempOrder, drawCount);
     }
 
-    TRACE("Checking camera buffer health");
-    for (uint32_t i = 0; i < m_cameraBuffers.Size(); ++i)
+    // Goes through the sorted draws in [start, end) only binding when things change, the bind is passed in as the serial and chunked paths set up materials differently
+    const auto recordDraws = [&](vk::CommandBuffer a_commandBuffer, uint32_t a_start, uint32_t a_end, const auto& a_bindMaterial)
+    {
+        uint32_t materialBinds = 0;
+        uint32_t modelBinds = 0;
+
+        uint32_t boundMaterial = -1;
+        const VulkanModel* boundModel = nullptr;
+        const VulkanShaderData* shaderData = nullptr;
+
+        uint32_t drawIndex = a_start;
+        while (drawIndex < a_end)
+        {
+            const DrawItem& firstDraw = draws[order[drawIndex]];
+
+            // Everything sharing the material and model goes out together
+            const uint32_t start = drawIndex;
+            while (drawIndex < a_end && draws[order[drawIndex]].MaterialAddr == firstDraw.MaterialAddr && draws[order[drawIndex]].ModelAddr == firstDraw.ModelAddr)
+            {
+                ++drawIndex;
+            }
+            const uint32_t count = drawIndex - start;
+
+            VulkanModel* model = m_models.Get(firstDraw.ModelAddr);
+            if (model == nullptr)
+            {
+                continue;
+            }
+
+            if (boundMaterial != firstDraw.MaterialAddr)
+            {
+                shaderData = a_bindMaterial(a_commandBuffer, start);
+                FLARE_ASSERT(shaderData != nullptr);
+
+                boundMaterial = firstDraw.MaterialAddr;
+                ++materialBinds;
+            }
+
+            const std::lock_guard mLock = std::lock_guard(model->GetLock());
+            // Vertex and index buffers stay bound across pipeline changes so only need doing when the model changes
+            if (model != boundModel)
+            {
+                model->Bind(a_commandBuffer);
+
+                boundModel = model;
+                ++modelBinds;
+            }
+            const uint32_t indexCount = model->GetIndexCount();
+
+            if (shaderData->IsInstanced())
+            {
+                uint32_t first;
+                ModelShaderBuffer* instanceData = m_instanceBuffer->Push(a_index, count, &first);
+                // Sized off the culling results so should not happen but push constants still work if it does
+                if (instanceData != nullptr)
+                {
+                    for (uint32_t i = start; i < drawIndex; ++i)
+                    {
+                        const uint32_t tAddr = draws[order[i]].TransformAddr;
+
+                        instanceData->Model = ObjectManager::GetGlobalMatrix(m_frame->TransformSlots, m_frame->WorldMatrices, tAddr);
+                        instanceData->InvModel = ObjectManager::GetGlobalInverse(m_frame->TransformSlots, m_frame->WorldInverses, tAddr);
+                        ++instanceData;
+                    }
+
+                    a_commandBuffer.drawIndexed(indexCount, count, 0, 0, first);
+
+                    continue;
+                }
+            }
+
+            for (uint32_t i = start; i < drawIndex; ++i)
+            {
+                const uint32_t tAddr = draws[order[i]].TransformAddr;
+
+                shaderData->UpdateTransformBuffer(a_commandBuffer, ObjectManager::GetGlobalMatrix(m_frame->TransformSlots, m_frame->WorldMatrices, tAddr), ObjectManager::GetGlobalInverse(m_frame->TransformSlots, m_frame->WorldInverses, tAddr));
+
+                a_commandBuffer.drawIndexed(indexCount, 1, 0, 0, 0);
+            }
+        }
+
+        m_materialBinds += materialBinds;
+        m_modelBinds += modelBinds;
+    };
+
+    JobSystem* jobSystem = m_vulkanEngine->GetRenderEngine()->GetJobSystem();
+
+    const uint32_t chunkSize = m_drawChunkSize.load(std::memory_order_relaxed);
+    uint64_t recordTime = 0;
+
+    vk::CommandBufferInheritanceInfo inheritance;
+    // Pass only gets started for secondaries if the pipeline has not already put anything in it
+    if (drawCount > chunkSize && jobSystem->GetThreadCount() > 1 && renderCommand.StartSecondaryPass(&inheritance))
+    {
+        // Pipelines get looked up once here so the chunks do not all fight over the pipeline lock
+        struct MaterialState
+        {
+            uint32_t                MaterialAddr;
+            const VulkanPipeline*   Pipeline;
+            const VulkanShaderData* ShaderData;
+        };
+
+        MaterialState* states = arena->Allocate<MaterialState>(drawCount);
+        uint32_t* drawStates = arena->Allocate<uint32_t>(drawCount);
+        uint32_t stateCount = 0;
+
+        const uint32_t renderTexAddr = renderCommand.GetRenderTexutreAddr();
+        for (uint32_t i = 0; i < drawCount; ++i)
+        {
+            const uint32_t matAddr = draws[order[i]].MaterialAddr;
+            if (stateCount > 0 && states[stateCount - 1].MaterialAddr == matAddr)
+            {
+                drawStates[i] = stateCount - 1;
+
+                continue;
+            }
+
+            const VulkanPipeline* pipeline = GetPipeline(renderTexAddr, matAddr);
+            FLARE_ASSERT(pipeline != nullptr);
+
+            MaterialState& matState = states[stateCount];
+            matState.MaterialAddr = matAddr;
+            matState.Pipeline = pipeline;
+            matState.ShaderData = pipeline->GetShaderData();
+            FLARE_ASSERT(matState.ShaderData != nullptr);
+
+            drawStates[i] = stateCount++;
+        }
+
+        const vk::Buffer uniformBuffer = m_uniformRing->GetBuffer(a_index);
+        const vk::Buffer instanceBuffer = m_instanceBuffer->GetBuffer(a_index);
+        const uint32_t camOffset = GetCameraUniformOffset(a_bufferIndex);
+
+        const auto bindState = [&](vk::CommandBuffer a_commandBuffer, uint32_t a_drawIndex) -> const VulkanShaderData*
+        {
+            const MaterialState& state = states[drawStates[a_drawIndex]];
+
+            a_commandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, state.Pipeline->GetPipeline());
+            state.ShaderData->Bind(a_commandBuffer);
+
+            const FlareBase::ShaderBufferInput camInput = state.ShaderData->GetCameraInput();
+            if (camInput.BufferType == FlareBase::ShaderBufferType_CameraBuffer)
+            {
+                state.ShaderData->PushUniformBuffer(a_commandBuffer, camInput.Set, uniformBuffer, camOffset, a_index);
+            }
+            if (state.ShaderData->IsInstanced())
+            {
+                state.ShaderData->PushInstanceBuffer(a_commandBuffer, instanceBuffer, a_index);
+            }
+
+            return state.ShaderData;
+        };
+
+        const vk::Viewport viewport = renderCommand.GetViewport();
+        const vk::Rect2D scissor = renderCommand.GetScissor();
+
+        const uint32_t chunkCount = (drawCount + chunkSize - 1) / chunkSize;
+        vk::CommandBuffer* secondaries = arena->Allocate<vk::CommandBuffer>(chunkCount);
+
+        std::atomic<uint64_t> chunkTime = 0;
+        const auto recordChunk = [&](uint32_t a_start, uint32_t a_end)
+        {
+            const FrameAllocationCounter chunkAllocCounter = FrameAllocationCounter(m_frameAllocations);
+
+            const std::chrono::high_resolution_clock::time_point startTime = std::chrono::high_resolution_clock::now();
+
+            const vk::CommandBuffer secondary = StartSecondaryCommandBuffer(a_index, inheritance);
+            secondary.setViewport(0, 1, &viewport);
+            secondary.setScissor(0, 1, &scissor);
+
+            recordDraws(secondary, a_start, a_end, bindState);
+
+            secondary.end();
+
+            secondaries[a_start / chunkSize] = secondary;
+
+            chunkTime += (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::high_resolution_clock::now() - startTime).count();
+        };
+
+        JobCounter chunkCounter;
+        jobSystem->Run(&chunkCounter, drawCount, chunkSize, recordChunk);
+
+        // Chunks picked up while waiting already count their own allocations
+        const uint64_t waitAllocations = Profiler::GetThreadAllocations();
+        jobSystem->Wait(&chunkCounter);
+        m_frameAllocations -= Profiler::GetThreadAllocations() - waitAllocations;
+
+        commandBuffer.executeCommands(chunkCount, secondaries);
+
+        recordTime = chunkTime;
+    }
+    else
+    {
+        const auto bindMaterial = [&](vk::CommandBuffer a_commandBuffer, uint32_t a_drawIndex) -> const VulkanShaderData*
+        {
+            const uint32_t matAddr = draws[order[a_drawIndex]].MaterialAddr;
+
+            const VulkanPipeline* pipeline = renderCommand.BindMaterial(matAddr);
+            FLARE_ASSERT(pipeline != nullptr);
+
+            const VulkanShaderData* shaderData = (VulkanShaderData*)m_frame->Programs[matAddr].Data;
+            FLARE_ASSERT(shaderData != nullptr);
+
+            if (shaderData->IsInstanced())
+            {
+                shaderData->PushInstanceBuffer(a_commandBuffer, m_instanceBuffer->GetBuffer(a_index), a_index);
+            }
+
+            return shaderData;
+        };
+
+        const std::chrono::high_resolution_clock::time_point startTime = std::chrono::high_resolution_clock::now();
+
+        recordDraws(renderCommand.GetInlineCommandBuffer(), 0, drawCount, bindMaterial);
+
+        recordTime = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::high_resolution_clock::now() - startTime).count();
+    }
+
+    // Chunks want to be big enough that handing them out is worth it but small enough to spread across the workers
+    // Goes off the serial path as well so it can find its way into chunking when draws get expensive
+    if (drawCount > 0)
+    {
+        const uint64_t drawTime = glm::max(recordTime / drawCount, (uint64_t)1);
+        const uint32_t target = (uint32_t)glm::clamp(DrawChunkTargetTime / drawTime, (uint64_t)MinDrawChunkSize, (uint64_t)MaxDrawChunkSize);
+
+        m_drawChunkSize.store((chunkSize * 3 + target) / 4, std::memory_order_relaxed);
+    }
+
+    m_unsortedMaterialBinds += unsortedMaterialBinds;
+    m_unsortedModelBinds += unsortedModelBinds;
+    
+    m_postRenderFunc->Exec(camArgs);
+
+    renderCommand.Flush();
+    
+    commandBuffer.end();
+
+    return commandBuffer;
+}
+// Only walks the two columns it needs and writes every index then only moves on if it passed so the loop has no branches to mispredict and can vectorise
+static uint32_t GatherLights(const TSnapshot<uint32_t>& a_transforms, const TSnapshot<uint32_t>& a_renderLayers, uint32_t a_renderLayer, uint32_t* a_indices)
+{
+    const uint32_t size = a_transforms.Size();
+    const uint32_t* transforms = a_transforms.Data();
+    const uint32_t* renderLayers = a_renderLayers.Data();
+
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < size; ++i)
+    {
+        a_indices[count] = i;
+        count += (uint32_t)(transforms[i] != -1 && (renderLayers[i] & a_renderLayer) != 0);
+    }
+
+    return count;
+}
+
+// View space box of every froxel, tiles split the screen evenly and the slices are spaced out by log depth so they stay roughly cube shaped
+// Goes through the corners at either end so it does not care which way the camera looks down z
+static void BuildClusterBounds(const glm::mat4& a_invProj, float a_near, float a_far, AABB* a_clusters)
+{
+    const float depthRatio = a_far / a_near;
+
+    glm::vec3 dirs[LightClusterY + 1][LightClusterX + 1];
+    for (uint32_t y = 0; y <= LightClusterY; ++y)
     {
-        if (m_cameraBuffers[i].TransformAddr != -1)
+        for (uint32_t x = 0; x <= LightClusterX; ++x)
         {
-            Logger::Warning("Camera was not destroyed");
+            const glm::vec2 ndc = glm::vec2((float)x / LightClusterX, (float)y / LightClusterY) * 2.0f - 1.0f;
+
+            glm::vec4 pos = a_invProj * glm::vec4(ndc, 1.0f, 1.0f);
+            pos /= pos.w;
+
+            dirs[y][x] = pos.xyz() / glm::abs(pos.z);
         }
     }
 
-    TRACE("Checking shader program buffer health");
-    for (uint32_t i = 0; i < m_shaderPrograms.Size(); ++i)
+    for (uint32_t z = 0; z < LightClusterZ; ++z)
     {
-        if (!(m_shaderPrograms[i].Flags & 0b1 << FlareBase::RenderProgram::FreeFlag))
-        {
-            Logger::Warning("Shader buffer was not destroyed");
-        }
+        const float sliceNear = a_near * glm::pow(depthRatio, (float)z / LightClusterZ);
+        const float sliceFar = a_near * glm::pow(depthRatio, (float)(z + 1) / LightClusterZ);
 
-        if (m_shaderPrograms[i].Data != nullptr)
+        for (uint32_t y = 0; y < LightClusterY; ++y)
         {
-            Logger::Warning("Shader data was not destroyed");
+            for (uint32_t x = 0; x < LightClusterX; ++x)
+            {
+                AABB box;
+                for (uint32_t c = 0; c < 4; ++c)
+                {
+                    const glm::vec3& dir = dirs[y + (c >> 1)][x + (c & 0b1)];
 
-            delete (VulkanShaderData*)m_shaderPrograms[i].Data;
-            m_shaderPrograms[i].Data = nullptr;
+                    box.Encapsulate(dir * sliceNear);
+                    box.Encapsulate(dir * sliceFar);
+                }
+
+                a_clusters[(z * LightClusterY + y) * LightClusterX + x] = box;
+            }
         }
     }
+}
 
-    TRACE("Checking if render textures where deleted");
-    for (uint32_t i = 0; i < m_renderTextures.Size(); ++i)
+// Buffer is the header, the lights, a range per cluster then the packed light indices the ranges point into
+template<typename T>
+static uint32_t WriteLightClusters(JobSystem* a_jobSystem, VulkanStorageBuffer* a_buffer, uint32_t a_index, const LightClusterHeader& a_header, const AABB* a_clusters, const T* a_lights, const uint32_t* a_lightIndices, const BoundingSphere* a_spheres, uint32_t a_lightCount, uint32_t* a_offsets)
+{
+    constexpr uint32_t LightsOffset = sizeof(LightClusterHeader);
+    constexpr uint32_t IndicesOffset = LightsOffset + sizeof(T) * LightClusterMaxLights;
+    constexpr uint32_t RangeSize = LightClusterCount * 2;
+
+    // Counted first so the lists can be packed without capping how many lights end up in a cluster
+    a_jobSystem->ParallelFor(LightClusterCount, LightClusterGrainSize, [&](uint32_t a_start, uint32_t a_end)
     {
-        if (m_renderTextures[i] != nullptr)
+        for (uint32_t i = a_start; i < a_end; ++i)
         {
-            Logger::Warning("Render Texture was not destroyed");
+            uint32_t count = 0;
+            for (uint32_t j = 0; j < a_lightCount; ++j)
+            {
+                count += (uint32_t)a_spheres[j].Overlaps(a_clusters[i]);
+            }
 
-            delete m_renderTextures[i];
-            m_renderTextures[i] = nullptr;
+            a_offsets[i] = count;
         }
-    }
+    });
 
-    TRACE("Checking if textures where deleted");
-    for (uint32_t i = 0; i < m_textures.Size(); ++i)
+    uint32_t total = 0;
+    for (uint32_t i = 0; i < LightClusterCount; ++i)
     {
-        if (m_textures[i] != nullptr)
-        {
-            Logger::Warning("Texture was not destroyed");
-            
-            delete m_textures[i];
-            m_textures[i] = nullptr;
-        }
+        total += a_offsets[i];
     }
-    TRACE("Checking if texture samplers where deleted");
-    for (uint32_t i = 0; i < m_textureSampler.Size(); ++i)
-    {
-        if (m_textureSampler[i].TextureMode != FlareBase::TextureMode_Null)
-        {
-            Logger::Warning("Texture sampler was not destroyed");
-        }
 
-        if (m_textureSampler[i].Data != nullptr)
-        {
-            Logger::Warning("Texture sampler data was not destroyed");
+    a_buffer->Reserve(a_index, IndicesOffset + (RangeSize + total) * sizeof(uint32_t));
 
-            delete (VulkanTextureSampler*)m_textureSampler[i].Data;
-            m_textureSampler[i].Data = nullptr;
-        }
+    char* data = (char*)a_buffer->GetData(a_index);
+    memcpy(data, &a_header, sizeof(LightClusterHeader));
+
+    T* lights = (T*)(data + LightsOffset);
+    for (uint32_t i = 0; i < a_lightCount; ++i)
+    {
+        lights[i] = a_lights[a_lightIndices[i]];
     }
-}
 
-FlareBase::RenderProgram VulkanGraphicsEngine::GetRenderProgram(uint32_t a_addr)
-{
-    FLARE_ASSERT_MSG(a_addr < m_shaderPrograms.Size(), "GetRenderProgram out of bounds");
+    // Offsets are kept on our side as reading back out of the mapped memory is slow
+    uint32_t* indices = (uint32_t*)(data + IndicesOffset);
+    uint32_t offset = RangeSize;
+    for (uint32_t i = 0; i < LightClusterCount; ++i)
+    {
+        const uint32_t count = a_offsets[i];
 
-    return m_shaderPrograms[a_addr];
-}
-VulkanPipeline* VulkanGraphicsEngine::GetPipeline(uint32_t a_renderTexture, uint32_t a_pipeline)
-{
-    FLARE_ASSERT_MSG(a_pipeline < m_shaderPrograms.Size(), "GetPipeline pipeline out of bounds");
+        indices[i * 2 + 0] = offset;
+        indices[i * 2 + 1] = count;
 
-    const uint64_t addr = (uint64_t)a_renderTexture | (uint64_t)a_pipeline << 32;
+        a_offsets[i] = offset;
+        offset += count;
+    }
 
+    a_jobSystem->ParallelFor(LightClusterCount, LightClusterGrainSize, [&](uint32_t a_start, uint32_t a_end)
     {
-        const std::shared_lock g = std::shared_lock(m_pipeLock);
-        auto iter = m_pipelines.find(addr);
-        if (iter != m_pipelines.end())
+        for (uint32_t i = a_start; i < a_end; ++i)
         {
-            return iter->second;
+            uint32_t* out = indices + a_offsets[i];
+            for (uint32_t j = 0; j < a_lightCount; ++j)
+            {
+                if (a_spheres[j].Overlaps(a_clusters[i]))
+                {
+                    *out++ = j;
+                }
+            }
         }
-    }
+    });
 
-    TRACE("Allocating Vulkan Pipeline");
-    const VulkanRenderTexture* tex = GetRenderTexture(a_renderTexture);
+    return total;
+}
 
-    vk::RenderPass pass = m_swapchain->GetRenderPass();
-    bool hasDepth = false;
-    uint32_t textureCount = 1;
+void VulkanGraphicsEngine::BuildLightClusters(const TArenaArray<uint32_t>& a_camIndices, FrameArena* a_arena, uint32_t a_index, const PointLightShaderBuffer* a_pointLights, const SpotLightShaderBuffer* a_spotLights)
+{
+    PROFILESTACK("Light Clusters");
 
-    if (tex != nullptr)
-    {
-        pass = tex->GetRenderPass();
-        hasDepth = tex->HasDepthTexture();
-        textureCount = tex->GetTextureCount();
-    }
+    constexpr uint32_t InitialClusterBufferSize = sizeof(LightClusterHeader) + sizeof(SpotLightShaderBuffer) * LightClusterMaxLights + LightClusterCount * 4 * sizeof(uint32_t);
 
-    VulkanPipeline* pipeline = new VulkanPipeline(m_vulkanEngine, this, pass, hasDepth, textureCount, a_pipeline);
+    const uint32_t camCount = a_camIndices.Size();
+    while (m_pointLightClusters.size() < camCount)
     {
-        const std::unique_lock g = std::unique_lock(m_pipeLock);
-        m_pipelines.emplace(addr, pipeline);
+        TRACE("Allocating light cluster buffers");
+        m_pointLightClusters.emplace_back(new VulkanStorageBuffer(m_vulkanEngine, InitialClusterBufferSize));
+        m_spotLightClusters.emplace_back(new VulkanStorageBuffer(m_vulkanEngine, InitialClusterBufferSize));
     }
 
-    return pipeline;
-}
+    const TSnapshot<uint32_t>& pointTransforms = m_frame->PointLights.Column<&PointLightBuffer::TransformAddr>();
+    const TSnapshot<uint32_t>& pointLayers = m_frame->PointLights.Column<&PointLightBuffer::RenderLayer>();
+    const TSnapshot<uint32_t>& spotTransforms = m_frame->SpotLights.Column<&SpotLightBuffer::TransformAddr>();
+    const TSnapshot<uint32_t>& spotLayers = m_frame->SpotLights.Column<&SpotLightBuffer::RenderLayer>();
 
-vk::CommandBuffer VulkanGraphicsEngine::StartCommandBuffer(uint32_t a_bufferIndex, uint32_t a_index) const
-{
-    const vk::CommandBuffer commandBuffer = m_commandBuffers[a_index][a_bufferIndex];
+    uint32_t* lightIndices = a_arena->Allocate<uint32_t>(glm::max(pointTransforms.Size(), spotTransforms.Size()));
+    BoundingSphere* spheres = a_arena->Allocate<BoundingSphere>(LightClusterMaxLights);
+    AABB* clusters = a_arena->Allocate<AABB>(LightClusterCount);
+    uint32_t* offsets = a_arena->Allocate<uint32_t>(LightClusterCount);
 
-    constexpr vk::CommandBufferBeginInfo BeginInfo;
-    commandBuffer.begin(BeginInfo);
+    JobSystem* jobSystem = m_vulkanEngine->GetRenderEngine()->GetJobSystem();
 
-    return commandBuffer;
-}
+    uint32_t lightRefs = 0;
+    uint32_t droppedLights = 0;
+    for (uint32_t i = 0; i < camCount; ++i)
+    {
+        const CameraBuffer& camBuffer = m_frame->Cameras[a_camIndices[i]];
 
-vk::CommandBuffer VulkanGraphicsEngine::DrawPass(uint32_t a_camIndex, uint32_t a_bufferIndex, uint32_t a_index) 
-{
-    // While there is no code relating to mono in here for now.
-    // This is used to fix a crash relating to locking a Thread after going from Mono -> Native 
-    // When when another thread tries to aquire a lock after and it is not visible from Mono despite still being native will cause MemMap Crash 
-    // 
-    // ^ No longer applicable as actually using mono functions on this thread however leaving for future reference and reminder to attach all threads
-    m_runtimeManager->AttachThread();
-    
-    const RenderEngine* renderEngine = m_vulkanEngine->GetRenderEngine();
-    ObjectManager* objectManager = renderEngine->GetObjectManager();
+        const float near = glm::max(camBuffer.Near, 0.0001f);
+        const float far = glm::max(camBuffer.Far, near * 2.0f);
 
-    const CameraBuffer& camBuffer = m_cameraBuffers[a_camIndex];
-    
-    const vk::CommandBuffer commandBuffer = StartCommandBuffer(a_bufferIndex, a_index);
+        const glm::mat4 view = glm::inverse(ObjectManager::GetGlobalMatrix(m_frame->TransformSlots, m_frame->WorldMatrices, camBuffer.TransformAddr));
+        const glm::mat4 invProj = glm::inverse(camBuffer.ToProjection(GetCameraRenderSize(camBuffer)));
 
-    VulkanRenderCommand& renderCommand = m_renderCommands.Push(VulkanRenderCommand(m_vulkanEngine, this, m_swapchain, commandBuffer, a_bufferIndex));
+        BuildClusterBounds(invProj, near, far, clusters);
 
-    renderCommand.SetCameraData(a_camIndex);
+        // Shader works out the slice with log(depth) * z + w
+        const float logRatio = glm::log(far / near);
 
-    void* camArgs[] = 
-    { 
-        &a_camIndex 
-    };
+        LightClusterHeader header;
+        header.ClusterDepth = glm::vec4(near, far, LightClusterZ / logRatio, -(LightClusterZ * glm::log(near)) / logRatio);
 
-    m_preRenderFunc->Exec(camArgs);
+        uint32_t lightCount = GatherLights(pointTransforms, pointLayers, camBuffer.RenderLayer, lightIndices);
+        droppedLights += lightCount - glm::min(lightCount, LightClusterMaxLights);
+        lightCount = glm::min(lightCount, LightClusterMaxLights);
+        for (uint32_t j = 0; j < lightCount; ++j)
+        {
+            const PointLightShaderBuffer& light = a_pointLights[lightIndices[j]];
 
-    const std::vector<MaterialRenderStack> stacks = m_renderStacks.ToVector();
+            spheres[j] = { (view * glm::vec4(light.LightPos.xyz(), 1.0f)).xyz(), light.Radius };
+        }
 
-    // TODO: Pre-Culling and batching
-    for (const MaterialRenderStack& renderStack : stacks)
-    {
-        const uint32_t matAddr = renderStack.GetMaterialAddr();
-        const FlareBase::RenderProgram& program = m_shaderPrograms[matAddr];
-        if (camBuffer.RenderLayer & program.RenderLayer)
+        header.ClusterSize = glm::uvec4(LightClusterX, LightClusterY, LightClusterZ, lightCount);
+        lightRefs += WriteLightClusters(jobSystem, m_pointLightClusters[i], a_index, header, clusters, a_pointLights, lightIndices, spheres, lightCount, offsets);
+
+        // Spot lights just get their whole range as a sphere, the cone gets sorted out per pixel
+        lightCount = GatherLights(spotTransforms, spotLayers, camBuffer.RenderLayer, lightIndices);
+        droppedLights += lightCount - glm::min(lightCount, LightClusterMaxLights);
+        lightCount = glm::min(lightCount, LightClusterMaxLights);
+        for (uint32_t j = 0; j < lightCount; ++j)
         {
-            const VulkanPipeline* pipeline = renderCommand.BindMaterial(matAddr);
-            FLARE_ASSERT(pipeline != nullptr);
+            const SpotLightShaderBuffer& light = a_spotLights[lightIndices[j]];
 
-            const VulkanShaderData* shaderData = (VulkanShaderData*)program.Data;
-            FLARE_ASSERT(shaderData != nullptr);
-            
-            const std::vector<ModelBuffer> modelBuffers = renderStack.GetModelBuffers();
-            for (const ModelBuffer& modelBuff : modelBuffers)
-            {
-                if (modelBuff.ModelAddr != -1)
-                {
-                    VulkanModel* model = m_models[modelBuff.ModelAddr];
-                    if (model != nullptr)
-                    {
-                        const std::lock_guard mLock = std::lock_guard(model->GetLock());
-                        model->Bind(commandBuffer);
-                        const uint32_t indexCount = model->GetIndexCount();
-                        for (uint32_t tAddr : modelBuff.TransformAddr)
-                        {
-                            shaderData->UpdateTransformBuffer(commandBuffer, tAddr, objectManager);
-
-                            commandBuffer.drawIndexed(indexCount, 1, 0, 0, 0);
-                        }
-                    }
-                }
-            }
+            spheres[j] = { (view * glm::vec4(light.LightPos, 1.0f)).xyz(), light.CutoffAngle.z };
         }
+
+        header.ClusterSize = glm::uvec4(LightClusterX, LightClusterY, LightClusterZ, lightCount);
+        lightRefs += WriteLightClusters(jobSystem, m_spotLightClusters[i], a_index, header, clusters, a_spotLights, lightIndices, spheres, lightCount, offsets);
     }
-    
-    m_postRenderFunc->Exec(camArgs);
 
-    renderCommand.Flush();
-    
-    commandBuffer.end();
+    if (droppedLights > 0)
+    {
+        Logger::Warning("FlareEngine: Too many lights for clustering, extra lights dropped");
+    }
 
-    return commandBuffer;
+    Profiler::SetCounter("Light Cluster Refs", lightRefs);
 }
-vk::CommandBuffer VulkanGraphicsEngine::LightPass(uint32_t a_camIndex, uint32_t a_bufferIndex, uint32_t a_index)
+
+vk::CommandBuffer VulkanGraphicsEngine::LightPass(uint32_t a_camIndex, uint32_t a_bufferIndex, uint32_t a_index, uint32_t a_clusterIndex)
 {
-    m_runtimeManager->AttachThread();
+    const FrameAllocationCounter allocCounter = FrameAllocationCounter(m_frameAllocations);
 
-    const CameraBuffer& camBuffer = m_cameraBuffers[a_camIndex];
-    
-    const RenderEngine* renderEngine = m_vulkanEngine->GetRenderEngine();
-    ObjectManager* objectManager = renderEngine->GetObjectManager();
+    const CameraBuffer& camBuffer = m_frame->Cameras[a_camIndex];
 
     const vk::CommandBuffer commandBuffer = StartCommandBuffer(a_bufferIndex, a_index);
 
-    VulkanRenderCommand& renderCommand = m_renderCommands.Push(VulkanRenderCommand(m_vulkanEngine, this, m_swapchain, commandBuffer, a_bufferIndex));
+    VulkanRenderCommand& renderCommand = m_renderCommands.Emplace(m_vulkanEngine, this, m_swapchain, commandBuffer, a_bufferIndex);
 
     void* lightSetupArgs[] =
     {
@@ -356,8 +1139,10 @@ vk::CommandBuffer VulkanGraphicsEngine::LightPass(uint32_t a_camIndex, uint32_t
 
     renderCommand.SetCameraData(a_camIndex);
 
+    const uint32_t maxLights = glm::max(m_frame->DirectionalLights.Size(), glm::max(m_frame->PointLights.Size(), m_frame->SpotLights.Size()));
+    uint32_t* lightIndices = m_passArenas[a_index][a_bufferIndex]->Allocate<uint32_t>(maxLights);
+
     for (uint32_t i = 0; i < LightType_End; ++i)
-    // for (uint32_t i = 0; i < 1; ++i)
     {
         void* lightArgs[] = 
         {
@@ -376,72 +1161,72 @@ vk::CommandBuffer VulkanGraphicsEngine::LightPass(uint32_t a_camIndex, uint32_t
         const VulkanShaderData* data = pipeline->GetShaderData();
         FLARE_ASSERT(data != nullptr);
 
-        // TODO: Could probably batch this down the line
+        // Pass may have been started for secondaries by whatever the pipeline drew before
+        const vk::CommandBuffer lightBuffer = renderCommand.GetInlineCommandBuffer();
+
         switch ((e_LightType)i)
         {
         case LightType_Directional:
         {
-            const std::vector<DirectionalLightBuffer> lights = m_directionalLights.ToVector();
+            const uint32_t lightCount = GatherLights(m_frame->DirectionalLights.Column<&DirectionalLightBuffer::TransformAddr>(), m_frame->DirectionalLights.Column<&DirectionalLightBuffer::RenderLayer>(), camBuffer.RenderLayer, lightIndices);
 
             const FlareBase::ShaderBufferInput dirLightInput = data->GetDirectionalLightInput();
 
             if (dirLightInput.BufferType == FlareBase::ShaderBufferType_DirectionalLightBuffer)
             {
-                const uint32_t dirLightCount = (uint32_t)lights.size();
-                for (uint32_t i = 0; i < dirLightCount; ++i)
+                // Lights only differ by where they are in the ring so they all end up sharing the one set or get pushed
+                const vk::Buffer uniformBuffer = m_uniformRing->GetBuffer(a_index);
+                const uint32_t lightStride = m_uniformRing->GetAlignedSize(sizeof(DirectionalLightShaderBuffer));
+                for (uint32_t j = 0; j < lightCount; ++j)
                 {
-                    const DirectionalLightBuffer& dirLight = lights[i];
-
-                    if (dirLight.TransformAddr != -1 && camBuffer.RenderLayer & dirLight.RenderLayer)
-                    {
-                        data->PushUniformBuffer(commandBuffer, dirLightInput.Set, m_directionalLightUniforms[i], a_index);
+                    data->PushUniformBuffer(lightBuffer, dirLightInput.Set, uniformBuffer, m_directionalLightOffset + lightIndices[j] * lightStride, a_index);
 
-                        commandBuffer.draw(4, 1, 0, 0);
-                    }
+                    lightBuffer.draw(4, 1, 0, 0);
                 }
             }
             else
             {
-                for (const DirectionalLightBuffer& dirLight : lights)
+                for (uint32_t j = 0; j < lightCount; ++j)
                 {
-                    if (dirLight.TransformAddr != -1 && camBuffer.RenderLayer & dirLight.RenderLayer)
-                    {
-                        commandBuffer.draw(4, 1, 0, 0);
-                    }
+                    lightBuffer.draw(4, 1, 0, 0);
                 }
             }
-            
+
             break;
         }
         case LightType_Point:
         {
-            const std::vector<PointLightBuffer> lights = m_pointLights.ToVector();
+            // Every light goes out in the one draw and each pixel only looks at the lights in its cluster
+            const FlareBase::ShaderBufferInput clusterInput = data->GetPointLightClusterInput();
+            if (clusterInput.BufferType == FlareBase::ShaderBufferType_PointLightClusterBuffer)
+            {
+                data->PushStorageBuffer(lightBuffer, clusterInput.Set, m_pointLightClusters[a_clusterIndex]->GetBuffer(a_index), a_index);
+
+                lightBuffer.draw(4, 1, 0, 0);
+
+                break;
+            }
+
+            const uint32_t lightCount = GatherLights(m_frame->PointLights.Column<&PointLightBuffer::TransformAddr>(), m_frame->PointLights.Column<&PointLightBuffer::RenderLayer>(), camBuffer.RenderLayer, lightIndices);
 
             const FlareBase::ShaderBufferInput pointLightInput = data->GetPointLightInput();
 
             if (pointLightInput.BufferType == FlareBase::ShaderBufferType_PointLightBuffer)
             {
-                const uint32_t pointLightCount = (uint32_t)lights.size();
-                for (uint32_t i = 0; i < pointLightCount; ++i)
+                const vk::Buffer uniformBuffer = m_uniformRing->GetBuffer(a_index);
+                const uint32_t lightStride = m_uniformRing->GetAlignedSize(sizeof(PointLightShaderBuffer));
+                for (uint32_t j = 0; j < lightCount; ++j)
                 {
-                    const PointLightBuffer& pointLight = lights[i];
-
-                    if (pointLight.TransformAddr != -1 && camBuffer.RenderLayer & pointLight.RenderLayer)
-                    {
-                        data->PushUniformBuffer(commandBuffer, pointLightInput.Set, m_pointLightUniforms[i], a_index);
+                    data->PushUniformBuffer(lightBuffer, pointLightInput.Set, uniformBuffer, m_pointLightOffset + lightIndices[j] * lightStride, a_index);
 
-                        commandBuffer.draw(4, 1, 0, 0);
-                    }
+                    lightBuffer.draw(4, 1, 0, 0);
                 }
             }
             else
             {
-                for (const PointLightBuffer& pointLight : lights)
+                for (uint32_t j = 0; j < lightCount; ++j)
                 {
-                    if (pointLight.TransformAddr != -1 && camBuffer.RenderLayer & pointLight.RenderLayer)
-                    {
-                        commandBuffer.draw(4, 1, 0, 0);
-                    }
+                    lightBuffer.draw(4, 1, 0, 0);
                 }
             }
 
@@ -449,33 +1234,36 @@ vk::CommandBuffer VulkanGraphicsEngine::LightPass(uint32_t a_camIndex, uint32_t
         }
         case LightType_Spot:
         {
-            const std::vector<SpotLightBuffer> lights = m_spotLights.ToVector();
+            const FlareBase::ShaderBufferInput clusterInput = data->GetSpotLightClusterInput();
+            if (clusterInput.BufferType == FlareBase::ShaderBufferType_SpotLightClusterBuffer)
+            {
+                data->PushStorageBuffer(lightBuffer, clusterInput.Set, m_spotLightClusters[a_clusterIndex]->GetBuffer(a_index), a_index);
+
+                lightBuffer.draw(4, 1, 0, 0);
+
+                break;
+            }
+
+            const uint32_t lightCount = GatherLights(m_frame->SpotLights.Column<&SpotLightBuffer::TransformAddr>(), m_frame->SpotLights.Column<&SpotLightBuffer::RenderLayer>(), camBuffer.RenderLayer, lightIndices);
 
             const FlareBase::ShaderBufferInput spotLightInput = data->GetSpotLightInput();
 
             if (spotLightInput.BufferType == FlareBase::ShaderBufferType_SpotLightBuffer)
             {
-                const uint32_t spotLightCount = (uint32_t)lights.size();
-                for (uint32_t i = 0; i < spotLightCount; ++i)
+                const vk::Buffer uniformBuffer = m_uniformRing->GetBuffer(a_index);
+                const uint32_t lightStride = m_uniformRing->GetAlignedSize(sizeof(SpotLightShaderBuffer));
+                for (uint32_t j = 0; j < lightCount; ++j)
                 {
-                    const SpotLightBuffer& spotLight = lights[i];
-
-                    if (spotLight.TransformAddr != -1 && camBuffer.RenderLayer & spotLight.RenderLayer)
-                    {
-                        data->PushUniformBuffer(commandBuffer, spotLightInput.Set, m_spotLightUniforms[i], a_index);
+                    data->PushUniformBuffer(lightBuffer, spotLightInput.Set, uniformBuffer, m_spotLightOffset + lightIndices[j] * lightStride, a_index);
 
-                        commandBuffer.draw(4, 1, 0, 0);
-                    }
+                    lightBuffer.draw(4, 1, 0, 0);
                 }
             }
             else
             {
-                for (const SpotLightBuffer& spotLight : lights)
+                for (uint32_t j = 0; j < lightCount; ++j)
                 {
-                    if (spotLight.TransformAddr != -1 && camBuffer.RenderLayer & spotLight.RenderLayer)
-                    {
-                        commandBuffer.draw(4, 1, 0, 0);
-                    }
+                    lightBuffer.draw(4, 1, 0, 0);
                 }
             }
 
@@ -500,11 +1288,11 @@ vk::CommandBuffer VulkanGraphicsEngine::LightPass(uint32_t a_camIndex, uint32_t
 }
 vk::CommandBuffer VulkanGraphicsEngine::PostPass(uint32_t a_camIndex, uint32_t a_bufferIndex, uint32_t a_index)
 {
-    m_runtimeManager->AttachThread();
+    const FrameAllocationCounter allocCounter = FrameAllocationCounter(m_frameAllocations);
 
     const vk::CommandBuffer commandBuffer = StartCommandBuffer(a_bufferIndex, a_index);
 
-    VulkanRenderCommand& renderCommand = m_renderCommands.Push(VulkanRenderCommand(m_vulkanEngine, this, m_swapchain, commandBuffer, a_bufferIndex));
+    VulkanRenderCommand& renderCommand = m_renderCommands.Emplace(m_vulkanEngine, this, m_swapchain, commandBuffer, a_bufferIndex);
 
     renderCommand.SetCameraData(a_camIndex);
 
@@ -522,27 +1310,109 @@ vk::CommandBuffer VulkanGraphicsEngine::PostPass(uint32_t a_camIndex, uint32_t a
     return commandBuffer;
 }
 
-std::vector<vk::CommandBuffer> VulkanGraphicsEngine::Update(uint32_t a_index)
+void VulkanGraphicsEngine::RetireShaderData(VulkanShaderData* a_data)
+{
+    // Every packet up to the current one could have it, the next one will not
+    m_retiredShaderData.emplace_back(RetiredShaderData{ m_publishNumber, a_data });
+}
+
+void VulkanGraphicsEngine::PublishFrame()
+{
+    PROFILESTACK("Publish Frame");
+
+    ObjectManager* objectManager = m_vulkanEngine->GetRenderEngine()->GetObjectManager();
+
+    FramePacket& packet = m_framePackets.Back();
+
+    // Transforms go last as everything else points into them so anything created in between is still valid
+    objectManager->UpdateWorldMatrices();
+
+    packet.Cameras = m_cameraBuffers.Snapshot();
+    packet.RenderStacks = m_renderStacks.Snapshot();
+    packet.Programs = m_shaderPrograms.Snapshot();
+    packet.DirectionalLights = m_directionalLights.Snapshot();
+    packet.PointLights = m_pointLights.Snapshot();
+    packet.SpotLights = m_spotLights.Snapshot();
+    packet.TransformSlots = objectManager->SnapshotTransformSlots();
+    packet.WorldMatrices = objectManager->SnapshotWorldMatrices();
+    packet.WorldInverses = objectManager->SnapshotWorldInverses();
+
+    packet.PublishNumber = ++m_publishNumber;
+
+    const uint32_t boundsReinserts = m_meshBounds.Refit(objectManager->GetMovedTransforms(), packet.TransformSlots, packet.WorldMatrices, packet.PublishNumber);
+
+    m_framePackets.Publish();
+
+    // Anything retired before a packet older than the oldest in use got published cannot be pointed at anymore
+    const uint64_t oldestInUse = m_oldestPacketInUse.load(std::memory_order_acquire);
+    for (uint32_t i = 0; i < (uint32_t)m_retiredShaderData.size();)
+    {
+        if (m_retiredShaderData[i].PublishNumber < oldestInUse)
+        {
+            delete m_retiredShaderData[i].Data;
+
+            m_retiredShaderData[i] = m_retiredShaderData.back();
+            m_retiredShaderData.pop_back();
+
+            continue;
+        }
+
+        ++i;
+    }
+
+    const ObjectManager::TransformStats transformStats = objectManager->GetTransformStats();
+    Profiler::SetCounter("Transforms Live", transformStats.Live);
+    Profiler::SetCounter("Transform Holes", transformStats.Holes);
+    Profiler::SetCounter("Transform Moves", transformStats.CompactionMoves);
+    Profiler::SetCounter("Mesh Bounds Reinserts", boundsReinserts);
+}
+
+TArenaView<vk::CommandBuffer> VulkanGraphicsEngine::Update(uint32_t a_index)
 {
     Profiler::StartFrame("Drawing Setup");
     m_renderCommands.Clear();
 
+    ++m_frameNumber;
+
+    m_frameAllocations = 0;
+    m_materialBinds = 0;
+    m_modelBinds = 0;
+    m_unsortedMaterialBinds = 0;
+    m_unsortedModelBinds = 0;
+    const uint64_t startAllocations = Profiler::GetThreadAllocations();
+
+    FrameArena& arena = m_updateArenas[a_index];
+    arena.Reset();
+
     const vk::Device device = m_vulkanEngine->GetLogicalDevice();
 
-    ObjectManager* objectManager = m_vulkanEngine->GetRenderEngine()->GetObjectManager();
+    // Before the first tick has been published this is an empty packet so only the clear goes out
+    m_frame = &m_framePackets.Acquire();
+
+    // The GPU is done with whatever this index was last drawn from and the mailbox only ever hands out newer packets after this one
+    m_framePacketNumbers[a_index] = m_frame->PublishNumber;
+    uint64_t oldestInUse = m_frame->PublishNumber;
+    for (uint32_t i = 0; i < VulkanFlightPoolSize; ++i)
+    {
+        if (m_framePacketNumbers[i] < oldestInUse)
+        {
+            oldestInUse = m_framePacketNumbers[i];
+        }
+    }
+    m_oldestPacketInUse.store(oldestInUse, std::memory_order_release);
 
-    const uint32_t camBufferSize = m_cameraBuffers.Size();
+    const uint32_t camBufferSize = m_frame->Cameras.Size();
 
-    std::vector<uint32_t> camIndices;
+    TArenaArray<uint32_t> camIndices = TArenaArray<uint32_t>(&arena, camBufferSize);
     for (uint32_t i = 0; i < camBufferSize; ++i)
     {
-        if (m_cameraBuffers[i].TransformAddr != -1)
+        if (m_frame->Cameras[i].TransformAddr != -1)
         {
-            camIndices.emplace_back(i);
+            camIndices.Push(i);
         }
     }
     
-    const uint32_t camIndexSize = (uint32_t)camIndices.size();
+    const uint32_t camIndexSize = camIndices.Size();
     const uint32_t totalPoolSize = camIndexSize * DrawingPassCount + 1;
     const uint32_t poolSize = (uint32_t)m_commandPool[a_index].size();
 
@@ -578,134 +1448,174 @@ std::vector<vk::CommandBuffer> VulkanGraphicsEngine::Update(uint32_t a_index)
         }
     }
 
-    const uint32_t camUniformSize = (uint32_t)m_cameraUniforms.size();
+    for (uint32_t i = 0; i < glm::min(poolSize, totalPoolSize); ++i)
+    {
+        device.resetCommandPool(m_commandPool[a_index][i]);
+    }
 
-    if (camUniformSize < totalPoolSize)
     {
-        TRACE("Allocating camera ubos");
-        const uint32_t diff = totalPoolSize - camUniformSize;
-        for (uint32_t i = 0; i < diff; ++i)
+        // Nothing is recording at this point so the owning threads are not going to touch them
+        const std::unique_lock g = std::unique_lock(m_secondaryPoolLock);
+        for (SecondaryCommandPool* pool : m_secondaryPools)
         {
-            m_cameraUniforms.emplace_back(new VulkanUniformBuffer(m_vulkanEngine, sizeof(CameraShaderBuffer)));
+            device.resetCommandPool(pool->Pool[a_index]);
+            pool->Used[a_index] = 0;
         }
     }
 
-    for (uint32_t i = 0; i < glm::min(poolSize, totalPoolSize); ++i)
+    while (m_passArenas[a_index].size() < totalPoolSize)
     {
-        device.resetCommandPool(m_commandPool[a_index][i]);
+        TRACE("Allocating pass arena");
+        m_passArenas[a_index].emplace_back(new FrameArena());
     }
 
-    const uint32_t directionalLightSize = m_directionalLights.Size();
-    const uint32_t directionalLightUniformSize = (uint32_t)m_directionalLightUniforms.size();
-    if (directionalLightUniformSize < directionalLightSize)
+    for (uint32_t i = 0; i < totalPoolSize; ++i)
     {
-        TRACE("Allocating directional light ubos");
-        const uint32_t diff = directionalLightSize - directionalLightUniformSize;
-        for (uint32_t i = 0; i < diff; ++i)
-        {
-            m_directionalLightUniforms.emplace_back(new VulkanUniformBuffer(m_vulkanEngine, sizeof(DirectionalLightShaderBuffer)));
-        }
+        m_passArenas[a_index][i]->Reset();
     }
 
+    const uint32_t directionalLightSize = m_frame->DirectionalLights.Size();
+    const uint32_t pointLightSize = m_frame->PointLights.Size();
+    const uint32_t spotLightSize = m_frame->SpotLights.Size();
+
+    const uint32_t directionalLightStride = m_uniformRing->GetAlignedSize(sizeof(DirectionalLightShaderBuffer));
+    const uint32_t pointLightStride = m_uniformRing->GetAlignedSize(sizeof(PointLightShaderBuffer));
+    const uint32_t spotLightStride = m_uniformRing->GetAlignedSize(sizeof(SpotLightShaderBuffer));
+    const uint32_t cameraStride = m_uniformRing->GetAlignedSize(sizeof(CameraShaderBuffer));
+
+    // Same order every frame so anything that has not changed since this frame index was last used is already there
+    m_uniformRing->Reset(a_index, directionalLightSize * directionalLightStride + pointLightSize * pointLightStride + spotLightSize * spotLightStride + totalPoolSize * cameraStride);
+    m_directionalLightOffset = m_uniformRing->Push(a_index, directionalLightSize * directionalLightStride);
+    m_pointLightOffset = m_uniformRing->Push(a_index, pointLightSize * pointLightStride);
+    m_spotLightOffset = m_uniformRing->Push(a_index, spotLightSize * spotLightStride);
+    m_cameraOffset = m_uniformRing->Push(a_index, totalPoolSize * cameraStride);
+
+    const TSnapshot<uint32_t>& dirLightTransforms = m_frame->DirectionalLights.Column<&DirectionalLightBuffer::TransformAddr>();
+    const TSnapshot<glm::vec4>& dirLightColors = m_frame->DirectionalLights.Column<&DirectionalLightBuffer::Color>();
+    const TSnapshot<float>& dirLightIntensities = m_frame->DirectionalLights.Column<&DirectionalLightBuffer::Intensity>();
     for (uint32_t i = 0; i < directionalLightSize; ++i)
     {
-        const DirectionalLightBuffer& dirLight = m_directionalLights[i];
-
-        if (dirLight.TransformAddr != -1)
+        const uint32_t transformAddr = dirLightTransforms[i];
+        if (transformAddr != -1)
         {
-            const glm::mat4 tMat = objectManager->GetGlobalMatrix(dirLight.TransformAddr);
+            const glm::mat4 tMat = ObjectManager::GetGlobalMatrix(m_frame->TransformSlots, m_frame->WorldMatrices, transformAddr);
 
             const glm::vec3 forward = glm::normalize(tMat[2].xyz());
 
-            DirectionalLightShaderBuffer buffer;
-            buffer.LightDir = glm::vec4(forward, dirLight.Intensity);
-            buffer.LightColor = dirLight.Color;
-
-            VulkanUniformBuffer* uniformBuffer = m_directionalLightUniforms[i];
-            uniformBuffer->SetData(a_index, &buffer);
-        }
-    }
+            DirectionalLightShaderBuffer buffer = DirectionalLightShaderBuffer();
+            buffer.LightDir = glm::vec4(forward, dirLightIntensities[i]);
+            buffer.LightColor = dirLightColors[i];
 
-    const uint32_t pointLightSize = m_pointLights.Size();
-    const uint32_t pointLightUniformSize = (uint32_t)m_pointLightUniforms.size();
-    if (pointLightUniformSize < pointLightSize)
-    {
-        TRACE("Allocating point light ubos");
-        const uint32_t diff = pointLightSize - pointLightUniformSize;
-        for (uint32_t i = 0; i < diff; ++i)
-        {
-            m_pointLightUniforms.emplace_back(new VulkanUniformBuffer(m_vulkanEngine, sizeof(PointLightShaderBuffer)));
+            m_uniformRing->Write(a_index, m_directionalLightOffset + i * directionalLightStride, &buffer, sizeof(DirectionalLightShaderBuffer));
         }
     }
 
+    const TSnapshot<uint32_t>& pointLightTransforms = m_frame->PointLights.Column<&PointLightBuffer::TransformAddr>();
+    const TSnapshot<glm::vec4>& pointLightColors = m_frame->PointLights.Column<&PointLightBuffer::Color>();
+    const TSnapshot<float>& pointLightIntensities = m_frame->PointLights.Column<&PointLightBuffer::Intensity>();
+    const TSnapshot<float>& pointLightRadii = m_frame->PointLights.Column<&PointLightBuffer::Radius>();
+    // Kept about for the light clusters
+    PointLightShaderBuffer* pointLightData = arena.Allocate<PointLightShaderBuffer>(pointLightSize);
     for (uint32_t i = 0; i < pointLightSize; ++i)
     {
-        const PointLightBuffer& pointLight = m_pointLights[i];
-
-        if (pointLight.TransformAddr != -1)
+        const uint32_t transformAddr = pointLightTransforms[i];
+        if (transformAddr != -1)
         {
-            const glm::mat4 tMat = objectManager->GetGlobalMatrix(pointLight.TransformAddr);
+            const glm::mat4 tMat = ObjectManager::GetGlobalMatrix(m_frame->TransformSlots, m_frame->WorldMatrices, transformAddr);
 
             const glm::vec3 pos = tMat[3].xyz();
 
-            PointLightShaderBuffer buffer;
-            buffer.LightPos = glm::vec4(pos, pointLight.Intensity);
-            buffer.LightColor = pointLight.Color;
-            buffer.Radius = pointLight.Radius;
+            // Zeroed so the padding does not make it look changed to the ring
+            PointLightShaderBuffer buffer = PointLightShaderBuffer();
+            buffer.LightPos = glm::vec4(pos, pointLightIntensities[i]);
+            buffer.LightColor = pointLightColors[i];
+            buffer.Radius = pointLightRadii[i];
 
-            VulkanUniformBuffer* uniformBuffer = m_pointLightUniforms[i];
-            uniformBuffer->SetData(a_index, &buffer);
-        }
-    }
+            pointLightData[i] = buffer;
 
-    const uint32_t spotLightSize = m_spotLights.Size();
-    const uint32_t spotLightUniformSize = (uint32_t)m_spotLightUniforms.size();
-    if (spotLightUniformSize < spotLightSize)
-    {
-        TRACE("Allocating spot light ubos");
-        const uint32_t diff = spotLightSize - spotLightUniformSize;
-        for (uint32_t i = 0; i < diff; ++i)
-        {
-            m_spotLightUniforms.emplace_back(new VulkanUniformBuffer(m_vulkanEngine, sizeof(SpotLightShaderBuffer)));
+            m_uniformRing->Write(a_index, m_pointLightOffset + i * pointLightStride, &buffer, sizeof(PointLightShaderBuffer));
         }
     }
 
+    const TSnapshot<uint32_t>& spotLightTransforms = m_frame->SpotLights.Column<&SpotLightBuffer::TransformAddr>();
+    SpotLightShaderBuffer* spotLightData = arena.Allocate<SpotLightShaderBuffer>(spotLightSize);
     for (uint32_t i = 0; i < spotLightSize; ++i)
     {
-        const SpotLightBuffer& spotLight = m_spotLights[i];
-
-        if (spotLight.TransformAddr != -1)
+        const uint32_t transformAddr = spotLightTransforms[i];
+        if (transformAddr != -1)
         {
-            const glm::mat4 tMat = objectManager->GetGlobalMatrix(spotLight.TransformAddr);
+            // Spot lights use nearly everything so may as well grab the whole thing
+            const SpotLightBuffer spotLight = m_frame->SpotLights.Get(i);
+
+            const glm::mat4 tMat = ObjectManager::GetGlobalMatrix(m_frame->TransformSlots, m_frame->WorldMatrices, transformAddr);
 
             const glm::vec3 pos = tMat[3].xyz();
             const glm::vec3 forward = glm::normalize(tMat[2].xyz());
 
-            SpotLightShaderBuffer buffer;
+            SpotLightShaderBuffer buffer = SpotLightShaderBuffer();
             buffer.LightPos = pos;
             buffer.LightDir = glm::vec4(forward, spotLight.Intensity);
             buffer.LightColor = spotLight.Color;
             buffer.CutoffAngle = glm::vec3(spotLight.CutoffAngle, spotLight.Radius);
 
-            VulkanUniformBuffer* uniformBuffer = m_spotLightUniforms[i];
-            uniformBuffer->SetData(a_index, &buffer);
+            spotLightData[i] = buffer;
+
+            m_uniformRing->Write(a_index, m_spotLightOffset + i * spotLightStride, &buffer, sizeof(SpotLightShaderBuffer));
         }
     }
 
     Profiler::StopFrame();
 
+    uint32_t instanceCount;
+    uint32_t visibleCount;
+    const uint8_t* visible = CullInstances(camIndices, &arena, &instanceCount, &visibleCount);
+
+    // Worst case every visible instance goes through the instance buffer so it never runs out mid pass
+    m_instanceBuffer->Reset(a_index, visibleCount);
+
+    BuildLightClusters(camIndices, &arena, a_index, pointLightData, spotLightData);
+
     PROFILESTACK("Drawing Cmd");
 
-    std::vector<std::future<vk::CommandBuffer>> futures;
-    for (uint32_t i = 0; i < camIndexSize; ++i)
+    const uint32_t passCount = camIndexSize * DrawingPassCount;
+    vk::CommandBuffer* passBuffers = arena.Allocate<vk::CommandBuffer>(passCount);
+
+    // Each pass has its own command buffer and arena so they can be picked up by any worker in any order
+    const auto recordPass = [&](uint32_t a_start, uint32_t a_end)
     {
-        const uint32_t camIndex = camIndices[i];
-        const uint32_t poolIndex = i * DrawingPassCount;
+        for (uint32_t i = a_start; i < a_end; ++i)
+        {
+            const uint32_t camSlot = i / DrawingPassCount;
+            const uint32_t camIndex = camIndices[camSlot];
 
-        futures.emplace_back(std::async(std::bind(&VulkanGraphicsEngine::DrawPass, this, camIndex, poolIndex + 0, a_index)));
-        futures.emplace_back(std::async(std::bind(&VulkanGraphicsEngine::LightPass, this, camIndex, poolIndex + 1, a_index)));
-        futures.emplace_back(std::async(std::bind(&VulkanGraphicsEngine::PostPass, this, camIndex, poolIndex + 2, a_index)));
-    }
+            switch (i % DrawingPassCount)
+            {
+            case 0:
+            {
+                passBuffers[i] = DrawPass(camIndex, i, a_index, visible + camSlot * instanceCount, instanceCount);
+
+                break;
+            }
+            case 1:
+            {
+                passBuffers[i] = LightPass(camIndex, i, a_index, camSlot);
+
+                break;
+            }
+            case 2:
+            {
+                passBuffers[i] = PostPass(camIndex, i, a_index);
+
+                break;
+            }
+            }
+        }
+    };
+
+    JobSystem* jobSystem = m_vulkanEngine->GetRenderEngine()->GetJobSystem();
+
+    JobCounter passCounter;
+    jobSystem->Run(&passCounter, passCount, 1, recordPass);
 
     constexpr vk::ClearValue ClearColor = vk::ClearValue(vk::ClearColorValue(0.0f, 0.0f, 0.0f, 1.0f));
     
@@ -726,33 +1636,49 @@ std::vector<vk::CommandBuffer> VulkanGraphicsEngine::Update(uint32_t a_index)
 
     buffer.end();
 
-    std::vector<vk::CommandBuffer> cmdBuffers;
-    cmdBuffers.emplace_back(buffer);
+    TArenaArray<vk::CommandBuffer> cmdBuffers = TArenaArray<vk::CommandBuffer>(&arena, camIndexSize * DrawingPassCount + 1);
+    cmdBuffers.Push(buffer);
 
-    for (std::future<vk::CommandBuffer>& f : futures)
+    // Helps out with the passes rather than sitting idle, any it picks up count their own allocations
+    const uint64_t waitAllocations = Profiler::GetThreadAllocations();
+    jobSystem->Wait(&passCounter);
+    const uint64_t passAllocations = Profiler::GetThreadAllocations() - waitAllocations;
+
+    for (uint32_t i = 0; i < passCount; ++i)
     {
-        f.wait();
-        vk::CommandBuffer buffer = f.get();
-        if (buffer != vk::CommandBuffer(nullptr))
+        if (passBuffers[i] != vk::CommandBuffer(nullptr))
         {
-            cmdBuffers.emplace_back(buffer);
+            cmdBuffers.Push(passBuffers[i]);
         }
     }
 
-    return cmdBuffers;
+    // Should sit at 0 once everything has warmed up
+    m_frameAllocations += Profiler::GetThreadAllocations() - startAllocations - passAllocations;
+    Profiler::SetCounter("Render Allocs", m_frameAllocations);
+
+    Profiler::SetCounter("Uniform Writes", m_uniformRing->GetWriteCount());
+
+    Profiler::SetCounter("Material Binds", m_materialBinds);
+    Profiler::SetCounter("Model Binds", m_modelBinds);
+    Profiler::SetCounter("Material Binds Unsorted", m_unsortedMaterialBinds);
+    Profiler::SetCounter("Model Binds Unsorted", m_unsortedModelBinds);
+
+    return cmdBuffers.View();
 }
 
 VulkanVertexShader* VulkanGraphicsEngine::GetVertexShader(uint32_t a_addr)
 {
-    FLARE_ASSERT_MSG(a_addr < m_vertexShaders.Size(), "GetVertexShader out of bounds");
+    VulkanVertexShader* shader = m_vertexShaders.Get(a_addr);
+    FLARE_ASSERT_MSG(shader != nullptr, "GetVertexShader invalid address");
 
-    return m_vertexShaders[a_addr];
+    return shader;
 }
 VulkanPixelShader* VulkanGraphicsEngine::GetPixelShader(uint32_t a_addr)
 {
-    FLARE_ASSERT_MSG(a_addr < m_pixelShaders.Size(), "GetPixelShader out of bounds");
+    VulkanPixelShader* shader = m_pixelShaders.Get(a_addr);
+    FLARE_ASSERT_MSG(shader != nullptr, "GetPixelShader invalid address");
 
-    return m_pixelShaders[a_addr];
+    return shader;
 }
 
 CameraBuffer VulkanGraphicsEngine::GetCameraBuffer(uint32_t a_addr)
@@ -761,6 +1687,20 @@ CameraBuffer VulkanGraphicsEngine::GetCameraBuffer(uint32_t a_addr)
 
     return m_cameraBuffers[a_addr];
 }
+uint32_t VulkanGraphicsEngine::GetCameraUniformOffset(uint32_t a_bufferIndex) const
+{
+    return m_cameraOffset + a_bufferIndex * m_uniformRing->GetAlignedSize(sizeof(CameraShaderBuffer));
+}
+const CameraBuffer& VulkanGraphicsEngine::GetFrameCameraBuffer(uint32_t a_addr) const
+{
+    FLARE_ASSERT_MSG(a_addr < m_frame->Cameras.Size(), "GetFrameCameraBuffer out of bounds");
+
+    return m_frame->Cameras[a_addr];
+}
+glm::mat4 VulkanGraphicsEngine::GetFrameGlobalMatrix(uint32_t a_transformAddr) const
+{
+    return ObjectManager::GetGlobalMatrix(m_frame->TransformSlots, m_frame->WorldMatrices, a_transformAddr);
+}
 
 VulkanModel* VulkanGraphicsEngine::GetModel(uint32_t a_addr)
 {
@@ -769,9 +1709,8 @@ VulkanModel* VulkanGraphicsEngine::GetModel(uint32_t a_addr)
         return nullptr;
     }
 
-    FLARE_ASSERT_MSG(a_addr < m_models.Size(), "GetModel out of bounds");
-
-    return m_models[a_addr];
+    // Stale addresses come back as null instead of whatever is in the slot now
+    return m_models.Get(a_addr);
 }
 
 VulkanTexture* VulkanGraphicsEngine::GetTexture(uint32_t a_addr)
@@ -781,9 +1720,7 @@ VulkanTexture* VulkanGraphicsEngine::GetTexture(uint32_t a_addr)
         return nullptr;
     }
 
-    FLARE_ASSERT_MSG(a_addr < m_textures.Size(), "GetTexture out of bounds");
-
-    return m_textures[a_addr];
+    return m_textures.Get(a_addr);
 }
 VulkanRenderTexture* VulkanGraphicsEngine::GetRenderTexture(uint32_t a_addr)
 {
@@ -792,7 +1729,5 @@ VulkanRenderTexture* VulkanGraphicsEngine::GetRenderTexture(uint32_t a_addr)
         return nullptr;
     }
 
-    FLARE_ASSERT_MSG(a_addr < m_renderTextures.Size(), "GetRenderTexture out of bounds");
-
-    return m_renderTextures[a_addr];
+    return m_renderTextures.Get(a_addr);
 }
\ No newline at end of file
@@ -28,6 +28,7 @@
 #include "Trace.h"
 
 static VulkanGraphicsEngineBindings* Engine = nullptr;
+static RuntimeManager* Runtime = nullptr;
 
 #define VULKANGRAPHICS_RUNTIME_ATTACH(ret, namespace, klass, name, code, ...) a_runtime->BindFunction(RUNTIME_FUNCTION_STRING(namespace, klass, name), (void*)RUNTIME_FUNCTION_NAME(klass, name));
 
@@ -53,6 +54,8 @@ static VulkanGraphicsEngineBindings* Engine = nullptr;
     F(void, FlareEngine.Rendering, MeshRenderer, GenerateRenderStack, { Engine->GenerateRenderStack(a_addr); }, uint32_t a_addr) \
     F(void, FlareEngine.Rendering, MeshRenderer, DestroyRenderStack, { Engine->DestroyRenderStack(a_addr); }, uint32_t a_addr) \
     \
+    F(uint32_t, FlareEngine.Rendering, SceneQuery, RayCastMesh, { return Engine->RayCastMeshes(a_origin, a_direction, a_maxDistance, a_distance); }, glm::vec3 a_origin, glm::vec3 a_direction, float a_maxDistance, float* a_distance) \
+    \
     F(void, FlareEngine.Rendering, Texture, DestroyTexture, { Engine->DestroyTexture(a_addr); }, uint32_t a_addr) \
     \
     F(uint32_t, FlareEngine.Rendering, TextureSampler, GenerateTextureSampler, { return Engine->GenerateTextureSampler(a_texture, (FlareBase::e_TextureFilter)a_filter, (FlareBase::e_TextureAddress)a_addressMode ); }, uint32_t a_texture, uint32_t a_filter, uint32_t a_addressMode) \
@@ -325,6 +328,32 @@ FLARE_MONO_EXPORT(void, RUNTIME_FUNCTION_NAME(Model, DestroyModel), uint32_t a_a
     Engine->DestroyModel(a_addr);
 }
 
+static MonoArray* MeshAddrsToArray(const std::vector<uint32_t>& a_meshes)
+{
+    const uint32_t count = (uint32_t)a_meshes.size();
+
+    MonoArray* arr = mono_array_new(Runtime->GetDomain(), mono_get_uint32_class(), (uintptr_t)count);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        mono_array_set(arr, uint32_t, i, a_meshes[i]);
+    }
+
+    return arr;
+}
+
+FLARE_MONO_EXPORT(MonoArray*, RUNTIME_FUNCTION_NAME(SceneQuery, GetAABBMeshes), glm::vec3 a_min, glm::vec3 a_max)
+{
+    return MeshAddrsToArray(Engine->QueryMeshesAABB(a_min, a_max));
+}
+FLARE_MONO_EXPORT(MonoArray*, RUNTIME_FUNCTION_NAME(SceneQuery, GetSphereMeshes), glm::vec3 a_center, float a_radius)
+{
+    return MeshAddrsToArray(Engine->QueryMeshesSphere(a_center, a_radius));
+}
+FLARE_MONO_EXPORT(MonoArray*, RUNTIME_FUNCTION_NAME(SceneQuery, GetFrustumMeshes), uint32_t a_camAddr, glm::vec2 a_screenSize)
+{
+    return MeshAddrsToArray(Engine->QueryMeshesFrustum(a_camAddr, a_screenSize));
+}
+
 FLARE_MONO_EXPORT(void, RUNTIME_FUNCTION_NAME(RenderCommand, DrawModel), MonoArray* a_transform, uint32_t a_addr)
 {
     glm::mat4 transform;
@@ -343,6 +372,7 @@ VulkanGraphicsEngineBindings::VulkanGraphicsEngineBindings(RuntimeManager* a_run
     m_graphicsEngine = a_graphicsEngine;
 
     Engine = this;
+    Runtime = a_runtime;
 
     TRACE("Binding Vulkan functions to C#");
     VULKANGRAPHICS_BINDING_FUNCTION_TABLE(VULKANGRAPHICS_RUNTIME_ATTACH)
@@ -359,6 +389,10 @@ VulkanGraphicsEngineBindings::VulkanGraphicsEngineBindings(RuntimeManager* a_run
     BIND_FUNCTION(a_runtime, FlareEngine.Rendering, Model, GenerateFromFile);
     BIND_FUNCTION(a_runtime, FlareEngine.Rendering, Model, DestroyModel);
 
+    BIND_FUNCTION(a_runtime, FlareEngine.Rendering, SceneQuery, GetAABBMeshes);
+    BIND_FUNCTION(a_runtime, FlareEngine.Rendering, SceneQuery, GetSphereMeshes);
+    BIND_FUNCTION(a_runtime, FlareEngine.Rendering, SceneQuery, GetFrustumMeshes);
+
     BIND_FUNCTION(a_runtime, FlareEngine.Rendering, RenderCommand, DrawModel);
 }
 VulkanGraphicsEngineBindings::~VulkanGraphicsEngineBindings()
@@ -372,25 +406,7 @@ uint32_t VulkanGraphicsEngineBindings::GenerateFVertexShaderAddr(const std::stri
 
     VulkanVertexShader* shader = VulkanVertexShader::CreateFromFShader(m_graphicsEngine->m_vulkanEngine, a_str);
 
-    uint32_t size = 0;
-    {
-        TLockArray<VulkanVertexShader*> a = m_graphicsEngine->m_vertexShaders.ToLockArray();
-
-        size = a.Size();
-        for (uint32_t i = 0; i < size; ++i)
-        {
-            if (a[i] == nullptr)
-            {
-                a[i] = shader;
-
-                return i;
-            }
-        }
-    }
-    
-    m_graphicsEngine->m_vertexShaders.Push(shader);
-
-    return size;
+    return m_graphicsEngine->m_vertexShaders.Insert(shader);
 }
 uint32_t VulkanGraphicsEngineBindings::GenerateGLSLVertexShaderAddr(const std::string_view& a_str) const
 {
@@ -398,35 +414,14 @@ uint32_t VulkanGraphicsEngineBindings::GenerateGLSLVertexShaderAddr(const std::s
 
     VulkanVertexShader* shader = VulkanVertexShader::CreateFromGLSL(m_graphicsEngine->m_vulkanEngine, a_str);
 
-    uint32_t size = 0;
-    {
-        TLockArray<VulkanVertexShader*> a = m_graphicsEngine->m_vertexShaders.ToLockArray();
-
-        size = a.Size();
-        for (uint32_t i = 0; i < size; ++i)
-        {
-            if (a[i] == nullptr)
-            {
-                a[i] = shader;
-
-                return i;
-            }
-        }
-    }
-
-    m_graphicsEngine->m_vertexShaders.Push(shader);
-
-    return size;
+    return m_graphicsEngine->m_vertexShaders.Insert(shader);
 }
 void VulkanGraphicsEngineBindings::DestroyVertexShader(uint32_t a_addr) const
 {
-    TLockArray<VulkanVertexShader*> a = m_graphicsEngine->m_vertexShaders.ToLockArray();
+    const VulkanVertexShader* shader = m_graphicsEngine->m_vertexShaders.Erase(a_addr);
+    FLARE_ASSERT_MSG(shader != nullptr, "DestroyVertexShader invalid address or already destroyed")
 
-    FLARE_ASSERT_MSG(a_addr < a.Size(), "DestroyVertexShader out of bounds")
-    FLARE_ASSERT_MSG(a[a_addr] != nullptr, "DestroyVertexShader already destroyed")
-
-    delete a[a_addr];
-    a[a_addr] = nullptr;
+    delete shader;
 }
 
 uint32_t VulkanGraphicsEngineBindings::GenerateFPixelShaderAddr(const std::string_view& a_str) const
@@ -435,25 +430,7 @@ uint32_t VulkanGraphicsEngineBindings::GenerateFPixelShaderAddr(const std::strin
 
     VulkanPixelShader* shader = VulkanPixelShader::CreateFromFShader(m_graphicsEngine->m_vulkanEngine, a_str);
 
-    uint32_t size = 0;
-    {
-        TLockArray<VulkanPixelShader*> a = m_graphicsEngine->m_pixelShaders.ToLockArray();
-
-        size = a.Size();
-        for (uint32_t i = 0; i < size; ++i)
-        {
-            if (a[i] == nullptr)
-            {
-                a[i] = shader;
-
-                return i;
-            }
-        }
-    }
-
-    m_graphicsEngine->m_pixelShaders.Push(shader);
-
-    return size;
+    return m_graphicsEngine->m_pixelShaders.Insert(shader);
 }
 uint32_t VulkanGraphicsEngineBindings::GenerateGLSLPixelShaderAddr(const std::string_view& a_str) const
 {
@@ -461,35 +438,14 @@ uint32_t VulkanGraphicsEngineBindings::GenerateGLSLPixelShaderAddr(const std::st
 
     VulkanPixelShader* shader = VulkanPixelShader::CreateFromGLSL(m_graphicsEngine->m_vulkanEngine, a_str);
 
-    uint32_t size = 0;
-    {
-        TLockArray<VulkanPixelShader*> a = m_graphicsEngine->m_pixelShaders.ToLockArray();
-
-        size = a.Size();
-        for (uint32_t i = 0; i < size; ++i)
-        {
-            if (a[i] == nullptr)
-            {
-                a[i] = shader;
-
-                return i;
-            }
-        }
-    }
-
-    m_graphicsEngine->m_pixelShaders.Push(shader);
-
-    return size;
+    return m_graphicsEngine->m_pixelShaders.Insert(shader);
 }
 void VulkanGraphicsEngineBindings::DestroyPixelShader(uint32_t a_addr) const
 {
-    TLockArray<VulkanPixelShader*> a = m_graphicsEngine->m_pixelShaders.ToLockArray();
-
-    FLARE_ASSERT_MSG(a_addr < a.Size(), "DestroyPixelShader out of bounds")
-    FLARE_ASSERT_MSG(a[a_addr] != nullptr, "DestroyPixelShader already destroyed")
+    const VulkanPixelShader* shader = m_graphicsEngine->m_pixelShaders.Erase(a_addr);
+    FLARE_ASSERT_MSG(shader != nullptr, "DestroyPixelShader invalid address or already destroyed")
 
-    delete a[a_addr];
-    a[a_addr] = nullptr;
+    delete shader;
 }
 
 uint32_t VulkanGraphicsEngineBindings::GenerateInternalShaderProgram(FlareBase::e_InternalRenderProgram a_program) const
@@ -545,7 +501,7 @@ uint32_t VulkanGraphicsEngineBindings::GenerateInternalShaderProgram(FlareBase::
             program.ShaderBufferInputs[i] = FlareBase::ShaderBufferInput(i, FlareBase::ShaderBufferType_Texture, FlareBase::ShaderSlot_Pixel);
         }
 
-        program.ShaderBufferInputs[TextureCount + 0] = FlareBase::ShaderBufferInput(TextureCount + 0, FlareBase::ShaderBufferType_PointLightBuffer, FlareBase::ShaderSlot_Pixel, 1);
+        program.ShaderBufferInputs[TextureCount + 0] = FlareBase::ShaderBufferInput(TextureCount + 0, FlareBase::ShaderBufferType_PointLightClusterBuffer, FlareBase::ShaderSlot_Pixel, 1);
         program.ShaderBufferInputs[TextureCount + 1] = FlareBase::ShaderBufferInput(TextureCount + 1, FlareBase::ShaderBufferType_CameraBuffer, FlareBase::ShaderSlot_Pixel, 2);
 
         break;
@@ -569,7 +525,7 @@ uint32_t VulkanGraphicsEngineBindings::GenerateInternalShaderProgram(FlareBase::
             program.ShaderBufferInputs[i] = FlareBase::ShaderBufferInput(i, FlareBase::ShaderBufferType_Texture, FlareBase::ShaderSlot_Pixel);
         }
 
-        program.ShaderBufferInputs[TextureCount + 0] = FlareBase::ShaderBufferInput(TextureCount + 0, FlareBase::ShaderBufferType_SpotLightBuffer, FlareBase::ShaderSlot_Pixel, 1);
+        program.ShaderBufferInputs[TextureCount + 0] = FlareBase::ShaderBufferInput(TextureCount + 0, FlareBase::ShaderBufferType_SpotLightClusterBuffer, FlareBase::ShaderSlot_Pixel, 1);
         program.ShaderBufferInputs[TextureCount + 1] = FlareBase::ShaderBufferInput(TextureCount + 1, FlareBase::ShaderBufferType_CameraBuffer, FlareBase::ShaderSlot_Pixel, 2);
 
         break;
@@ -607,14 +563,13 @@ uint32_t VulkanGraphicsEngineBindings::GenerateInternalShaderProgram(FlareBase::
 }
 uint32_t VulkanGraphicsEngineBindings::GenerateShaderProgram(const FlareBase::RenderProgram& a_program) const
 {
-    FLARE_ASSERT_MSG(a_program.PixelShader < m_graphicsEngine->m_pixelShaders.Size(), "GenerateShaderProgram PixelShader out of bounds")
-    FLARE_ASSERT_MSG(a_program.VertexShader < m_graphicsEngine->m_vertexShaders.Size(), "GenerateShaderProgram VertexShader out of bounds")
+    FLARE_ASSERT_MSG(m_graphicsEngine->m_pixelShaders.Valid(a_program.PixelShader), "GenerateShaderProgram PixelShader invalid address")
+    FLARE_ASSERT_MSG(m_graphicsEngine->m_vertexShaders.Valid(a_program.VertexShader), "GenerateShaderProgram VertexShader invalid address")
 
-    uint32_t size = 0;
     TRACE("Creating Shader Program");
     {
         TLockArray<FlareBase::RenderProgram> a = m_graphicsEngine->m_shaderPrograms.ToLockArray();
-        size = a.Size();
+        const uint32_t size = a.Size();
         for (uint32_t i = 0; i < size; ++i)
         {
             if (a[i].Flags & 0b1 << FlareBase::RenderProgram::FreeFlag)
@@ -630,10 +585,14 @@ uint32_t VulkanGraphicsEngineBindings::GenerateShaderProgram(const FlareBase::Re
     }
     
     TRACE("Allocating Shader Program");
-    m_graphicsEngine->m_shaderPrograms.Push(a_program);
-    m_graphicsEngine->m_shaderPrograms[size].Data = new VulkanShaderData(m_graphicsEngine->m_vulkanEngine, m_graphicsEngine, size);
+    const uint32_t addr = m_graphicsEngine->m_shaderPrograms.Push(a_program);
 
-    return size;
+    // Shader data reads the program back so needs to exist first
+    FlareBase::RenderProgram program = a_program;
+    program.Data = new VulkanShaderData(m_graphicsEngine->m_vulkanEngine, m_graphicsEngine, addr);
+    m_graphicsEngine->m_shaderPrograms.LockSet(addr, program);
+
+    return addr;
 }
 void VulkanGraphicsEngineBindings::DestroyShaderProgram(uint32_t a_addr) const
 {
@@ -651,7 +610,8 @@ void VulkanGraphicsEngineBindings::DestroyShaderProgram(uint32_t a_addr) const
 
     if (program.Data != nullptr)
     {
-        delete (VulkanShaderData*)program.Data;
+        // Published packets can still be drawing with it
+        m_graphicsEngine->RetireShaderData((VulkanShaderData*)program.Data);
         program.Data = nullptr;
     }
 }
@@ -679,7 +639,7 @@ void VulkanGraphicsEngineBindings::SetRenderProgram(uint32_t a_addr, const Flare
 {
     FLARE_ASSERT_MSG(a_addr < m_graphicsEngine->m_shaderPrograms.Size(), "SetRenderProgram out of bounds")
 
-    m_graphicsEngine->m_shaderPrograms[a_addr] = a_program;
+    m_graphicsEngine->m_shaderPrograms.LockSet(a_addr, a_program);
 }
 
 uint32_t VulkanGraphicsEngineBindings::GenerateCameraBuffer(uint32_t a_transformAddr) const
@@ -688,15 +648,14 @@ uint32_t VulkanGraphicsEngineBindings::GenerateCameraBuffer(uint32_t a_transform
 
     const CameraBuffer buff = CameraBuffer(a_transformAddr);
 
-    uint32_t size = 0;
     {
         TRACE("Getting Camera Buffer");
         TLockArray<CameraBuffer> a = m_graphicsEngine->m_cameraBuffers.ToLockArray();
 
-        size = a.Size();
+        const uint32_t size = a.Size();
         for (uint32_t i = 0; i < size; ++i)
         {
-            if (a[i].TransformAddr != -1)
+            if (a[i].TransformAddr == -1)
             {
                 a[i] = buff;
 
@@ -707,9 +666,7 @@ uint32_t VulkanGraphicsEngineBindings::GenerateCameraBuffer(uint32_t a_transform
     
 
     TRACE("Allocating Camera Buffer");
-    m_graphicsEngine->m_cameraBuffers.Push(buff);
-
-    return size;
+    return m_graphicsEngine->m_cameraBuffers.Push(buff);
 }
 void VulkanGraphicsEngineBindings::DestroyCameraBuffer(uint32_t a_addr) const
 {
@@ -760,36 +717,14 @@ uint32_t VulkanGraphicsEngineBindings::GenerateModel(const char* a_vertices, uin
 
     VulkanModel* model = new VulkanModel(m_graphicsEngine->m_vulkanEngine, a_vertexCount, a_vertices, a_vertexStride, a_indexCount, a_indices);
 
-    uint32_t size = 0;
-    {
-        TLockArray<VulkanModel*> a = m_graphicsEngine->m_models.ToLockArray();
-
-        size = a.Size();
-        for (uint32_t i = 0; i < size; ++i)
-        {
-            if (a[i] == nullptr)
-            {
-                a[i] = model;
-
-                return i;
-            }
-        }
-    }
-
-    TRACE("Allocating Model Buffer");
-    m_graphicsEngine->m_models.Push(model);
-
-    return size;
+    return m_graphicsEngine->m_models.Insert(model);
 }
 void VulkanGraphicsEngineBindings::DestroyModel(uint32_t a_addr) const
 {
-    FLARE_ASSERT_MSG(a_addr < m_graphicsEngine->m_models.Size(), "DestroyModel out of bounds")
+    const VulkanModel* model = m_graphicsEngine->m_models.Erase(a_addr);
 
-    VulkanModel* model = m_graphicsEngine->m_models[a_addr];
+    FLARE_ASSERT_MSG(model != nullptr, "DestroyModel invalid address or already destroyed")
 
-    FLARE_ASSERT_MSG(model != nullptr, "DestroyModel already destroyed")
-
-    m_graphicsEngine->m_models[a_addr] = nullptr;
     delete model;
 }
 
@@ -798,126 +733,132 @@ uint32_t VulkanGraphicsEngineBindings::GenerateMeshRenderBuffer(uint32_t a_mater
     TRACE("Creating Render Buffer");
     const MeshRenderBuffer buffer = MeshRenderBuffer(a_materialAddr, a_modelAddr, a_transformAddr);
 
-    uint32_t size = 0;
+    uint32_t addr;
     {
-        TLockArray<MeshRenderBuffer> a = m_graphicsEngine->m_renderBuffers.ToLockArray();
+        const std::unique_lock g = std::unique_lock(m_graphicsEngine->m_renderBuffers.Lock());
 
-        size = a.Size();
-        for (uint32_t i = 0; i < size; ++i)
+        if (!m_graphicsEngine->m_freeRenderBuffers.empty())
         {
-            if (a[i].MaterialAddr == -1)
-            {
-                a[i] = buffer;
+            addr = m_graphicsEngine->m_freeRenderBuffers.back();
+            m_graphicsEngine->m_freeRenderBuffers.pop_back();
 
-                return i;
-            }
+            m_graphicsEngine->m_renderBuffers.USet(addr, buffer);
+        }
+        else
+        {
+            TRACE("Allocating Render Buffer");
+            addr = m_graphicsEngine->m_renderBuffers.UPush(buffer);
         }
     }
 
-    TRACE("Allocating Render Buffer");
-    m_graphicsEngine->m_renderBuffers.Push(buffer);
+    AABB modelBounds;
+    const VulkanModel* model = m_graphicsEngine->GetModel(a_modelAddr);
+    if (model != nullptr)
+    {
+        modelBounds = model->GetBounds();
+    }
 
-    return size;
+    ObjectManager* objManager = m_graphicsEngine->m_vulkanEngine->GetRenderEngine()->GetObjectManager();
+    m_graphicsEngine->m_meshBounds.AddMesh(addr, a_transformAddr, modelBounds, objManager->GetGlobalMatrix(a_transformAddr));
+
+    return addr;
 }
 void VulkanGraphicsEngineBindings::DestroyMeshRenderBuffer(uint32_t a_addr) const
 {
     FLARE_ASSERT_MSG(a_addr < m_graphicsEngine->m_renderBuffers.Size(), "DestroyMeshRenderBuffer out of bounds");
 
     TRACE("Destroying Render Buffer");
-    m_graphicsEngine->m_renderBuffers[a_addr].MaterialAddr = -1;
+    m_graphicsEngine->m_meshBounds.RemoveMesh(a_addr);
+
+    const std::unique_lock g = std::unique_lock(m_graphicsEngine->m_renderBuffers.Lock());
+
+    m_graphicsEngine->m_renderBuffers.USet(a_addr, MeshRenderBuffer());
+    m_graphicsEngine->m_freeRenderBuffers.emplace_back(a_addr);
 }
 void VulkanGraphicsEngineBindings::GenerateRenderStack(uint32_t a_meshAddr) const
 {
     FLARE_ASSERT_MSG(a_meshAddr < m_graphicsEngine->m_renderBuffers.Size(), "GenerateRenderStack out of bounds");
 
     TRACE("Pushing RenderStack");
-    const MeshRenderBuffer& buffer = m_graphicsEngine->m_renderBuffers[a_meshAddr];
+    const MeshRenderBuffer buffer = m_graphicsEngine->m_renderBuffers[a_meshAddr];
 
-    {
-        TLockArray<MaterialRenderStack> a = m_graphicsEngine->m_renderStacks.ToLockArray();
-
-        const uint32_t size = a.Size();
-
-        for (uint32_t i = 0; i < size; ++i)
-        {
-            if (a[i].Add(buffer))
-            {
-                return;
-            }
-        }
-    }
-    
+    const std::unique_lock g = std::unique_lock(m_graphicsEngine->m_renderStacks.Lock());
 
-    TRACE("Allocating RenderStack");
-    m_graphicsEngine->m_renderStacks.Push(buffer);
+    m_graphicsEngine->m_renderStackIndex.UAdd(&m_graphicsEngine->m_renderStacks, a_meshAddr, buffer);
 }
 void VulkanGraphicsEngineBindings::DestroyRenderStack(uint32_t a_meshAddr) const
 {
     FLARE_ASSERT_MSG(a_meshAddr < m_graphicsEngine->m_renderBuffers.Size(), "DestroyRenderStack out of bounds");
 
     TRACE("Removing RenderStack");
-    const MeshRenderBuffer& buffer = m_graphicsEngine->m_renderBuffers[a_meshAddr];
+    const MeshRenderBuffer buffer = m_graphicsEngine->m_renderBuffers[a_meshAddr];
 
-    {
-        TLockArray<MaterialRenderStack> a = m_graphicsEngine->m_renderStacks.ToLockArray();
+    const std::unique_lock g = std::unique_lock(m_graphicsEngine->m_renderStacks.Lock());
 
-        const uint32_t size = a.Size();
-        for (uint32_t i = 0; i < size; ++i)
-        {
-            if (a[i].Remove(buffer))
-            {
-                if (a[i].Empty())
-                {
-                    TRACE("Destroying RenderStack");
-                    m_graphicsEngine->m_renderStacks.UErase(i);
-                }
+    m_graphicsEngine->m_renderStackIndex.URemove(&m_graphicsEngine->m_renderStacks, a_meshAddr, buffer);
+}
 
-                return;
-            }
-        }
-    }
+std::vector<uint32_t> VulkanGraphicsEngineBindings::QueryMeshesAABB(const glm::vec3& a_min, const glm::vec3& a_max) const
+{
+    std::vector<uint32_t> meshes;
+    m_graphicsEngine->m_meshBounds.Query(AABB(a_min, a_max), &meshes);
+
+    return meshes;
 }
+std::vector<uint32_t> VulkanGraphicsEngineBindings::QueryMeshesSphere(const glm::vec3& a_center, float a_radius) const
+{
+    std::vector<uint32_t> meshes;
+    m_graphicsEngine->m_meshBounds.Query(BoundingSphere{ a_center, a_radius }, &meshes);
 
-uint32_t VulkanGraphicsEngineBindings::GenerateTexture(uint32_t a_width, uint32_t a_height, const void* a_data)
+    return meshes;
+}
+std::vector<uint32_t> VulkanGraphicsEngineBindings::QueryMeshesFrustum(uint32_t a_camAddr, const glm::vec2& a_screenSize) const
 {
-    VulkanTexture* texture = new VulkanTexture(m_graphicsEngine->m_vulkanEngine, a_width, a_height, a_data);
+    FLARE_ASSERT_MSG(a_camAddr < m_graphicsEngine->m_cameraBuffers.Size(), "QueryMeshesFrustum out of bounds");
 
-    uint32_t size = 0;
-    {
-        TLockArray<VulkanTexture*> a = m_graphicsEngine->m_textures.ToLockArray();
+    const CameraBuffer camBuf = m_graphicsEngine->m_cameraBuffers[a_camAddr];
 
-        size = a.Size();
-        for (uint32_t i = 0; i < size; ++i)
-        {
-            if (a[i] == nullptr)
-            {
-                a[i] = texture;
+    FLARE_ASSERT_MSG(camBuf.TransformAddr != -1, "QueryMeshesFrustum invalid transform");
 
-                return i;
-            }
-        }
+    ObjectManager* objManager = m_graphicsEngine->m_vulkanEngine->GetRenderEngine()->GetObjectManager();
+    const glm::mat4 view = glm::inverse(objManager->GetGlobalMatrix(camBuf.TransformAddr));
+
+    std::vector<uint32_t> meshes;
+    m_graphicsEngine->m_meshBounds.Query(Frustum::FromMatrix(camBuf.ToProjection(a_screenSize) * view), &meshes);
+
+    return meshes;
+}
+uint32_t VulkanGraphicsEngineBindings::RayCastMeshes(const glm::vec3& a_origin, const glm::vec3& a_direction, float a_maxDistance, float* a_distance) const
+{
+    MeshRayHit hit;
+    if (!m_graphicsEngine->m_meshBounds.RayCast(Ray{ a_origin, glm::normalize(a_direction) }, a_maxDistance, &hit))
+    {
+        return -1;
     }
 
-    m_graphicsEngine->m_textures.Push(texture);
+    *a_distance = hit.Distance;
 
-    return size;
+    return hit.MeshAddr;
+}
+
+uint32_t VulkanGraphicsEngineBindings::GenerateTexture(uint32_t a_width, uint32_t a_height, const void* a_data)
+{
+    VulkanTexture* texture = new VulkanTexture(m_graphicsEngine->m_vulkanEngine, a_width, a_height, a_data);
+
+    return m_graphicsEngine->m_textures.Insert(texture);
 }
 void VulkanGraphicsEngineBindings::DestroyTexture(uint32_t a_addr) const
 {
-    FLARE_ASSERT_MSG(a_addr < m_graphicsEngine->m_textures.Size(), "DestroyTexture Texture out of bounds");
-    
-    VulkanTexture* texture = m_graphicsEngine->m_textures[a_addr];
+    const VulkanTexture* texture = m_graphicsEngine->m_textures.Erase(a_addr);
 
-    FLARE_ASSERT_MSG(texture != nullptr, "DestroyTexture already destroyed");
+    FLARE_ASSERT_MSG(texture != nullptr, "DestroyTexture invalid address or already destroyed");
 
-    m_graphicsEngine->m_textures[a_addr] = nullptr;
     delete texture;
 }
 
 uint32_t VulkanGraphicsEngineBindings::GenerateTextureSampler(uint32_t a_texture, FlareBase::e_TextureFilter a_filter, FlareBase::e_TextureAddress a_addressMode) const
 {
-    FLARE_ASSERT_MSG(a_texture < m_graphicsEngine->m_textures.Size(), "GenerateTextureSampler Texture out of bounds");
-    FLARE_ASSERT_MSG(m_graphicsEngine->m_textures[a_texture] != nullptr, "GenerateTextureSampler, Texture destroyed");
+    FLARE_ASSERT_MSG(m_graphicsEngine->m_textures.Valid(a_texture), "GenerateTextureSampler invalid texture or texture destroyed");
 
     FlareBase::TextureSampler sampler;
     sampler.Addr = a_texture;
@@ -950,9 +891,8 @@ uint32_t VulkanGraphicsEngineBindings::GenerateTextureSampler(uint32_t a_texture
 }
 uint32_t VulkanGraphicsEngineBindings::GenerateRenderTextureSampler(uint32_t a_renderTexture, uint32_t a_textureIndex, FlareBase::e_TextureFilter a_filter, FlareBase::e_TextureAddress a_addressMode) const
 { 
-    FLARE_ASSERT_MSG(a_renderTexture < m_graphicsEngine->m_renderTextures.Size(), "GenerateRenderTextureSampler RenderTexture out of bounds");
-    FLARE_ASSERT_MSG(m_graphicsEngine->m_renderTextures[a_renderTexture] != nullptr, "GenerateRenderTextureSampler RenderTexture destroyed");
-    FLARE_ASSERT_MSG(a_textureIndex < m_graphicsEngine->m_renderTextures[a_renderTexture]->GetTextureCount(), "GenerateRenderTextureSampler texture index out of bounds");
+    FLARE_ASSERT_MSG(m_graphicsEngine->m_renderTextures.Valid(a_renderTexture), "GenerateRenderTextureSampler invalid RenderTexture or RenderTexture destroyed");
+    FLARE_ASSERT_MSG(a_textureIndex < m_graphicsEngine->m_renderTextures.Get(a_renderTexture)->GetTextureCount(), "GenerateRenderTextureSampler texture index out of bounds");
 
     FlareBase::TextureSampler sampler;
     sampler.Addr = a_renderTexture;
@@ -986,8 +926,7 @@ uint32_t VulkanGraphicsEngineBindings::GenerateRenderTextureSampler(uint32_t a_r
 }
 uint32_t VulkanGraphicsEngineBindings::GenerateRenderTextureDepthSampler(uint32_t a_renderTexture, FlareBase::e_TextureFilter a_filter, FlareBase::e_TextureAddress a_addressMode) const
 {
-    FLARE_ASSERT_MSG(a_renderTexture < m_graphicsEngine->m_renderTextures.Size(), "GenerateRenderTextureDepthSampler out of bounds");
-    FLARE_ASSERT_MSG(m_graphicsEngine->m_renderTextures[a_renderTexture] != nullptr, "GenerateRenderTextureDepthSampler RenderTexture destroyed");
+    FLARE_ASSERT_MSG(m_graphicsEngine->m_renderTextures.Valid(a_renderTexture), "GenerateRenderTextureDepthSampler invalid RenderTexture or RenderTexture destroyed");
 
     FlareBase::TextureSampler sampler;
     sampler.Addr = a_renderTexture;
@@ -1046,76 +985,51 @@ uint32_t VulkanGraphicsEngineBindings::GenerateRenderTexture(uint32_t a_count, u
 
     VulkanRenderTexture* texture = new VulkanRenderTexture(engine, a_count, a_width, a_height, a_depthTexture, a_hdr);
 
-    uint32_t size = 0;
-    {
-        TLockArray<VulkanRenderTexture*> a = m_graphicsEngine->m_renderTextures.ToLockArray();
-
-        size = a.Size();
-        for (uint32_t i = 0; i < size; ++i)
-        {
-            if (a[i] == nullptr)
-            {
-                a[i] = texture;
-
-                return i;
-            }
-        }
-    }
-
-    TRACE("Allocating RenderTexture Buffer");
-    m_graphicsEngine->m_renderTextures.Push(texture);
-
-    return size;
+    return m_graphicsEngine->m_renderTextures.Insert(texture);
 }
 void VulkanGraphicsEngineBindings::DestroyRenderTexture(uint32_t a_addr) const
 {
-    FLARE_ASSERT_MSG(a_addr < m_graphicsEngine->m_renderTextures.Size(), "DestroyRenderTexture out of bounds");
-
-    VulkanRenderTexture* tex = m_graphicsEngine->m_renderTextures[a_addr];
+    const VulkanRenderTexture* tex = m_graphicsEngine->m_renderTextures.Erase(a_addr);
 
-    m_graphicsEngine->m_renderTextures[a_addr] = nullptr;
+    FLARE_ASSERT_MSG(tex != nullptr, "DestroyRenderTexture invalid address or already destroyed");
 
     delete tex;
 }
 uint32_t VulkanGraphicsEngineBindings::GetRenderTextureTextureCount(uint32_t a_addr) const
 {
-    FLARE_ASSERT_MSG(a_addr < m_graphicsEngine->m_renderTextures.Size(), "GetRenderTextureCount out of bounds");
-
-    const VulkanRenderTexture* texture = m_graphicsEngine->m_renderTextures[a_addr];
+    const VulkanRenderTexture* texture = m_graphicsEngine->m_renderTextures.Get(a_addr);
+    FLARE_ASSERT_MSG(texture != nullptr, "GetRenderTextureCount invalid address");
 
     return texture->GetTextureCount();
 }
 bool VulkanGraphicsEngineBindings::RenderTextureHasDepth(uint32_t a_addr) const
 {
-    FLARE_ASSERT_MSG(a_addr < m_graphicsEngine->m_renderTextures.Size(), "RenderTextureHasDepth out of bounds");
-
-    const VulkanRenderTexture* texture = m_graphicsEngine->m_renderTextures[a_addr];
+    const VulkanRenderTexture* texture = m_graphicsEngine->m_renderTextures.Get(a_addr);
+    FLARE_ASSERT_MSG(texture != nullptr, "RenderTextureHasDepth invalid address");
 
     return texture->HasDepthTexture();
 }
 uint32_t VulkanGraphicsEngineBindings::GetRenderTextureWidth(uint32_t a_addr) const
 {
-    FLARE_ASSERT_MSG(a_addr < m_graphicsEngine->m_renderTextures.Size(), "GetRenderTextureWidth out of bounds");
-
-    const VulkanRenderTexture* texture = m_graphicsEngine->m_renderTextures[a_addr];
+    const VulkanRenderTexture* texture = m_graphicsEngine->m_renderTextures.Get(a_addr);
+    FLARE_ASSERT_MSG(texture != nullptr, "GetRenderTextureWidth invalid address");
 
     return texture->GetWidth();
 }
 uint32_t VulkanGraphicsEngineBindings::GetRenderTextureHeight(uint32_t a_addr) const
 {
-    FLARE_ASSERT_MSG(a_addr < m_graphicsEngine->m_renderTextures.Size(), "GetRenderTextureHeight out of bounds");
-
-    const VulkanRenderTexture* texture = m_graphicsEngine->m_renderTextures[a_addr];
+    const VulkanRenderTexture* texture = m_graphicsEngine->m_renderTextures.Get(a_addr);
+    FLARE_ASSERT_MSG(texture != nullptr, "GetRenderTextureHeight invalid address");
 
     return texture->GetHeight();
 }
 void VulkanGraphicsEngineBindings::ResizeRenderTexture(uint32_t a_addr, uint32_t a_width, uint32_t a_height) const
 {
-    FLARE_ASSERT_MSG(a_addr < m_graphicsEngine->m_renderTextures.Size(), "ResizeRenderTexture out of bounds");
     FLARE_ASSERT_MSG(a_width > 0, "ResizeRenderTexture width 0")
     FLARE_ASSERT_MSG(a_height > 0, "ResizeRenderTexture height 0")
 
-    VulkanRenderTexture* texture = m_graphicsEngine->m_renderTextures[a_addr];
+    VulkanRenderTexture* texture = m_graphicsEngine->m_renderTextures.Get(a_addr);
+    FLARE_ASSERT_MSG(texture != nullptr, "ResizeRenderTexture invalid address");
 
     texture->Resize(a_width, a_height);
 }
@@ -1126,16 +1040,17 @@ uint32_t VulkanGraphicsEngineBindings::GenerateDirectionalLightBuffer(uint32_t a
 
     FLARE_ASSERT_MSG(buffer.TransformAddr != -1, "GenerateDirectionalLightBuffer no transform");
 
-    uint32_t size = 0;
     {
-        TLockArray<DirectionalLightBuffer> a = m_graphicsEngine->m_directionalLights.ToLockArray();
+        const std::unique_lock g = std::unique_lock(m_graphicsEngine->m_directionalLights.Lock());
 
-        size = a.Size();
+        const uint32_t* transforms = m_graphicsEngine->m_directionalLights.UColumn<&DirectionalLightBuffer::TransformAddr>();
+
+        const uint32_t size = m_graphicsEngine->m_directionalLights.Size();
         for (uint32_t i = 0; i < size; ++i)
         {
-            if (a[i].TransformAddr != -1)
+            if (transforms[i] == -1)
             {
-                a[i] = buffer;
+                m_graphicsEngine->m_directionalLights.USet(i, buffer);
 
                 return i;
             }
@@ -1143,9 +1058,7 @@ uint32_t VulkanGraphicsEngineBindings::GenerateDirectionalLightBuffer(uint32_t a
     }
 
     TRACE("Allocating DirectionalLight Buffer");
-    m_graphicsEngine->m_directionalLights.Push(buffer);
-
-    return size;
+    return m_graphicsEngine->m_directionalLights.Push(buffer);
 }
 void VulkanGraphicsEngineBindings::SetDirectionalLightBuffer(uint32_t a_addr, const DirectionalLightBuffer& a_buffer) const
 {
@@ -1157,7 +1070,7 @@ DirectionalLightBuffer VulkanGraphicsEngineBindings::GetDirectionalLightBuffer(u
 {
     FLARE_ASSERT_MSG(a_addr < m_graphicsEngine->m_directionalLights.Size(), "GetDirectionalLightBuffer out of bounds");
 
-    return m_graphicsEngine->m_directionalLights[a_addr];
+    return m_graphicsEngine->m_directionalLights.Get(a_addr);
 }
 void VulkanGraphicsEngineBindings::DestroyDirectionalLightBuffer(uint32_t a_addr) const
 {
@@ -1172,16 +1085,17 @@ uint32_t VulkanGraphicsEngineBindings::GeneratePointLightBuffer(uint32_t a_trans
 
     FLARE_ASSERT_MSG(buffer.TransformAddr != -1, "GeneratePointLightBuffer no transform");
 
-    uint32_t size = 0;
     {
-        TLockArray<PointLightBuffer> a = m_graphicsEngine->m_pointLights.ToLockArray();
+        const std::unique_lock g = std::unique_lock(m_graphicsEngine->m_pointLights.Lock());
 
-        size = a.Size();
+        const uint32_t* transforms = m_graphicsEngine->m_pointLights.UColumn<&PointLightBuffer::TransformAddr>();
+
+        const uint32_t size = m_graphicsEngine->m_pointLights.Size();
         for (uint32_t i = 0; i < size; ++i)
         {
-            if (a[i].TransformAddr != -1)
+            if (transforms[i] == -1)
             {
-                a[i] = buffer;
+                m_graphicsEngine->m_pointLights.USet(i, buffer);
 
                 return i;
             }
@@ -1189,9 +1103,7 @@ uint32_t VulkanGraphicsEngineBindings::GeneratePointLightBuffer(uint32_t a_trans
     }
 
     TRACE("Allocating PointLight Buffer");
-    m_graphicsEngine->m_pointLights.Push(buffer);
-
-    return size;
+    return m_graphicsEngine->m_pointLights.Push(buffer);
 }
 void VulkanGraphicsEngineBindings::SetPointLightBuffer(uint32_t a_addr, const PointLightBuffer& a_buffer) const
 {
@@ -1203,7 +1115,7 @@ PointLightBuffer VulkanGraphicsEngineBindings::GetPointLightBuffer(uint32_t a_ad
 {
     FLARE_ASSERT_MSG(a_addr < m_graphicsEngine->m_pointLights.Size(), "GetPointLightBuffer out of bounds");
 
-    return m_graphicsEngine->m_pointLights[a_addr];
+    return m_graphicsEngine->m_pointLights.Get(a_addr);
 }
 void VulkanGraphicsEngineBindings::DestroyPointLightBuffer(uint32_t a_addr) const
 {
@@ -1218,16 +1130,17 @@ uint32_t VulkanGraphicsEngineBindings::GenerateSpotLightBuffer(uint32_t a_transf
 
     FLARE_ASSERT_MSG(buffer.TransformAddr != -1, "GenerateSpotLightBuffer no tranform");
 
-    uint32_t size = 0;
     {
-        TLockArray<SpotLightBuffer> a = m_graphicsEngine->m_spotLights.ToLockArray();
+        const std::unique_lock g = std::unique_lock(m_graphicsEngine->m_spotLights.Lock());
 
-        size = a.Size();
+        const uint32_t* transforms = m_graphicsEngine->m_spotLights.UColumn<&SpotLightBuffer::TransformAddr>();
+
+        const uint32_t size = m_graphicsEngine->m_spotLights.Size();
         for (uint32_t i = 0; i < size; ++i)
         {
-            if (a[i].TransformAddr != -1)
+            if (transforms[i] == -1)
             {
-                a[i] = buffer;
+                m_graphicsEngine->m_spotLights.USet(i, buffer);
 
                 return i;
             }
@@ -1235,9 +1148,7 @@ uint32_t VulkanGraphicsEngineBindings::GenerateSpotLightBuffer(uint32_t a_transf
     }
 
     TRACE("Allocating SpotLight Buffer");
-    m_graphicsEngine->m_spotLights.Push(buffer);
-
-    return size;
+    return m_graphicsEngine->m_spotLights.Push(buffer);
 }
 void VulkanGraphicsEngineBindings::SetSpotLightBuffer(uint32_t a_addr, const SpotLightBuffer& a_buffer) const
 {
@@ -1249,7 +1160,7 @@ SpotLightBuffer VulkanGraphicsEngineBindings::GetSpotLightBuffer(uint32_t a_addr
 {
     FLARE_ASSERT_MSG(a_addr < m_graphicsEngine->m_spotLights.Size(), "GetSpotLightBuffer out of bounds");
 
-    return m_graphicsEngine->m_spotLights[a_addr];
+    return m_graphicsEngine->m_spotLights.Get(a_addr);
 }
 void VulkanGraphicsEngineBindings::DestroySpotLightBuffer(uint32_t a_addr) const
 {
@@ -1281,9 +1192,8 @@ void VulkanGraphicsEngineBindings::BindRenderTexture(uint32_t a_addr) const
     VulkanRenderTexture* tex = nullptr;
     if (a_addr != -1)
     {
-        FLARE_ASSERT_MSG(a_addr < m_graphicsEngine->m_renderTextures.Size(), "BindRenderTexture out of bounds");
-
-        tex = m_graphicsEngine->m_renderTextures[a_addr];
+        tex = m_graphicsEngine->m_renderTextures.Get(a_addr);
+        FLARE_ASSERT_MSG(tex != nullptr, "BindRenderTexture invalid address");
     }
 
     m_graphicsEngine->m_renderCommands->BindRenderTexture(a_addr);
@@ -1297,15 +1207,13 @@ void VulkanGraphicsEngineBindings::BlitRTRT(uint32_t a_srcAddr, uint32_t a_dstAd
 
     if (a_srcAddr != -1)
     {
-        FLARE_ASSERT_MSG(a_srcAddr < m_graphicsEngine->m_renderTextures.Size(), "BlitRTRT source out of bounds");
-
-        srcTex = m_graphicsEngine->m_renderTextures[a_srcAddr];
+        srcTex = m_graphicsEngine->m_renderTextures.Get(a_srcAddr);
+        FLARE_ASSERT_MSG(srcTex != nullptr, "BlitRTRT invalid source");
     }
     if (a_dstAddr != -1)
     {
-        FLARE_ASSERT_MSG(a_dstAddr < m_graphicsEngine->m_renderTextures.Size(), "BlitRTRT destination out of bounds");
-
-        dstTex = m_graphicsEngine->m_renderTextures[a_dstAddr];
+        dstTex = m_graphicsEngine->m_renderTextures.Get(a_dstAddr);
+        FLARE_ASSERT_MSG(dstTex != nullptr, "BlitRTRT invalid destination");
     }
 
     m_graphicsEngine->m_renderCommands->Blit(srcTex, dstTex);
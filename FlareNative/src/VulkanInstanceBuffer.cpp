@@ -0,0 +1,95 @@
+#include "Rendering/Vulkan/VulkanInstanceBuffer.h"
+
+#include "Flare/FlareAssert.h"
+#include "Rendering/Vulkan/VulkanRenderEngineBackend.h"
+#include "Trace.h"
+
+VulkanInstanceBuffer::VulkanInstanceBuffer(VulkanRenderEngineBackend* a_engine)
+{
+    TRACE("Creating Instance Buffers");
+    m_engine = a_engine;
+
+    for (uint32_t i = 0; i < VulkanFlightPoolSize; ++i)
+    {
+        m_used[i] = 0;
+
+        Allocate(i, InitialCapacity);
+    }
+}
+VulkanInstanceBuffer::~VulkanInstanceBuffer()
+{
+    TRACE("Destroying Instance Buffers");
+    for (uint32_t i = 0; i < VulkanFlightPoolSize; ++i)
+    {
+        Free(i);
+    }
+}
+
+void VulkanInstanceBuffer::Allocate(uint32_t a_index, uint32_t a_capacity)
+{
+    const VmaAllocator allocator = m_engine->GetAllocator();
+
+    VkBufferCreateInfo bufferInfo = { };
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.size = (VkDeviceSize)a_capacity * sizeof(ModelShaderBuffer);
+    bufferInfo.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    VmaAllocationCreateInfo bufferAllocInfo = { 0 };
+    bufferAllocInfo.usage = VMA_MEMORY_USAGE_AUTO;
+    // Coherent so there is no need to flush the ranges after writing them
+    bufferAllocInfo.requiredFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+    bufferAllocInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+    VkBuffer tBuffer;
+    VmaAllocationInfo allocInfo = { 0 };
+    FLARE_ASSERT_MSG_R(vmaCreateBuffer(allocator, &bufferInfo, &bufferAllocInfo, &tBuffer, &m_allocations[a_index], &allocInfo) == VK_SUCCESS, "Failed to create Instance Buffer");
+
+    m_buffers[a_index] = tBuffer;
+    m_data[a_index] = (ModelShaderBuffer*)allocInfo.pMappedData;
+    m_capacity[a_index] = a_capacity;
+}
+void VulkanInstanceBuffer::Free(uint32_t a_index)
+{
+    const VmaAllocator allocator = m_engine->GetAllocator();
+
+    vmaDestroyBuffer(allocator, m_buffers[a_index], m_allocations[a_index]);
+    m_engine->DescriptorResourceDestroyed();
+
+    m_buffers[a_index] = nullptr;
+    m_data[a_index] = nullptr;
+    m_capacity[a_index] = 0;
+}
+
+void VulkanInstanceBuffer::Reset(uint32_t a_index, uint32_t a_count)
+{
+    m_used[a_index] = 0;
+
+    if (a_count <= m_capacity[a_index])
+    {
+        return;
+    }
+
+    uint32_t capacity = m_capacity[a_index];
+    while (capacity < a_count)
+    {
+        capacity *= 2;
+    }
+
+    TRACE("Growing Instance Buffer");
+    Free(a_index);
+    Allocate(a_index, capacity);
+}
+
+ModelShaderBuffer* VulkanInstanceBuffer::Push(uint32_t a_index, uint32_t a_count, uint32_t* a_first)
+{
+    const uint32_t first = m_used[a_index].fetch_add(a_count, std::memory_order_relaxed);
+    if (first + a_count > m_capacity[a_index])
+    {
+        return nullptr;
+    }
+
+    *a_first = first;
+
+    return m_data[a_index] + first;
+}
@@ -11,6 +11,19 @@ VulkanModel::VulkanModel(VulkanRenderEngineBackend* a_engine, uint32_t a_vertexC
 
     m_indexCount = a_indexCount;
 
+    TRACE("Calculating Model Bounds");
+    // Every vertex layout so far starts with the position so just take the first 3 floats of each vertex
+    if (a_vertexSize >= sizeof(glm::vec3))
+    {
+        for (uint32_t i = 0; i < a_vertexCount; ++i)
+        {
+            glm::vec3 pos;
+            memcpy(&pos, a_vertices + i * a_vertexSize, sizeof(glm::vec3));
+
+            m_bounds.Encapsulate(pos);
+        }
+    }
+
     const vk::Device device = m_engine->GetLogicalDevice();
     const VmaAllocator allocator = m_engine->GetAllocator();
 
@@ -337,14 +337,14 @@ VulkanShaderData* VulkanPipeline::GetShaderData() const
     
     return (VulkanShaderData*)program.Data;
 }
-void VulkanPipeline::Bind(uint32_t a_index, vk::CommandBuffer a_commandBuffer) const
+void VulkanPipeline::Bind(vk::CommandBuffer a_commandBuffer) const
 {
     const FlareBase::RenderProgram program = m_gEngine->GetRenderProgram(m_programAddr);
 
     const VulkanShaderData* data = (VulkanShaderData*)program.Data;
     FLARE_ASSERT(data != nullptr);
 
-    data->Bind(a_index, a_commandBuffer);
+    data->Bind(a_commandBuffer);
 
     a_commandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, m_pipeline);
 }
\ No newline at end of file
@@ -12,7 +12,7 @@
 #include "Rendering/Vulkan/VulkanRenderTexture.h"
 #include "Rendering/Vulkan/VulkanShaderData.h"
 #include "Rendering/Vulkan/VulkanSwapchain.h"
-#include "Rendering/Vulkan/VulkanUniformBuffer.h"
+#include "Rendering/Vulkan/VulkanUniformRing.h"
 
 VulkanRenderCommand::VulkanRenderCommand(VulkanRenderEngineBackend* a_engine, VulkanGraphicsEngine* a_gEngine, VulkanSwapchain* a_swapchain, vk::CommandBuffer a_buffer, uint32_t a_bufferIndex)
 {
@@ -20,6 +20,7 @@ VulkanRenderCommand::VulkanRenderCommand(VulkanRenderEngineBackend* a_engine, Vu
     m_gEngine = a_gEngine;
     m_swapchain = a_swapchain;
 
+    m_primaryBuffer = a_buffer;
     m_commandBuffer = a_buffer;
 
     m_bufferIndex = a_bufferIndex;
@@ -70,18 +71,170 @@ void VulkanRenderCommand::SetCameraState(bool a_value)
     }
 }
 
+void VulkanRenderCommand::SetStartedState(bool a_value)
+{
+    if (a_value)
+    {
+        m_flags |= 0b1 << StartedBit;
+    }
+    else
+    {
+        m_flags &= ~(0b1 << StartedBit);
+    }
+}
+void VulkanRenderCommand::SetSecondaryState(bool a_value)
+{
+    if (a_value)
+    {
+        m_flags |= 0b1 << SecondaryBit;
+    }
+    else
+    {
+        m_flags &= ~(0b1 << SecondaryBit);
+    }
+}
+void VulkanRenderCommand::SetTailState(bool a_value)
+{
+    if (a_value)
+    {
+        m_flags |= 0b1 << TailBit;
+    }
+    else
+    {
+        m_flags &= ~(0b1 << TailBit);
+    }
+}
+
+void VulkanRenderCommand::StartRenderPass(vk::SubpassContents a_contents)
+{
+    if (m_renderTexAddr == -1)
+    {
+        const glm::ivec2 renderSize = m_swapchain->GetSize();
+
+        constexpr vk::ClearValue ClearColor = vk::ClearValue(vk::ClearColorValue(0.0f, 0.0f, 0.0f, 1.0f));
+
+        m_renderPass = m_swapchain->GetRenderPass();
+        m_framebuffer = m_swapchain->GetFramebuffer(m_engine->GetImageIndex());
+
+        const vk::RenderPassBeginInfo renderPassInfo = vk::RenderPassBeginInfo
+        (
+            m_renderPass,
+            m_framebuffer,
+            vk::Rect2D({ 0, 0 }, { (uint32_t)renderSize.x, (uint32_t)renderSize.y }),
+            1,
+            &ClearColor
+        );
+
+        m_primaryBuffer.beginRenderPass(renderPassInfo, a_contents);
+    }
+    else
+    {
+        VulkanRenderTexture* renderTexture = m_gEngine->GetRenderTexture(m_renderTexAddr);
+
+        m_renderPass = renderTexture->GetRenderPass();
+        m_framebuffer = renderTexture->GetFramebuffer();
+
+        const vk::RenderPassBeginInfo renderPassInfo = vk::RenderPassBeginInfo
+        (
+            m_renderPass,
+            m_framebuffer,
+            vk::Rect2D({ 0, 0 }, { renderTexture->GetWidth(), renderTexture->GetHeight() }),
+            renderTexture->GetTotalTextureCount(),
+            renderTexture->GetClearValues()
+        );
+
+        m_primaryBuffer.beginRenderPass(renderPassInfo, a_contents);
+    }
+
+    SetStartedState(true);
+    SetSecondaryState(a_contents == vk::SubpassContents::eSecondaryCommandBuffers);
+}
+
 void VulkanRenderCommand::Flush()
 {
     if (!IsFlushed())
     {
-        m_commandBuffer.endRenderPass();
+        // Nothing got recorded but still need the pass for the clears
+        if (!IsStarted())
+        {
+            StartRenderPass(vk::SubpassContents::eInline);
+        }
+
+        if (IsTailStarted())
+        {
+            m_commandBuffer.end();
+            m_primaryBuffer.executeCommands(1, &m_commandBuffer);
+
+            m_commandBuffer = m_primaryBuffer;
+        }
+
+        m_primaryBuffer.endRenderPass();
     }
 
     SetFlushedState(true);
+    SetStartedState(false);
+    SetSecondaryState(false);
+    SetTailState(false);
 
     m_renderTexAddr = -1;
 }
 
+vk::CommandBuffer VulkanRenderCommand::GetInlineCommandBuffer()
+{
+    if (IsFlushed() || IsTailStarted())
+    {
+        return m_commandBuffer;
+    }
+
+    if (!IsStarted())
+    {
+        StartRenderPass(vk::SubpassContents::eInline);
+
+        return m_commandBuffer;
+    }
+
+    if (IsSecondary())
+    {
+        const vk::CommandBufferInheritanceInfo inheritance = vk::CommandBufferInheritanceInfo
+        (
+            m_renderPass,
+            0,
+            m_framebuffer
+        );
+
+        m_commandBuffer = m_gEngine->StartSecondaryCommandBuffer(m_engine->GetCurrentFrame(), inheritance);
+        m_commandBuffer.setViewport(0, 1, &m_viewport);
+        m_commandBuffer.setScissor(0, 1, &m_scissor);
+
+        SetTailState(true);
+
+        // Nothing carries over into a secondary so the material needs binding again
+        const uint32_t materialAddr = m_materialAddr;
+        m_materialAddr = -1;
+        BindMaterial(materialAddr);
+    }
+
+    return m_commandBuffer;
+}
+bool VulkanRenderCommand::StartSecondaryPass(vk::CommandBufferInheritanceInfo* a_inheritance)
+{
+    if (IsFlushed() || IsStarted())
+    {
+        return false;
+    }
+
+    StartRenderPass(vk::SubpassContents::eSecondaryCommandBuffers);
+
+    *a_inheritance = vk::CommandBufferInheritanceInfo
+    (
+        m_renderPass,
+        0,
+        m_framebuffer
+    );
+
+    return true;
+}
+
 VulkanRenderTexture* VulkanRenderCommand::GetRenderTexture() const
 {
     return m_gEngine->GetRenderTexture(m_renderTexAddr);
@@ -98,6 +251,8 @@ VulkanPipeline* VulkanRenderCommand::GetPipeline() const
 
 VulkanPipeline* VulkanRenderCommand::BindMaterial(uint32_t a_materialAddr)
 {
+    GetInlineCommandBuffer();
+
     const bool bind = m_materialAddr != a_materialAddr;
 
     m_materialAddr = a_materialAddr;
@@ -113,10 +268,12 @@ VulkanPipeline* VulkanRenderCommand::BindMaterial(uint32_t a_materialAddr)
         const FlareBase::ShaderBufferInput camInput = shaderData->GetCameraInput();
         if (camInput.BufferType == FlareBase::ShaderBufferType_CameraBuffer)
         {
-            shaderData->PushUniformBuffer(m_commandBuffer, camInput.Set, m_gEngine->GetCameraUniformBuffer(m_bufferIndex), m_engine->GetCurrentFrame());
+            const uint32_t index = m_engine->GetCurrentFrame();
+
+            shaderData->PushUniformBuffer(m_commandBuffer, camInput.Set, m_gEngine->GetUniformRing()->GetBuffer(index), m_gEngine->GetCameraUniformOffset(m_bufferIndex), index);
         }
 
-        pipeline->Bind(m_engine->GetCurrentFrame(), m_commandBuffer);
+        pipeline->Bind(m_commandBuffer);
     }
 
     return pipeline;
@@ -124,10 +281,7 @@ VulkanPipeline* VulkanRenderCommand::BindMaterial(uint32_t a_materialAddr)
 
 void VulkanRenderCommand::SetCameraData(uint32_t a_bufferAddr)
 {
-    const RenderEngine* renderEngine = m_engine->GetRenderEngine();
-    ObjectManager* objectManager = renderEngine->GetObjectManager();
-
-    const CameraBuffer buffer = m_gEngine->GetCameraBuffer(a_bufferAddr);
+    const CameraBuffer& buffer = m_gEngine->GetFrameCameraBuffer(a_bufferAddr);
 
     glm::ivec2 size = m_swapchain->GetSize();
 
@@ -142,10 +296,9 @@ void VulkanRenderCommand::SetCameraData(uint32_t a_bufferAddr)
         const glm::vec2 screenPos = buffer.View.Position * (glm::vec2)size;
         const glm::vec2 screenSize = buffer.View.Size * (glm::vec2)size;
 
-        const vk::Rect2D scissor = vk::Rect2D({ (int32_t)screenPos.x, (int32_t)screenPos.y }, { (uint32_t)screenSize.x, (uint32_t)screenSize.y });
-        m_commandBuffer.setScissor(0, 1, &scissor);
-
-        const vk::Viewport viewport = vk::Viewport
+        // Kept about as secondaries do not inherit dynamic state
+        m_scissor = vk::Rect2D({ (int32_t)screenPos.x, (int32_t)screenPos.y }, { (uint32_t)screenSize.x, (uint32_t)screenSize.y });
+        m_viewport = vk::Viewport
         (
             screenPos.x,
             screenPos.y,
@@ -154,22 +307,26 @@ void VulkanRenderCommand::SetCameraData(uint32_t a_bufferAddr)
             buffer.View.MinDepth,
             buffer.View.MaxDepth
         );
-        m_commandBuffer.setViewport(0, 1, &viewport);
+
+        // Does not need the pass started but cannot go straight into a primary that only takes secondaries
+        const vk::CommandBuffer commandBuffer = IsStarted() ? GetInlineCommandBuffer() : m_commandBuffer;
+        commandBuffer.setScissor(0, 1, &m_scissor);
+        commandBuffer.setViewport(0, 1, &m_viewport);
 
         SetViewportState(true);
     }
 
     if (!IsCameraSet())
     {
-        CameraShaderBuffer camShaderData;
-        camShaderData.InvView = objectManager->GetGlobalMatrix(buffer.TransformAddr);
+        CameraShaderBuffer camShaderData = CameraShaderBuffer();
+        camShaderData.InvView = m_gEngine->GetFrameGlobalMatrix(buffer.TransformAddr);
         camShaderData.View = glm::inverse(camShaderData.InvView);
         camShaderData.Proj = buffer.ToProjection(size);
         camShaderData.InvProj = glm::inverse(camShaderData.Proj);
         camShaderData.ViewProj = camShaderData.Proj * camShaderData.View;
 
-        VulkanUniformBuffer* cameraUniformBuffer = m_gEngine->GetCameraUniformBuffer(m_bufferIndex);
-        cameraUniformBuffer->SetData(m_engine->GetCurrentFrame(), &camShaderData);
+        // Skipped by the ring if the camera has not moved since this pass last went out on the frame index
+        m_gEngine->GetUniformRing()->Write(m_engine->GetCurrentFrame(), m_gEngine->GetCameraUniformOffset(m_bufferIndex), &camShaderData, sizeof(CameraShaderBuffer));
 
         SetCameraState(true);
     }
@@ -179,10 +336,12 @@ void VulkanRenderCommand::PushTexture(uint32_t a_slot, const FlareBase::TextureS
 {
     FLARE_ASSERT_MSG_R(m_materialAddr != -1, "PushTexture Material not bound");
 
+    const vk::CommandBuffer commandBuffer = GetInlineCommandBuffer();
+
     const FlareBase::RenderProgram program = m_gEngine->GetRenderProgram(m_materialAddr);
     VulkanShaderData* data = (VulkanShaderData*)program.Data;
 
-    data->PushTexture(m_commandBuffer, a_slot, a_sampler, m_engine->GetCurrentFrame());
+    data->PushTexture(commandBuffer, a_slot, a_sampler, m_engine->GetCurrentFrame());
 }
 
 void VulkanRenderCommand::BindRenderTexture(uint32_t a_renderTexAddr)
@@ -192,40 +351,8 @@ void VulkanRenderCommand::BindRenderTexture(uint32_t a_renderTexAddr)
     SetFlushedState(false);
     SetViewportState(false);
 
+    // Pass does not get started until something goes into it so the draws get a chance to go in as secondaries
     m_renderTexAddr = a_renderTexAddr;
-
-    if (m_renderTexAddr == -1)
-    {
-        const glm::ivec2 renderSize = m_swapchain->GetSize();
-
-        constexpr vk::ClearValue ClearColor = vk::ClearValue(vk::ClearColorValue(0.0f, 0.0f, 0.0f, 1.0f));
-
-        const vk::RenderPassBeginInfo renderPassInfo = vk::RenderPassBeginInfo
-        (
-            m_swapchain->GetRenderPass(),
-            m_swapchain->GetFramebuffer(m_engine->GetImageIndex()),
-            vk::Rect2D({ 0, 0 }, { (uint32_t)renderSize.x, (uint32_t)renderSize.y }),
-            1,
-            &ClearColor
-        );
-
-        m_commandBuffer.beginRenderPass(renderPassInfo, vk::SubpassContents::eInline);
-    }
-    else
-    {
-        VulkanRenderTexture* renderTexture = m_gEngine->GetRenderTexture(m_renderTexAddr);
-
-        const vk::RenderPassBeginInfo renderPassInfo = vk::RenderPassBeginInfo
-        (
-            renderTexture->GetRenderPass(),
-            renderTexture->GetFramebuffer(),
-            vk::Rect2D({ 0, 0 }, { renderTexture->GetWidth(), renderTexture->GetHeight() }),
-            renderTexture->GetTotalTextureCount(),
-            renderTexture->GetClearValues()
-        );
-
-        m_commandBuffer.beginRenderPass(renderPassInfo, vk::SubpassContents::eInline);
-    }
 }
 
 void VulkanRenderCommand::Blit(const VulkanRenderTexture* a_src, const VulkanRenderTexture* a_dst)
@@ -280,9 +407,10 @@ void VulkanRenderCommand::Blit(const VulkanRenderTexture* a_src, const VulkanRen
     // const vk::ImageLayout srcLayout = a_src->GetImageLayout();
     const vk::ImageLayout srcLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
 
+    // Passes before this in the frame can still be writing to either image as there are no semaphores between them
     const vk::ImageMemoryBarrier srcMemoryBarrier = vk::ImageMemoryBarrier
     (
-        vk::AccessFlags(),
+        vk::AccessFlagBits::eColorAttachmentWrite,
         vk::AccessFlagBits::eTransferRead,
         srcLayout,
         vk::ImageLayout::eTransferSrcOptimal,
@@ -293,7 +421,7 @@ void VulkanRenderCommand::Blit(const VulkanRenderTexture* a_src, const VulkanRen
     );
     const vk::ImageMemoryBarrier dstMemoryBarrier = vk::ImageMemoryBarrier
     (
-        vk::AccessFlags(),
+        vk::AccessFlagBits::eColorAttachmentWrite,
         vk::AccessFlagBits::eTransferWrite,
         dstLayout,
         vk::ImageLayout::eTransferDstOptimal,
@@ -303,15 +431,17 @@ void VulkanRenderCommand::Blit(const VulkanRenderTexture* a_src, const VulkanRen
         SubResourceRange
     );
 
-    m_commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eTransfer, vk::DependencyFlags(), 0, nullptr, 0, nullptr, 1, &srcMemoryBarrier);
-    m_commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eTransfer, vk::DependencyFlags(), 0, nullptr, 0, nullptr, 1, &dstMemoryBarrier);
+    constexpr vk::PipelineStageFlags PassStages = vk::PipelineStageFlagBits::eFragmentShader | vk::PipelineStageFlagBits::eColorAttachmentOutput;
+
+    m_commandBuffer.pipelineBarrier(PassStages | vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eTransfer, vk::DependencyFlags(), 0, nullptr, 0, nullptr, 1, &srcMemoryBarrier);
+    m_commandBuffer.pipelineBarrier(PassStages | vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eTransfer, vk::DependencyFlags(), 0, nullptr, 0, nullptr, 1, &dstMemoryBarrier);
 
     m_commandBuffer.blitImage(a_src->GetTexture(0), vk::ImageLayout::eTransferSrcOptimal, dstImage, vk::ImageLayout::eTransferDstOptimal, 1, &blitRegion, vk::Filter::eNearest);
 
     const vk::ImageMemoryBarrier srcFinalMemoryBarrier = vk::ImageMemoryBarrier
     (
         vk::AccessFlagBits::eTransferRead,
-        vk::AccessFlagBits::eMemoryRead,
+        vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eColorAttachmentWrite,
         vk::ImageLayout::eTransferSrcOptimal,
         srcLayout,
         VK_QUEUE_FAMILY_IGNORED,
@@ -322,7 +452,7 @@ void VulkanRenderCommand::Blit(const VulkanRenderTexture* a_src, const VulkanRen
     const vk::ImageMemoryBarrier dstFinalMemoryBarrier = vk::ImageMemoryBarrier
     (
         vk::AccessFlagBits::eTransferWrite,
-        vk::AccessFlagBits::eMemoryRead,
+        vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eColorAttachmentWrite | vk::AccessFlagBits::eMemoryRead,
         vk::ImageLayout::eTransferDstOptimal,
         dstLayout,
         VK_QUEUE_FAMILY_IGNORED,
@@ -331,28 +461,27 @@ void VulkanRenderCommand::Blit(const VulkanRenderTexture* a_src, const VulkanRen
         SubResourceRange
     );
 
-    m_commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eTransfer, vk::DependencyFlags(), 0, nullptr, 0, nullptr, 1, &srcFinalMemoryBarrier);
-    m_commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eTransfer, vk::DependencyFlags(), 0, nullptr, 0, nullptr, 1, &dstFinalMemoryBarrier);
+    m_commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, PassStages | vk::PipelineStageFlagBits::eTransfer, vk::DependencyFlags(), 0, nullptr, 0, nullptr, 1, &srcFinalMemoryBarrier);
+    m_commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, PassStages | vk::PipelineStageFlagBits::eTransfer, vk::DependencyFlags(), 0, nullptr, 0, nullptr, 1, &dstFinalMemoryBarrier);
 }
 
 void VulkanRenderCommand::DrawMaterial()
 {
-    m_commandBuffer.draw(4, 1, 0, 0);
+    GetInlineCommandBuffer().draw(4, 1, 0, 0);
 }
 void VulkanRenderCommand::DrawModel(const glm::mat4& a_transform, uint32_t a_addr)
 {
-    const RenderEngine* renderEngine = m_engine->GetRenderEngine();
-    ObjectManager* objectManager = renderEngine->GetObjectManager();
-
     const VulkanModel* model = m_gEngine->GetModel(a_addr);
 
-    model->Bind(m_commandBuffer);
+    const vk::CommandBuffer commandBuffer = GetInlineCommandBuffer();
+
+    model->Bind(commandBuffer);
 
     const uint32_t indexCount = model->GetIndexCount();
 
     const VulkanPipeline* pipeline = GetPipeline();
     const VulkanShaderData* shaderData = pipeline->GetShaderData();
-    shaderData->UpdateTransformBuffer(m_commandBuffer, a_addr, objectManager);
+    shaderData->UpdateTransformBuffer(commandBuffer, a_transform);
 
-    m_commandBuffer.drawIndexed(indexCount, 1, 0, 0, 0);
+    commandBuffer.drawIndexed(indexCount, 1, 0, 0, 0);
 }
\ No newline at end of file
@@ -32,6 +32,12 @@ const static std::vector<const char*> DeviceExtensions =
     VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME
 };
 
+// Not needed but lets per draw descriptors go straight into the command buffer when there
+const static std::vector<const char*> OptionalDeviceExtensions =
+{
+    VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME
+};
+
 const static std::vector<const char*> StandaloneDeviceExtensions =
 {
     VK_KHR_SWAPCHAIN_EXTENSION_NAME
@@ -259,6 +265,15 @@ VulkanRenderEngineBackend::VulkanRenderEngineBackend(RuntimeManager* a_runtime,
 
     TRACE("Found Vulkan Physical Device");
 
+    const bool pushDescriptorSupported = CheckDeviceExtensionSupport(m_pDevice, OptionalDeviceExtensions);
+    if (pushDescriptorSupported)
+    {
+        for (const char* ext : OptionalDeviceExtensions)
+        {
+            dRequiredExtensions.emplace_back(ext);
+        }
+    }
+
     uint32_t queueFamilyCount = 0;
     m_pDevice.getQueueFamilyProperties(&queueFamilyCount, nullptr);
 
@@ -376,6 +391,7 @@ VulkanRenderEngineBackend::VulkanRenderEngineBackend(RuntimeManager* a_runtime,
     for (uint32_t i = 0; i < VulkanMaxFlightFrames; ++i)
     {
         FLARE_ASSERT_MSG_R(m_lDevice.createSemaphore(&SemaphoreInfo, nullptr, &m_imageAvailable[i]) == vk::Result::eSuccess, "Failed to create image semaphore");
+        FLARE_ASSERT_MSG_R(m_lDevice.createSemaphore(&SemaphoreInfo, nullptr, &m_renderFinished[i]) == vk::Result::eSuccess, "Failed to create render semaphore");
         FLARE_ASSERT_MSG_R(m_lDevice.createFence(&FenceInfo, nullptr, &m_inFlight[i]) == vk::Result::eSuccess, "Failed to create fence");
     }
     
@@ -389,19 +405,27 @@ VulkanRenderEngineBackend::VulkanRenderEngineBackend(RuntimeManager* a_runtime,
 
     FLARE_ASSERT_MSG_R(m_lDevice.createCommandPool(&poolInfo, nullptr, &m_commandPool) == vk::Result::eSuccess, "Failed to create command pool");
 
-    PFN_vkGetPhysicalDeviceProperties2KHR GetPhysicalDeviceProperties2KHRFunc = (PFN_vkGetPhysicalDeviceProperties2KHR)vkGetInstanceProcAddr(m_instance, "vkGetPhysicalDeviceProperties2KHR");
+    if (pushDescriptorSupported)
+    {
+        PFN_vkGetPhysicalDeviceProperties2KHR GetPhysicalDeviceProperties2KHRFunc = (PFN_vkGetPhysicalDeviceProperties2KHR)vkGetInstanceProcAddr(m_instance, "vkGetPhysicalDeviceProperties2KHR");
+
+        VkPhysicalDevicePushDescriptorPropertiesKHR pushProperties = { };
+        pushProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PUSH_DESCRIPTOR_PROPERTIES_KHR;
 
-    VkPhysicalDevicePushDescriptorPropertiesKHR pushProperties = { };
-    pushProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PUSH_DESCRIPTOR_PROPERTIES_KHR;
+        VkPhysicalDeviceProperties2KHR deviceProps2 = { };
+        deviceProps2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2_KHR;
+        deviceProps2.pNext = &pushProperties;
 
-    VkPhysicalDeviceProperties2KHR deviceProps2 = { };
-    deviceProps2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2_KHR;
-	deviceProps2.pNext = &pushProperties;
+        GetPhysicalDeviceProperties2KHRFunc(m_pDevice, &deviceProps2);
+        m_pushDescriptorProperties = pushProperties;
 
-    GetPhysicalDeviceProperties2KHRFunc(m_pDevice, &deviceProps2);
-    m_pushDescriptorProperties = pushProperties;
+        m_cmdPushDescriptorSet = (PFN_vkCmdPushDescriptorSetKHR)vkGetDeviceProcAddr(m_lDevice, "vkCmdPushDescriptorSetKHR");
+
+        TRACE("Using push descriptors");
+    }
 
     m_graphicsEngine = new VulkanGraphicsEngine(a_runtime, this);
+    m_graphicsEngine->SetFrameLatency(GetRenderEngine()->m_config->GetFrameLatency());
 }
 VulkanRenderEngineBackend::~VulkanRenderEngineBackend()
 {
@@ -424,12 +448,8 @@ VulkanRenderEngineBackend::~VulkanRenderEngineBackend()
     for (uint32_t i = 0; i < VulkanMaxFlightFrames; ++i)
     {
         m_lDevice.destroySemaphore(m_imageAvailable[i]);
+        m_lDevice.destroySemaphore(m_renderFinished[i]);
         m_lDevice.destroyFence(m_inFlight[i]);
-
-        for (uint32_t j = 0; j < m_interSemaphore[i].size(); ++j)
-        {
-            m_lDevice.destroySemaphore(m_interSemaphore[i][j]);
-        }
     }
 
     TRACE("Destroy Vulkan Allocator");
@@ -458,6 +478,10 @@ VulkanRenderEngineBackend::~VulkanRenderEngineBackend()
     TRACE("Vulkan cleaned up");
 }
 
+void VulkanRenderEngineBackend::PublishFrame()
+{
+    m_graphicsEngine->PublishFrame();
+}
 void VulkanRenderEngineBackend::Update(double a_delta, double a_time)
 {
     Profiler::StartFrame("Swap Setup");
@@ -482,11 +506,11 @@ void VulkanRenderEngineBackend::Update(double a_delta, double a_time)
 
     Profiler::StartFrame("Render Update");
 
-    const std::vector<vk::CommandBuffer> buffers = m_graphicsEngine->Update(m_currentFrame);
+    const TArenaView<vk::CommandBuffer> buffers = m_graphicsEngine->Update(m_currentFrame);
     
     Profiler::StartFrame("Render Setup");
 
-    const uint32_t buffersSize = (uint32_t)buffers.size();
+    const uint32_t buffersSize = buffers.Size();
     // If there is nothing to render no point doing anything
     if (buffersSize <= 0)
     {
@@ -495,68 +519,36 @@ void VulkanRenderEngineBackend::Update(double a_delta, double a_time)
         return;
     }
 
-    constexpr vk::PipelineStageFlags WaitStages[] = { vk::PipelineStageFlagBits::eColorAttachmentOutput };
-
-    const uint32_t semaphoreCount = (uint32_t)m_interSemaphore[m_currentFlightFrame].size();
-    const uint32_t endBuffer = buffersSize - 1;
-    if (buffersSize > semaphoreCount)
-    {
-        TRACE("Allocating inter semaphores");
-        const uint32_t diff = buffersSize - semaphoreCount;
-
-        constexpr vk::SemaphoreCreateInfo SemaphoreInfo;
-
-        for (uint32_t i = 0; i < diff; ++i)
-        {
-            vk::Semaphore semaphore;
-
-            FLARE_ASSERT_MSG_R(m_lDevice.createSemaphore(&SemaphoreInfo, nullptr, &semaphore) == vk::Result::eSuccess, "Failed to create inter semaphore");
-            m_interSemaphore[m_currentFlightFrame].emplace_back(semaphore);
-        }
-    }
-
     Profiler::StopFrame();
 
     Profiler::StartFrame("Render Submit");
 
-    vk::Semaphore lastSemaphore = nullptr;
+    // Everything goes to the same queue in order so one submit does, the render passes and blits have the barriers between passes
+    // Blits can write to the swapchain image so transfer has to wait for it as well
+    constexpr vk::PipelineStageFlags WaitStages[] = { vk::PipelineStageFlagBits::eColorAttachmentOutput | vk::PipelineStageFlagBits::eTransfer };
+
+    vk::SubmitInfo submitInfo = vk::SubmitInfo
+    (
+        0,
+        nullptr,
+        WaitStages,
+        buffersSize,
+        buffers.Data(),
+        1,
+        &m_renderFinished[m_currentFlightFrame]
+    );
+
     vk::Fence fence = nullptr;
     if (!window->IsHeadless())
     {
-        lastSemaphore = m_imageAvailable[m_currentFlightFrame];
+        submitInfo.waitSemaphoreCount = 1;
+        submitInfo.pWaitSemaphores = &m_imageAvailable[m_currentFlightFrame];
         fence = m_inFlight[m_currentFlightFrame];
     }
 
-    for (uint32_t i = 0; i < buffersSize; ++i)
-    {
-        vk::SubmitInfo submitInfo = vk::SubmitInfo
-        (
-            0,
-            nullptr,
-            WaitStages,
-            1,
-            &buffers[i],
-            1,
-            &m_interSemaphore[m_currentFlightFrame][i]
-        );
-
-        if (lastSemaphore != vk::Semaphore(nullptr))
-        {
-            submitInfo.waitSemaphoreCount = 1;
-            submitInfo.pWaitSemaphores = &lastSemaphore;
-        }
-
-        if (i == endBuffer)
-        {
-            FLARE_ASSERT_MSG_R(m_graphicsQueue.submit(1, &submitInfo, fence) == vk::Result::eSuccess, "Failed to submit command");
-        }
-        else
-        {
-            FLARE_ASSERT_MSG_R(m_graphicsQueue.submit(1, &submitInfo, nullptr) == vk::Result::eSuccess, "Failed to submit command");
-        }
+    FLARE_ASSERT_MSG_R(m_graphicsQueue.submit(1, &submitInfo, fence) == vk::Result::eSuccess, "Failed to submit command");
 
-        lastSemaphore = m_interSemaphore[m_currentFlightFrame][i];
-    }    
+    Profiler::SetCounter("Queue Submits", 1);
 
     Profiler::StopFrame();
 
@@ -564,7 +556,7 @@ void VulkanRenderEngineBackend::Update(double a_delta, double a_time)
 
     Profiler::StartFrame("Swap Present");
 
-    m_swapchain->EndFrame(m_interSemaphore[m_currentFlightFrame][endBuffer], m_inFlight[m_currentFlightFrame], m_imageIndex);
+    m_swapchain->EndFrame(m_renderFinished[m_currentFlightFrame], m_inFlight[m_currentFlightFrame], m_imageIndex);
 
     m_currentFrame = (m_currentFrame + 1) % VulkanFlightPoolSize;
     m_currentFlightFrame = (m_currentFlightFrame + 1) % VulkanMaxFlightFrames;
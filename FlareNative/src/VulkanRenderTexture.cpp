@@ -135,6 +135,7 @@ VulkanRenderTexture::VulkanRenderTexture(VulkanRenderEngineBackend* a_engine, ui
         subpass.pDepthStencilAttachment = &depthAttachmentRef;
     }
 
+    // Everything for a frame goes in one submit so these are what keeps passes in order, not by region as later passes sample anywhere in the texture
     vk::SubpassDependency dependencies[2];
     dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
     dependencies[0].dstSubpass = 0;
@@ -142,17 +143,15 @@ VulkanRenderTexture::VulkanRenderTexture(VulkanRenderEngineBackend* a_engine, ui
     dependencies[0].dstStageMask = vk::PipelineStageFlagBits::eColorAttachmentOutput;
     dependencies[0].srcAccessMask = vk::AccessFlagBits::eShaderRead;
     dependencies[0].dstAccessMask = vk::AccessFlagBits::eColorAttachmentWrite;
-    dependencies[0].dependencyFlags = vk::DependencyFlagBits::eByRegion;
     dependencies[1].srcSubpass = 0;
     dependencies[1].dstSubpass = VK_SUBPASS_EXTERNAL;
     dependencies[1].srcStageMask = vk::PipelineStageFlagBits::eColorAttachmentOutput;
     dependencies[1].dstStageMask = vk::PipelineStageFlagBits::eFragmentShader;
     dependencies[1].srcAccessMask = vk::AccessFlagBits::eColorAttachmentWrite;
     dependencies[1].dstAccessMask = vk::AccessFlagBits::eShaderRead;
-    dependencies[1].dependencyFlags = vk::DependencyFlagBits::eByRegion;
     if (a_depthTexture)
     {
-        dependencies[0].dstStageMask |= vk::PipelineStageFlagBits::eEarlyFragmentTests;
+        dependencies[0].dstStageMask |= vk::PipelineStageFlagBits::eEarlyFragmentTests | vk::PipelineStageFlagBits::eLateFragmentTests;
         dependencies[0].dstAccessMask |= vk::AccessFlagBits::eDepthStencilAttachmentRead | vk::AccessFlagBits::eDepthStencilAttachmentWrite;
         dependencies[1].srcStageMask |= vk::PipelineStageFlagBits::eLateFragmentTests;
         dependencies[1].srcAccessMask |= vk::AccessFlagBits::eDepthStencilAttachmentRead | vk::AccessFlagBits::eDepthStencilAttachmentWrite;
@@ -363,6 +362,8 @@ void VulkanRenderTexture::Destroy()
         device.destroyImageView(m_textureViews[i]);
     }
 
+    m_engine->DescriptorResourceDestroyed();
+
     TRACE("Destroying Framebuffer");
     device.destroyFramebuffer(m_frameBuffer);
 }
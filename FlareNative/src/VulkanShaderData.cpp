@@ -1,14 +1,12 @@
 #include "Rendering/Vulkan/VulkanShaderData.h"
 
 #include "Flare/FlareAssert.h"
-#include "ObjectManager.h"
 #include "Rendering/ShaderBuffers.h"
 #include "Rendering/Vulkan/VulkanGraphicsEngine.h"
 #include "Rendering/Vulkan/VulkanRenderEngineBackend.h"
 #include "Rendering/Vulkan/VulkanRenderTexture.h"
 #include "Rendering/Vulkan/VulkanTexture.h"
 #include "Rendering/Vulkan/VulkanTextureSampler.h"
-#include "Rendering/Vulkan/VulkanUniformBuffer.h"
 #include "Trace.h"
 
 constexpr static vk::ShaderStageFlags GetShaderStage(FlareBase::e_ShaderSlot a_slot) 
@@ -68,10 +66,43 @@ constexpr static vk::DescriptorType GetDescriptorType(FlareBase::e_ShaderBufferT
     {
         return vk::DescriptorType::eCombinedImageSampler;
     }
+    case FlareBase::ShaderBufferType_InstanceBuffer:
+    case FlareBase::ShaderBufferType_PointLightClusterBuffer:
+    case FlareBase::ShaderBufferType_SpotLightClusterBuffer:
+    {
+        return vk::DescriptorType::eStorageBuffer;
+    }
+    // Live in the uniform ring so the set only needs to know the buffer and the draws pick their data with the offset
+    case FlareBase::ShaderBufferType_CameraBuffer:
+    case FlareBase::ShaderBufferType_DirectionalLightBuffer:
+    case FlareBase::ShaderBufferType_PointLightBuffer:
+    case FlareBase::ShaderBufferType_SpotLightBuffer:
+    {
+        return vk::DescriptorType::eUniformBufferDynamic;
+    }
     }
 
     return vk::DescriptorType::eUniformBuffer;
 }
+// Only one set in a layout can be a push descriptor so it goes to whatever gets changed the most
+constexpr static uint32_t GetPushPriority(FlareBase::e_ShaderBufferType a_bufferType)
+{
+    switch (a_bufferType)
+    {
+    case FlareBase::ShaderBufferType_DirectionalLightBuffer:
+    case FlareBase::ShaderBufferType_PointLightBuffer:
+    case FlareBase::ShaderBufferType_SpotLightBuffer:
+    {
+        return 2;
+    }
+    case FlareBase::ShaderBufferType_PushTexture:
+    {
+        return 1;
+    }
+    }
+
+    return 0;
+}
 
 struct Input
 {
@@ -103,6 +134,9 @@ static void GetLayoutInfo(const FlareBase::RenderProgram& a_program, std::vector
         case FlareBase::ShaderBufferType_PointLightBuffer:
         case FlareBase::ShaderBufferType_SpotLightBuffer:
         case FlareBase::ShaderBufferType_PushTexture:
+        case FlareBase::ShaderBufferType_InstanceBuffer:
+        case FlareBase::ShaderBufferType_PointLightClusterBuffer:
+        case FlareBase::ShaderBufferType_SpotLightClusterBuffer:
         {
             Input in;
             in.Slot = i;
@@ -212,6 +246,12 @@ VulkanShaderData::VulkanShaderData(VulkanRenderEngineBackend* a_engine, VulkanGr
 
             break;
         }
+        case FlareBase::ShaderBufferType_InstanceBuffer:
+        {
+            m_instanceBufferInput = program.ShaderBufferInputs[i];
+
+            break;
+        }
         case FlareBase::ShaderBufferType_DirectionalLightBuffer:
         {
             m_directionalLightBufferInput = program.ShaderBufferInputs[i];
@@ -230,6 +270,18 @@ VulkanShaderData::VulkanShaderData(VulkanRenderEngineBackend* a_engine, VulkanGr
 
             break;
         }
+        case FlareBase::ShaderBufferType_PointLightClusterBuffer:
+        {
+            m_pointLightClusterInput = program.ShaderBufferInputs[i];
+
+            break;
+        }
+        case FlareBase::ShaderBufferType_SpotLightClusterBuffer:
+        {
+            m_spotLightClusterInput = program.ShaderBufferInputs[i];
+
+            break;
+        }
         }
     }
 
@@ -298,43 +350,87 @@ VulkanShaderData::VulkanShaderData(VulkanRenderEngineBackend* a_engine, VulkanGr
         layouts.emplace_back(m_staticDesciptorLayout);
     }
 
+    for (uint32_t i = 0; i < VulkanFlightPoolSize; ++i)
+    {
+        m_descriptorCaches[i].Frame = -1;
+        m_descriptorCaches[i].ResourceGeneration = m_engine->GetDescriptorResourceGeneration();
+        m_descriptorCaches[i].PoolIndex = 0;
+        m_descriptorCaches[i].PoolSets = 0;
+    }
+
     if (!pushBindings.empty())
     {
         TRACE("Creating Pipeline Push Descriptor Layout");
         const uint32_t bindingCount = (uint32_t)pushBindings.size();
 
+        uint32_t pushedBinding = -1;
+        if (m_engine->IsPushDescriptorSupported())
+        {
+            pushedBinding = 0;
+            for (uint32_t i = 1; i < bindingCount; ++i)
+            {
+                if (GetPushPriority(program.ShaderBufferInputs[pushBindings[i].Slot].BufferType) > GetPushPriority(program.ShaderBufferInputs[pushBindings[pushedBinding].Slot].BufferType))
+                {
+                    pushedBinding = i;
+                }
+            }
+        }
+
         for (uint32_t i = 0; i < bindingCount; ++i)
         {
-            const Input binding = pushBindings[i];
+            vk::DescriptorSetLayoutBinding layoutBinding = pushBindings[i].Binding;
+            vk::DescriptorSetLayoutCreateFlags layoutFlags;
+            if (i == pushedBinding)
+            {
+                layoutFlags = vk::DescriptorSetLayoutCreateFlagBits::ePushDescriptorKHR;
+                // Push descriptors cannot be dynamic so the offset goes in the write instead
+                if (layoutBinding.descriptorType == vk::DescriptorType::eUniformBufferDynamic)
+                {
+                    layoutBinding.descriptorType = vk::DescriptorType::eUniformBuffer;
+                }
+            }
+
             const vk::DescriptorSetLayoutCreateInfo descriptorLayoutInfo = vk::DescriptorSetLayoutCreateInfo
             (
-                { },
+                layoutFlags,
                 1,
-                &binding.Binding
+                &layoutBinding
             );
 
             vk::DescriptorSetLayout layout;
             FLARE_ASSERT_MSG_R(device.createDescriptorSetLayout(&descriptorLayoutInfo, nullptr, &layout) == vk::Result::eSuccess, "Failed to create Push Descriptor Layout");
             layouts.emplace_back(layout);
 
-            const vk::DescriptorPoolSize poolSize = vk::DescriptorPoolSize(binding.Binding.descriptorType, 1);
-            const vk::DescriptorPoolCreateInfo poolInfo = vk::DescriptorPoolCreateInfo
-            (
-                { },
-                PushCount,
-                1,
-                &poolSize
-            );
+            const FlareBase::ShaderBufferInput& input = program.ShaderBufferInputs[pushBindings[i].Slot];
 
-            for (uint32_t j = 0; j < VulkanFlightPoolSize; ++j)
-            {
-                PushDescriptor d;
-                d.Set = program.ShaderBufferInputs[binding.Slot].Set;
-                d.Binding = program.ShaderBufferInputs[binding.Slot].Slot;
-                d.DescriptorLayout = layout;
-                FLARE_ASSERT_MSG_R(device.createDescriptorPool(&poolInfo, nullptr, &d.DescriptorPool) == vk::Result::eSuccess, "Failed to create Push Descriptor Pool");
+            PushDescriptor d;
+            d.Set = input.Set;
+            d.Binding = input.Slot;
+            d.Size = GetBufferSize(input.BufferType);
+            d.Type = layoutBinding.descriptorType;
+            d.Pushed = i == pushedBinding;
+            d.DescriptorLayout = layout;
 
-                m_pushDescriptors[j].emplace_back(d);
+            m_pushDescriptors.emplace_back(d);
+
+            if (!d.Pushed)
+            {
+                // Any one pool could end up all one type so each type gets room for the whole pool
+                bool found = false;
+                for (const vk::DescriptorPoolSize& size : m_cachePoolSizes)
+                {
+                    if (size.type == d.Type)
+                    {
+                        found = true;
+
+                        break;
+                    }
+                }
+
+                if (!found)
+                {
+                    m_cachePoolSizes.emplace_back(vk::DescriptorPoolSize(d.Type, CachePoolSize));
+                }
             }
         }
     }
@@ -362,14 +458,16 @@ VulkanShaderData::~VulkanShaderData()
         device.destroyDescriptorPool(m_staticDescriptorPool);
     }
 
-    const uint32_t pDescriptorCount = (uint32_t)m_pushDescriptors[0].size();
-    for (uint32_t i = 0; i < pDescriptorCount; ++i)
+    for (const PushDescriptor& d : m_pushDescriptors)
     {
-        device.destroyDescriptorSetLayout(m_pushDescriptors[0][i].DescriptorLayout);
+        device.destroyDescriptorSetLayout(d.DescriptorLayout);
+    }
 
-        for (uint32_t j = 0; j < VulkanFlightPoolSize; ++j)
+    for (uint32_t i = 0; i < VulkanFlightPoolSize; ++i)
+    {
+        for (const vk::DescriptorPool pool : m_descriptorCaches[i].Pools)
         {
-            device.destroyDescriptorPool(m_pushDescriptors[j][i].DescriptorPool);
+            device.destroyDescriptorPool(pool);
         }
     }
 
@@ -399,116 +497,235 @@ void VulkanShaderData::SetTexture(uint32_t a_slot, const FlareBase::TextureSampl
     device.updateDescriptorSets(1, &descriptorWrite, 0, nullptr);
 }
 
-void VulkanShaderData::PushTexture(vk::CommandBuffer a_commandBuffer, uint32_t a_slot, const FlareBase::TextureSampler& a_sampler, uint32_t a_index) const
-{   
+const VulkanShaderData::PushDescriptor* VulkanShaderData::GetPushDescriptor(uint32_t a_slot) const
+{
+    for (const PushDescriptor& d : m_pushDescriptors)
+    {
+        if (d.Set == a_slot)
+        {
+            return &d;
+        }
+    }
+
+    return nullptr;
+}
+
+vk::DescriptorSet VulkanShaderData::GetCachedSet(const DescriptorKey& a_key, vk::WriteDescriptorSet a_write, vk::DescriptorSetLayout a_layout, uint32_t a_index) const
+{
     const vk::Device device = m_engine->GetLogicalDevice();
 
-    const VulkanTextureSampler* vSampler = (VulkanTextureSampler*)a_sampler.Data;
-    FLARE_ASSERT(vSampler != nullptr);
+    DescriptorCache& cache = m_descriptorCaches[a_index];
+
+    const std::unique_lock g = std::unique_lock(cache.Lock);
 
-    for (const PushDescriptor& d : m_pushDescriptors[a_index])
+    const uint64_t frame = m_gEngine->GetFrameNumber();
+    if (cache.Frame != frame)
     {
-        if (d.Set == a_slot)
+        // Last time this frame index was used has finished on the GPU so everything can go
+        for (const vk::DescriptorPool pool : cache.Pools)
         {
-            const vk::DescriptorSetAllocateInfo descriptorSetInfo = vk::DescriptorSetAllocateInfo
-            (
-                d.DescriptorPool,
-                1,
-                &d.DescriptorLayout
-            );
+            device.resetDescriptorPool(pool);
+        }
 
-            vk::DescriptorSet descriptorSet;
-            FLARE_ASSERT_R(device.allocateDescriptorSets(&descriptorSetInfo, &descriptorSet) == vk::Result::eSuccess);
+        cache.Sets.clear();
+        cache.PoolIndex = 0;
+        cache.PoolSets = 0;
+        cache.Frame = frame;
+    }
 
-            const vk::DescriptorImageInfo imageInfo = GetDescriptorImageInfo(a_sampler, vSampler, m_gEngine);
-            
-            const vk::WriteDescriptorSet descriptorWrite = vk::WriteDescriptorSet
-            (
-                descriptorSet,
-                d.Binding,
-                0,
-                1,
-                vk::DescriptorType::eCombinedImageSampler,
-                &imageInfo
-            );
+    // Whatever got created since can have the same handle as something destroyed so nothing in there can be trusted
+    // Only the lookup goes as sets already bound this frame still need to be there until it comes round again
+    const uint64_t generation = m_engine->GetDescriptorResourceGeneration();
+    if (cache.ResourceGeneration != generation)
+    {
+        cache.Sets.clear();
+        cache.ResourceGeneration = generation;
+    }
+
+    const auto iter = cache.Sets.find(a_key);
+    if (iter != cache.Sets.end())
+    {
+        return iter->second;
+    }
 
-            device.updateDescriptorSets(1, &descriptorWrite, 0, nullptr);
-            
-            a_commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, m_layout, d.Set, 1, &descriptorSet, 0, nullptr);
+    if (cache.PoolSets >= CachePoolSize)
+    {
+        ++cache.PoolIndex;
+        cache.PoolSets = 0;
+    }
 
-            return;
-        }
+    if (cache.PoolIndex >= cache.Pools.size())
+    {
+        TRACE("Allocating descriptor cache pool");
+        const vk::DescriptorPoolCreateInfo poolInfo = vk::DescriptorPoolCreateInfo
+        (
+            { },
+            CachePoolSize,
+            (uint32_t)m_cachePoolSizes.size(),
+            m_cachePoolSizes.data()
+        );
+
+        vk::DescriptorPool pool;
+        FLARE_ASSERT_MSG_R(device.createDescriptorPool(&poolInfo, nullptr, &pool) == vk::Result::eSuccess, "Failed to create Descriptor Cache Pool");
+
+        cache.Pools.emplace_back(pool);
     }
 
-    FLARE_ASSERT_MSG(0, "PushTexture binding not found");
+    const vk::DescriptorSetAllocateInfo descriptorSetInfo = vk::DescriptorSetAllocateInfo
+    (
+        cache.Pools[cache.PoolIndex],
+        1,
+        &a_layout
+    );
+
+    vk::DescriptorSet descriptorSet;
+    FLARE_ASSERT_R(device.allocateDescriptorSets(&descriptorSetInfo, &descriptorSet) == vk::Result::eSuccess);
+    ++cache.PoolSets;
+
+    a_write.dstSet = descriptorSet;
+    device.updateDescriptorSets(1, &a_write, 0, nullptr);
+
+    cache.Sets.emplace(a_key, descriptorSet);
+
+    return descriptorSet;
 }
-void VulkanShaderData::PushUniformBuffer(vk::CommandBuffer a_commandBuffer, uint32_t a_slot, VulkanUniformBuffer* a_buffer, uint32_t a_index) const
+
+void VulkanShaderData::PushWrite(vk::CommandBuffer a_commandBuffer, const PushDescriptor& a_descriptor, const vk::WriteDescriptorSet& a_write, uint64_t a_resource, uint64_t a_sampler, const uint32_t* a_dynamicOffset, uint32_t a_index) const
 {
-    const vk::Device device = m_engine->GetLogicalDevice();
+    if (a_descriptor.Pushed)
+    {
+        m_engine->PushDescriptorSet(a_commandBuffer, m_layout, a_descriptor.Set, a_write);
+
+        return;
+    }
+
+    DescriptorKey key;
+    key.Set = a_descriptor.Set;
+    key.Resource = a_resource;
+    key.Sampler = a_sampler;
+
+    const vk::DescriptorSet descriptorSet = GetCachedSet(key, a_write, a_descriptor.DescriptorLayout, a_index);
+
+    a_commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, m_layout, a_descriptor.Set, 1, &descriptorSet, a_dynamicOffset != nullptr ? 1 : 0, a_dynamicOffset);
+}
 
-    for (const PushDescriptor& d : m_pushDescriptors[a_index])
+void VulkanShaderData::PushTexture(vk::CommandBuffer a_commandBuffer, uint32_t a_slot, const FlareBase::TextureSampler& a_sampler, uint32_t a_index) const
+{   
+    const VulkanTextureSampler* vSampler = (VulkanTextureSampler*)a_sampler.Data;
+    FLARE_ASSERT(vSampler != nullptr);
+
+    const PushDescriptor* d = GetPushDescriptor(a_slot);
+    if (d == nullptr)
     {
-        if (d.Set == a_slot)
-        {
-            const vk::DescriptorSetAllocateInfo descriptorSetInfo = vk::DescriptorSetAllocateInfo
-            (
-                d.DescriptorPool,
-                1,
-                &d.DescriptorLayout
-            );
+        FLARE_ASSERT_MSG(0, "PushTexture binding not found");
 
-            vk::DescriptorSet descriptorSet;
-            FLARE_ASSERT_R(device.allocateDescriptorSets(&descriptorSetInfo, &descriptorSet) == vk::Result::eSuccess);
+        return;
+    }
 
-            const vk::DescriptorBufferInfo bufferInfo = vk::DescriptorBufferInfo
-            (
-                a_buffer->GetBuffer(a_index), 
-                0, 
-                VK_WHOLE_SIZE
-            );
+    const vk::DescriptorImageInfo imageInfo = GetDescriptorImageInfo(a_sampler, vSampler, m_gEngine);
 
-            const vk::WriteDescriptorSet descriptorWrite = vk::WriteDescriptorSet
-            (
-                descriptorSet,
-                d.Binding,
-                0,
-                1,
-                vk::DescriptorType::eUniformBuffer,
-                nullptr,
-                &bufferInfo
-            );
+    const vk::WriteDescriptorSet descriptorWrite = vk::WriteDescriptorSet
+    (
+        nullptr,
+        d->Binding,
+        0,
+        1,
+        vk::DescriptorType::eCombinedImageSampler,
+        &imageInfo
+    );
 
-            device.updateDescriptorSets(1, &descriptorWrite, 0, nullptr);
+    PushWrite(a_commandBuffer, *d, descriptorWrite, (uint64_t)(VkImageView)imageInfo.imageView, (uint64_t)(VkSampler)imageInfo.sampler, nullptr, a_index);
+}
+void VulkanShaderData::PushUniformBuffer(vk::CommandBuffer a_commandBuffer, uint32_t a_slot, vk::Buffer a_buffer, uint32_t a_offset, uint32_t a_index) const
+{
+    const PushDescriptor* d = GetPushDescriptor(a_slot);
+    if (d == nullptr)
+    {
+        FLARE_ASSERT_MSG(0, "PushUniformBuffer binding not found");
 
-            a_commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, m_layout, d.Set, 1, &descriptorSet, 0, nullptr);
+        return;
+    }
 
-            return;
-        }
+    // Dynamic ones take the offset when binding so the set can be shared by everything in the buffer
+    const bool dynamic = d->Type == vk::DescriptorType::eUniformBufferDynamic;
+
+    const vk::DescriptorBufferInfo bufferInfo = vk::DescriptorBufferInfo
+    (
+        a_buffer,
+        dynamic ? 0 : (vk::DeviceSize)a_offset,
+        (vk::DeviceSize)d->Size
+    );
+
+    const vk::WriteDescriptorSet descriptorWrite = vk::WriteDescriptorSet
+    (
+        nullptr,
+        d->Binding,
+        0,
+        1,
+        d->Type,
+        nullptr,
+        &bufferInfo
+    );
+
+    PushWrite(a_commandBuffer, *d, descriptorWrite, (uint64_t)(VkBuffer)a_buffer, 0, dynamic ? &a_offset : nullptr, a_index);
+}
+void VulkanShaderData::PushStorageBuffer(vk::CommandBuffer a_commandBuffer, uint32_t a_slot, vk::Buffer a_buffer, uint32_t a_index) const
+{
+    const PushDescriptor* d = GetPushDescriptor(a_slot);
+    if (d == nullptr)
+    {
+        FLARE_ASSERT_MSG(0, "PushStorageBuffer binding not found");
+
+        return;
     }
 
-    FLARE_ASSERT_MSG(0, "PushUniformBuffer binding not found");
+    const vk::DescriptorBufferInfo bufferInfo = vk::DescriptorBufferInfo
+    (
+        a_buffer,
+        0,
+        VK_WHOLE_SIZE
+    );
+
+    const vk::WriteDescriptorSet descriptorWrite = vk::WriteDescriptorSet
+    (
+        nullptr,
+        d->Binding,
+        0,
+        1,
+        vk::DescriptorType::eStorageBuffer,
+        nullptr,
+        &bufferInfo
+    );
+
+    PushWrite(a_commandBuffer, *d, descriptorWrite, (uint64_t)(VkBuffer)a_buffer, 0, nullptr, a_index);
+}
+void VulkanShaderData::PushInstanceBuffer(vk::CommandBuffer a_commandBuffer, vk::Buffer a_buffer, uint32_t a_index) const
+{
+    // Whole buffer as the draws pick their range with the first instance
+    PushStorageBuffer(a_commandBuffer, m_instanceBufferInput.Set, a_buffer, a_index);
 }
 
-void VulkanShaderData::UpdateTransformBuffer(vk::CommandBuffer a_commandBuffer, uint32_t a_transformAddr, ObjectManager* a_objectManager) const
+void VulkanShaderData::UpdateTransformBuffer(vk::CommandBuffer a_commandBuffer, const glm::mat4& a_transform) const
+{
+    if (m_transformBufferInput.ShaderSlot != FlareBase::ShaderSlot_Null)
+    {
+        UpdateTransformBuffer(a_commandBuffer, a_transform, glm::inverse(a_transform));
+    }
+}
+void VulkanShaderData::UpdateTransformBuffer(vk::CommandBuffer a_commandBuffer, const glm::mat4& a_transform, const glm::mat4& a_invTransform) const
 {
     if (m_transformBufferInput.ShaderSlot != FlareBase::ShaderSlot_Null)
     {
         ModelShaderBuffer buffer;
-        buffer.Model = a_objectManager->GetGlobalMatrix(a_transformAddr);
-        buffer.InvModel = glm::inverse(buffer.Model);
+        buffer.Model = a_transform;
+        buffer.InvModel = a_invTransform;
 
         a_commandBuffer.pushConstants(m_layout, GetShaderStage(m_transformBufferInput.ShaderSlot), 0, sizeof(ModelShaderBuffer), &buffer);
     }
 }
 
-void VulkanShaderData::Bind(uint32_t a_index, vk::CommandBuffer a_commandBuffer) const
+void VulkanShaderData::Bind(vk::CommandBuffer a_commandBuffer) const
 {
-    const vk::Device device = m_engine->GetLogicalDevice();
-    for (const PushDescriptor& d : m_pushDescriptors[a_index])
-    {
-        device.resetDescriptorPool(d.DescriptorPool);
-    }
-
     if (m_staticDescriptorSet != vk::DescriptorSet(nullptr))
     {
         a_commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, m_layout, StaticIndex, 1, &m_staticDescriptorSet, 0, nullptr);
@@ -0,0 +1,77 @@
+#include "Rendering/Vulkan/VulkanStorageBuffer.h"
+
+#include "Flare/FlareAssert.h"
+#include "Rendering/Vulkan/VulkanRenderEngineBackend.h"
+#include "Trace.h"
+
+VulkanStorageBuffer::VulkanStorageBuffer(VulkanRenderEngineBackend* a_engine, uint32_t a_size)
+{
+    TRACE("Creating Storage Buffers");
+    m_engine = a_engine;
+
+    for (uint32_t i = 0; i < VulkanFlightPoolSize; ++i)
+    {
+        Allocate(i, a_size);
+    }
+}
+VulkanStorageBuffer::~VulkanStorageBuffer()
+{
+    TRACE("Destroying Storage Buffers");
+    for (uint32_t i = 0; i < VulkanFlightPoolSize; ++i)
+    {
+        Free(i);
+    }
+}
+
+void VulkanStorageBuffer::Allocate(uint32_t a_index, uint32_t a_size)
+{
+    const VmaAllocator allocator = m_engine->GetAllocator();
+
+    VkBufferCreateInfo bufferInfo = { };
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.size = (VkDeviceSize)a_size;
+    bufferInfo.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    VmaAllocationCreateInfo bufferAllocInfo = { 0 };
+    bufferAllocInfo.usage = VMA_MEMORY_USAGE_AUTO;
+    bufferAllocInfo.requiredFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+    bufferAllocInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+    VkBuffer tBuffer;
+    VmaAllocationInfo allocInfo = { 0 };
+    FLARE_ASSERT_MSG_R(vmaCreateBuffer(allocator, &bufferInfo, &bufferAllocInfo, &tBuffer, &m_allocations[a_index], &allocInfo) == VK_SUCCESS, "Failed to create Storage Buffer");
+
+    m_buffers[a_index] = tBuffer;
+    m_data[a_index] = allocInfo.pMappedData;
+    m_size[a_index] = a_size;
+}
+void VulkanStorageBuffer::Free(uint32_t a_index)
+{
+    const VmaAllocator allocator = m_engine->GetAllocator();
+
+    vmaDestroyBuffer(allocator, m_buffers[a_index], m_allocations[a_index]);
+    m_engine->DescriptorResourceDestroyed();
+
+    m_buffers[a_index] = nullptr;
+    m_data[a_index] = nullptr;
+    m_size[a_index] = 0;
+}
+
+void VulkanStorageBuffer::Reserve(uint32_t a_index, uint32_t a_size)
+{
+    if (a_size <= m_size[a_index])
+    {
+        return;
+    }
+
+    uint32_t size = m_size[a_index] > 0 ? m_size[a_index] : a_size;
+    while (size < a_size)
+    {
+        size *= 2;
+    }
+
+    TRACE("Growing Storage Buffer");
+    Free(a_index);
+    Allocate(a_index, size);
+}
\ No newline at end of file
@@ -125,4 +125,6 @@ VulkanTexture::~VulkanTexture()
 
     device.destroyImageView(m_view);
     vmaDestroyImage(allocator, m_image, m_allocation);
+
+    m_engine->DescriptorResourceDestroyed();
 }
\ No newline at end of file
@@ -0,0 +1,126 @@
+#include "Rendering/Vulkan/VulkanUniformRing.h"
+
+#include <cstring>
+
+#include "Flare/FlareAssert.h"
+#include "Rendering/Vulkan/VulkanRenderEngineBackend.h"
+#include "Trace.h"
+
+VulkanUniformRing::VulkanUniformRing(VulkanRenderEngineBackend* a_engine)
+{
+    TRACE("Creating Uniform Ring");
+    m_engine = a_engine;
+
+    const vk::PhysicalDeviceProperties properties = m_engine->GetPhysicalDevice().getProperties();
+    // Always a power of 2 so the mask in GetAlignedSize works
+    m_alignment = (uint32_t)properties.limits.minUniformBufferOffsetAlignment;
+
+    m_writeCount = 0;
+
+    for (uint32_t i = 0; i < VulkanFlightPoolSize; ++i)
+    {
+        m_used[i] = 0;
+
+        Allocate(i, InitialCapacity);
+    }
+}
+VulkanUniformRing::~VulkanUniformRing()
+{
+    TRACE("Destroying Uniform Ring");
+    for (uint32_t i = 0; i < VulkanFlightPoolSize; ++i)
+    {
+        Free(i);
+    }
+}
+
+void VulkanUniformRing::Allocate(uint32_t a_index, uint32_t a_capacity)
+{
+    const VmaAllocator allocator = m_engine->GetAllocator();
+
+    VkBufferCreateInfo bufferInfo = { };
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.size = (VkDeviceSize)a_capacity;
+    bufferInfo.usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    VmaAllocationCreateInfo bufferAllocInfo = { 0 };
+    bufferAllocInfo.usage = VMA_MEMORY_USAGE_AUTO;
+    // Coherent so there is no need to flush the ranges after writing them
+    bufferAllocInfo.requiredFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+    bufferAllocInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+    VkBuffer tBuffer;
+    VmaAllocationInfo allocInfo = { 0 };
+    FLARE_ASSERT_MSG_R(vmaCreateBuffer(allocator, &bufferInfo, &bufferAllocInfo, &tBuffer, &m_allocations[a_index], &allocInfo) == VK_SUCCESS, "Failed to create Uniform Ring");
+
+    m_buffers[a_index] = tBuffer;
+    m_data[a_index] = (unsigned char*)allocInfo.pMappedData;
+    m_capacity[a_index] = a_capacity;
+
+    // Carries over whatever was there before so the copy still matches the buffer
+    m_shadow[a_index].resize(a_capacity, 0);
+    memcpy(m_data[a_index], m_shadow[a_index].data(), a_capacity);
+}
+void VulkanUniformRing::Free(uint32_t a_index)
+{
+    const VmaAllocator allocator = m_engine->GetAllocator();
+
+    vmaDestroyBuffer(allocator, m_buffers[a_index], m_allocations[a_index]);
+    m_engine->DescriptorResourceDestroyed();
+
+    m_buffers[a_index] = nullptr;
+    m_data[a_index] = nullptr;
+    m_capacity[a_index] = 0;
+}
+
+void VulkanUniformRing::Reset(uint32_t a_index, uint32_t a_size)
+{
+    m_used[a_index] = 0;
+    m_writeCount = 0;
+
+    if (a_size <= m_capacity[a_index])
+    {
+        return;
+    }
+
+    uint32_t capacity = m_capacity[a_index];
+    while (capacity < a_size)
+    {
+        capacity *= 2;
+    }
+
+    TRACE("Growing Uniform Ring");
+    Free(a_index);
+    Allocate(a_index, capacity);
+}
+
+uint32_t VulkanUniformRing::Push(uint32_t a_index, uint32_t a_size)
+{
+    const uint32_t size = GetAlignedSize(a_size);
+
+    // Everything handed out is a multiple of the alignment so the start always lines up
+    const uint32_t offset = m_used[a_index].fetch_add(size, std::memory_order_relaxed);
+    if (offset + size > m_capacity[a_index])
+    {
+        return -1;
+    }
+
+    return offset;
+}
+bool VulkanUniformRing::Write(uint32_t a_index, uint32_t a_offset, const void* a_data, uint32_t a_size)
+{
+    FLARE_ASSERT(a_offset + a_size <= m_capacity[a_index]);
+
+    unsigned char* shadow = m_shadow[a_index].data() + a_offset;
+    if (memcmp(shadow, a_data, a_size) == 0)
+    {
+        return false;
+    }
+
+    memcpy(shadow, a_data, a_size);
+    memcpy(m_data[a_index] + a_offset, a_data, a_size);
+
+    ++m_writeCount;
+
+    return true;
+}
\ No newline at end of file